@@ -0,0 +1,94 @@
+# 资源审计：列出 res.qrc 中没有被 .cpp/.h/.ui/.qss 引用的文件，以及代码中引用了但 res.qrc 里没有的资源。
+# 用法: cmake --build <构建目录> --target resource_audit
+#       或 cmake -DSOURCE_DIR=<源码目录> -P cmake/resourceaudit.cmake
+# 加 -DSTRICT=ON 时发现问题返回失败，可用于持续集成
+
+cmake_minimum_required(VERSION 3.16)
+
+if(NOT SOURCE_DIR)
+    get_filename_component(SOURCE_DIR "${CMAKE_CURRENT_LIST_DIR}/.." ABSOLUTE)
+endif()
+
+file(READ "${SOURCE_DIR}/res.qrc" qrc)
+
+# 资源路径：有 alias 时为 prefix + alias，否则为 prefix + 文件路径
+set(resources "")
+string(REGEX MATCHALL "<qresource[^>]*>.*</qresource>" sections "${qrc}")
+foreach(section IN LISTS sections)
+    set(prefix "/")
+    if(section MATCHES "prefix=\"([^\"]*)\"")
+        set(prefix "${CMAKE_MATCH_1}")
+    endif()
+    if(NOT prefix MATCHES "/$")
+        set(prefix "${prefix}/")
+    endif()
+
+    string(REGEX MATCHALL "<file[^>]*>[^<]*</file>" entries "${section}")
+    foreach(entry IN LISTS entries)
+        string(REGEX REPLACE "<file[^>]*>([^<]*)</file>" "\\1" path "${entry}")
+        if(entry MATCHES "alias=\"([^\"]*)\"")
+            set(path "${CMAKE_MATCH_1}")
+        endif()
+        list(APPEND resources ":${prefix}${path}")
+    endforeach()
+endforeach()
+
+# 代码和样式表中出现的 ":/..." 路径
+file(GLOB sources
+    "${SOURCE_DIR}/*.cpp" "${SOURCE_DIR}/*.h" "${SOURCE_DIR}/*.ui" "${SOURCE_DIR}/style/*.qss")
+set(references "")
+foreach(source IN LISTS sources)
+    file(STRINGS "${source}" lines REGEX ":/" ENCODING UTF-8)
+    foreach(line IN LISTS lines)
+        # 按引号、括号、尖括号和空白切开，再挑出以 ":/" 开头的片段；
+        # 不直接用正则匹配路径，因为路径中可能有中文
+        string(REGEX REPLACE "[\"'()<>\t ;]+" ";" tokens "${line}")
+        foreach(token IN LISTS tokens)
+            if(token MATCHES "^:/[^/]")
+                list(APPEND references "${token}")
+            endif()
+        endforeach()
+    endforeach()
+endforeach()
+list(REMOVE_DUPLICATES references)
+
+# 以 / 结尾的是目录前缀（如 StyleSheets 拼接的 :/style/），按前缀匹配
+set(unused "")
+foreach(resource IN LISTS resources)
+    set(found FALSE)
+    foreach(reference IN LISTS references)
+        if(resource STREQUAL reference)
+            set(found TRUE)
+        elseif(reference MATCHES "/$")
+            string(FIND "${resource}" "${reference}" position)
+            if(position EQUAL 0)
+                set(found TRUE)
+            endif()
+        endif()
+    endforeach()
+    if(NOT found)
+        list(APPEND unused "${resource}")
+    endif()
+endforeach()
+
+set(missing "")
+foreach(reference IN LISTS references)
+    if(NOT reference MATCHES "/$" AND NOT reference IN_LIST resources)
+        list(APPEND missing "${reference}")
+    endif()
+endforeach()
+
+list(LENGTH resources resourceCount)
+list(LENGTH unused unusedCount)
+list(LENGTH missing missingCount)
+message(STATUS "res.qrc 共 ${resourceCount} 个文件，未被引用 ${unusedCount} 个，缺失 ${missingCount} 个")
+foreach(resource IN LISTS unused)
+    message(STATUS "  未引用: ${resource}")
+endforeach()
+foreach(reference IN LISTS missing)
+    message(STATUS "  缺失:   ${reference}")
+endforeach()
+
+if(STRICT AND (unusedCount OR missingCount))
+    message(FATAL_ERROR "资源审计未通过")
+endif()
@@ -0,0 +1,166 @@
+#include "databasebackup.h"
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QRegularExpression>
+#include <QSqlDatabase>
+#include <QSqlError>
+#include <QSqlQuery>
+#include <QThread>
+#include <QTimer>
+
+namespace {
+const char *const snapshotPattern = "sms_*.db";
+
+QString snapshotName()
+{
+    return QString("sms_%1.db").arg(QDateTime::currentDateTime().toString("yyyyMMdd_HHmmss"));
+}
+}
+
+DatabaseBackup::DatabaseBackup(QObject *parent)
+    : QObject(parent)
+    , progressTimer(new QTimer(this))
+{
+    progressTimer->setInterval(200);
+    connect(progressTimer, &QTimer::timeout, this, &DatabaseBackup::reportProgress);
+}
+
+// 备份线程结束前对象不能销毁，否则线程中的回调会访问已释放的对象。
+// VACUUM INTO 中途无法停止，关闭主窗口时先询问用户，见 MainWindow::closeEvent()
+DatabaseBackup::~DatabaseBackup()
+{
+    if (thread) {
+        thread->wait();
+        delete thread;
+    }
+}
+
+// 每次使用单独命名的连接，不与界面线程和其他后台线程的连接共用
+bool DatabaseBackup::backupTo(const QString& sourcePath, const QString& targetFile, QString& error)
+{
+    const QString name = QString("sms_backup_%1").arg(quintptr(QThread::currentThreadId()));
+    bool ok = false;
+
+    {
+        QSqlDatabase database = QSqlDatabase::addDatabase("QSQLITE", name);
+        database.setDatabaseName(sourcePath);
+        database.setConnectOptions("QSQLITE_OPEN_READONLY");
+
+        if (!database.open()) {
+            error = "无法打开数据库: " + database.lastError().text();
+        }
+        else {
+            QSqlQuery query(database);
+            query.prepare("VACUUM INTO ?");
+            query.addBindValue(targetFile);
+            ok = query.exec();
+
+            if (!ok) error = "备份失败: " + query.lastError().text();
+            query.finish();
+            database.close();
+        }
+    }
+    QSqlDatabase::removeDatabase(name);
+    return ok;
+}
+
+bool DatabaseBackup::snapshot(const QString& sourcePath,
+                              const QString& directory,
+                              int            keep,
+                              QString      & file,
+                              QString      & error)
+{
+    file = QDir(directory).filePath(snapshotName());
+    return writeSnapshot(sourcePath, file, keep, error);
+}
+
+bool DatabaseBackup::writeSnapshot(const QString& sourcePath,
+                                   const QString& target,
+                                   int            keep,
+                                   QString      & error)
+{
+    const QString directory = QFileInfo(target).absolutePath();
+
+    if (!QDir(directory).mkpath(".")) {
+        error = "无法创建备份目录: " + directory;
+        return false;
+    }
+
+    const QString part = target + ".part";
+
+    QFile::remove(part);
+
+    if (!backupTo(sourcePath, part, error)) {
+        QFile::remove(part);
+        return false;
+    }
+
+    // 同一秒内的第二次备份覆盖前一份
+    QFile::remove(target);
+
+    if (!QFile::rename(part, target)) {
+        error = "无法保存备份文件: " + target;
+        return false;
+    }
+    prune(directory, keep);
+    return true;
+}
+
+QFileInfoList DatabaseBackup::snapshots(const QString& directory)
+{
+    // 只认 snapshotName() 生成的文件名，备份目录中的 sms_campus.db 之类的数据库不算快照，不会被清理
+    static const QRegularExpression snapshotFile("^sms_\\d{8}_\\d{6}\\.db$");
+    QFileInfoList files;
+
+    // 文件名中的时间戳按字符串排序即按时间排序
+    for (const QFileInfo& file : QDir(directory).entryInfoList({ snapshotPattern }, QDir::Files,
+                                                               QDir::Name | QDir::Reversed)) {
+        if (snapshotFile.match(file.fileName()).hasMatch()) files << file;
+    }
+    return files;
+}
+
+int DatabaseBackup::prune(const QString& directory, int keep)
+{
+    const QFileInfoList files = snapshots(directory);
+    int removed = 0;
+
+    for (int i = qMax(keep, 1); i < files.size(); ++i) {
+        if (QFile::remove(files[i].absoluteFilePath())) ++removed;
+    }
+    return removed;
+}
+
+bool DatabaseBackup::start(const QString& sourcePath, const QString& directory, int keep)
+{
+    if (thread) return false;
+
+    const QString file = QDir(directory).filePath(snapshotName());
+
+    totalBytes = QFileInfo(sourcePath).size();
+    partFile = file + ".part";
+
+    thread = QThread::create([this, sourcePath, file, keep]() {
+        QString error;
+        const bool ok = writeSnapshot(sourcePath, file, keep, error);
+
+        // 回到界面线程发出信号
+        QMetaObject::invokeMethod(this, [this, ok, file, error]() {
+            progressTimer->stop();
+            thread->wait();
+            delete thread;
+            thread = nullptr;
+            emit finished(ok, file, error);
+        }, Qt::QueuedConnection);
+    });
+    thread->start(QThread::LowPriority);
+    progressTimer->start();
+    return true;
+}
+
+// .part 文件的大小即已写入的字节数
+void DatabaseBackup::reportProgress()
+{
+    emit progress(QFileInfo(partFile).size(), totalBytes);
+}
@@ -0,0 +1,68 @@
+#ifndef DATABASEBACKUP_H
+#define DATABASEBACKUP_H
+
+#include <QFileInfo>
+#include <QObject>
+#include <QString>
+
+class QThread;
+class QTimer;
+
+// 在线备份：用独立连接执行 VACUUM INTO，得到开始时刻的一致快照，备份期间程序照常使用。
+// 快照以 sms_yyyyMMdd_HHmmss.db 命名保存在备份目录中，先写到 .part 文件，完成后再改名，
+// 目录中只保留最近的若干份
+class DatabaseBackup : public QObject {
+    Q_OBJECT
+
+public:
+
+    explicit DatabaseBackup(QObject *parent = nullptr);
+    ~DatabaseBackup();
+
+    // 同步备份到 targetFile（不能已存在），在调用线程中执行，供 smscli 和后台线程使用
+    static bool          backupTo(const QString& sourcePath,
+                                  const QString& targetFile,
+                                  QString      & error);
+
+    // 在 directory 中生成一份快照并清理旧快照，成功时 file 为快照路径
+    static bool          snapshot(const QString& sourcePath,
+                                  const QString& directory,
+                                  int            keep,
+                                  QString      & file,
+                                  QString      & error);
+
+    // 目录中已有的快照，最新的在前。只包括 sms_yyyyMMdd_HHmmss.db 形式的文件
+    static QFileInfoList snapshots(const QString& directory);
+
+    // 只保留最近 keep 份快照，返回删除的文件数
+    static int           prune(const QString& directory, int keep);
+
+    // 在后台线程执行 snapshot()，进度和结果通过信号通知；已在备份时返回 false
+    bool                 start(const QString& sourcePath, const QString& directory, int keep);
+
+    bool                 isRunning() const {
+        return thread != nullptr;
+    }
+
+signals:
+
+    // written 为已写入快照的字节数，total 为源数据库大小，快照一般不大于源文件
+    void progress(qint64 written, qint64 total);
+    void finished(bool ok, const QString& file, const QString& error);
+
+private:
+
+    // 写入 target.part，完成后改名为 target，再清理 target 所在目录中的旧快照
+    static bool writeSnapshot(const QString& sourcePath,
+                              const QString& target,
+                              int            keep,
+                              QString      & error);
+    void        reportProgress();
+
+    QThread *thread = nullptr;
+    QTimer *progressTimer;
+    QString partFile; // 正在写入的 .part 文件
+    qint64 totalBytes = 0;
+};
+
+#endif // DATABASEBACKUP_H
@@ -1,6 +1,17 @@
 #include "databasemanager.h"
 #include <QDebug>
+#include <QElapsedTimer>
+#include <QFileInfo>
 #include <QSqlError>
+#include <QSqlQuery>
+#include <QAtomicInt>
+#include <QThread>
+#include <QThreadPool>
+#include <QThreadStorage>
+#include "queryprofiler.h"
+#include "schedulerepository.h"
+#include "settings.h"
+#include "startuptrace.h"
 
 DataBaseManager &DataBaseManager::instance()
 {
@@ -16,16 +27,391 @@ void DataBaseManager::closeDatabase()
     }
 }
 
+namespace {
+// 与文件本身相关的设置，每次打开时执行，必须在 ensureSchema() 建表之前
+void applyFilePragmas(const QSqlDatabase& database)
+{
+    QSqlQuery query(database);
+
+    // 新建的数据库启用增量清理，删除照片后空出的页可以由后台维护分批归还给文件系统。
+    // 必须在建表和切换 WAL 之前设置；已有的数据库要执行一次 VACUUM 才会生效
+    if(!query.exec("PRAGMA auto_vacuum = INCREMENTAL")){
+        qDebug()<<"无法设置增量清理："<<query.lastError().text();
+    }
+
+    // WAL 模式下读不阻塞写，在线备份和后台预取期间界面仍可保存修改
+    if(!query.exec("PRAGMA journal_mode = WAL")){
+        qDebug()<<"无法启用 WAL 模式："<<query.lastError().text();
+    }
+}
+}
+
 bool DataBaseManager::openDatabase(const QString &path)
 {
+    StartupTrace::Span span(Q_FUNC_INFO);
     db.setDatabaseName(path);
     if(!db.open()){
         qDebug()<<"无法打开数据库："<<db.lastError().text();
         return false;
     }
+    applyCacheSize(Settings::instance().getSqliteCacheKb());
+    applyFilePragmas(db);
+    return ensureSchema(db);
+}
+
+bool DataBaseManager::ensureSchema(const QSqlDatabase &database)
+{
+    static const char *const statements[] = {
+        "CREATE TABLE IF NOT EXISTS studentInfo ("
+        "id TEXT PRIMARY KEY, name TEXT, gender TEXT, birthday TEXT, join_date TEXT, "
+        "study_goal TEXT, progress TEXT, photo BLOB)",
+        "CREATE TABLE IF NOT EXISTS financialRecords ("
+        "id INTEGER PRIMARY KEY AUTOINCREMENT, student_id TEXT, payment_date TEXT, "
+        "amount REAL, payment_type TEXT, notes TEXT)",
+        "CREATE TABLE IF NOT EXISTS schedule ("
+        "date TEXT NOT NULL, slot INTEGER NOT NULL, "
+        "student_id TEXT REFERENCES studentInfo(id), start_time TEXT, note TEXT, "
+        "rule_id INTEGER REFERENCES scheduleRules(id), "
+        "PRIMARY KEY (date, slot))",
+        // 周期排课规则：每周 day_of_week 的 slot 时间段，在 [first_date, last_date] 内重复
+        "CREATE TABLE IF NOT EXISTS scheduleRules ("
+        "id INTEGER PRIMARY KEY AUTOINCREMENT, student_id TEXT NOT NULL REFERENCES studentInfo(id), "
+        "day_of_week INTEGER NOT NULL, slot INTEGER NOT NULL, start_time TEXT, "
+        "first_date TEXT NOT NULL, last_date TEXT NOT NULL)",
+        // 规则的例外日期（节假日、请假），这些日期不生成课程
+        "CREATE TABLE IF NOT EXISTS scheduleExceptions ("
+        "rule_id INTEGER NOT NULL REFERENCES scheduleRules(id), date TEXT NOT NULL, "
+        "PRIMARY KEY (rule_id, date))",
+        "CREATE TABLE IF NOT EXISTS honorWall ("
+        "id INTEGER PRIMARY KEY AUTOINCREMENT, image_data BLOB, description TEXT, added_date TEXT)",
+        "CREATE TABLE IF NOT EXISTS users (username TEXT PRIMARY KEY, password TEXT, "
+        "role TEXT NOT NULL DEFAULT '管理员')",
+        // 角色拥有的权限，权限名称见 Session::permissionNames()
+        "CREATE TABLE IF NOT EXISTS rolePermissions ("
+        "role TEXT NOT NULL, permission TEXT NOT NULL, PRIMARY KEY (role, permission))",
+    };
+
+    QSqlQuery query(database);
+    for(const char *sql : statements){
+        if(!query.exec(sql)){
+            qDebug()<<"创建数据表失败："<<query.lastError().text();
+            return false;
+        }
+    }
+    return migrate(database);
+}
+
+namespace {
+bool hasColumn(QSqlQuery& query, const QString& table, const QString& column)
+{
+    bool found=false;
+    if(!query.exec(QString("PRAGMA table_info(%1)").arg(table))) return false;
+    while(query.next()){
+        if(query.value(1).toString()==column) found=true;
+    }
+    return found;
+}
+
+// 版本 0 → 1：schedule 由 (date, time 文字, course_name "姓名,HH:mm") 改为
+// (date, slot 序号, student_id, start_time, note)。姓名能找到学生的关联 student_id，
+// 找不到的原文保留在 note 中；时间段名称无法识别的行原先也不会显示，直接丢弃
+bool migrateScheduleToV1(QSqlQuery& query)
+{
+    // 新建的数据库已经是新结构
+    if(!hasColumn(query,"schedule","time")) return true;
+
+    QStringList cases;
+    const QStringList& labels=ScheduleRepository::slotLabels();
+    for(int slot=0;slot<labels.size();++slot){
+        cases<<QString("WHEN '%1' THEN %2").arg(labels[slot]).arg(slot);
+    }
+
+    const QString studentName="substr(o.course_name, 1, instr(o.course_name, ',') - 1)";
+    const QStringList statements={
+        "ALTER TABLE schedule RENAME TO schedule_v0",
+        "CREATE TABLE schedule ("
+        "date TEXT NOT NULL, slot INTEGER NOT NULL, "
+        "student_id TEXT REFERENCES studentInfo(id), start_time TEXT, note TEXT, "
+        "PRIMARY KEY (date, slot))",
+        "INSERT OR REPLACE INTO schedule (date, slot, student_id, start_time, note) "
+        "SELECT o.date, CASE o.time "+cases.join(' ')+" END, "
+        "(SELECT st.id FROM studentInfo st WHERE st.name = "+studentName+" LIMIT 1), "
+        "CASE WHEN instr(o.course_name, ',') > 0 "
+        "THEN trim(substr(o.course_name, instr(o.course_name, ',') + 1)) END, "
+        "o.course_name "
+        "FROM schedule_v0 o WHERE o.time IN ('"+labels.join("', '")+"')",
+        // 关联到学生的课程不再需要原文；没关联上的也不保留拆出的时间
+        "UPDATE schedule SET note = NULL WHERE student_id IS NOT NULL",
+        "UPDATE schedule SET start_time = NULL WHERE student_id IS NULL",
+        "DROP TABLE schedule_v0",
+    };
+    for(const QString& sql:statements){
+        if(!query.exec(sql)) return false;
+    }
+    return true;
+}
+
+// 版本 1 → 2：schedule 增加 rule_id，记录由哪条周期规则生成，手工添加的课程为 NULL
+bool migrateScheduleToV2(QSqlQuery& query)
+{
+    if(hasColumn(query,"schedule","rule_id")) return true;
+    return query.exec("ALTER TABLE schedule ADD COLUMN rule_id INTEGER REFERENCES scheduleRules(id)");
+}
+
+// 版本 2 → 3：早期手工建的 users 表没有主键，用户名可能重复。
+// 每个用户名保留最早的一行，再建唯一索引，登录按用户名查找时走索引
+bool migrateUsersToV3(QSqlQuery& query)
+{
+    return query.exec("DELETE FROM users WHERE rowid NOT IN "
+                      "(SELECT MIN(rowid) FROM users GROUP BY username)") &&
+           query.exec("CREATE UNIQUE INDEX IF NOT EXISTS idx_users_username ON users (username)");
+}
+
+// 版本 3 → 4：users 增加角色，已有用户都是管理员；预置管理员、教师、财务三个角色
+bool migrateUsersToV4(QSqlQuery& query)
+{
+    if(!hasColumn(query,"users","role")&&
+       !query.exec("ALTER TABLE users ADD COLUMN role TEXT NOT NULL DEFAULT '管理员'")) return false;
+
+    return query.exec("INSERT OR IGNORE INTO rolePermissions (role, permission) VALUES "
+                      "('管理员', 'students'), ('管理员', 'schedule'), ('管理员', 'finance'), "
+                      "('管理员', 'honor'), ('管理员', 'settings'), ('管理员', 'users'), "
+                      "('教师', 'students'), ('教师', 'schedule'), ('教师', 'honor'), "
+                      "('教师', 'settings'), "
+                      "('财务', 'students'), ('财务', 'finance'), ('财务', 'settings')");
+}
+
+// 版本 4 → 5：全局搜索用的 FTS5 索引，收录学生姓名和学习目标、缴费备注、荣誉描述。
+// trigram 分词按每三个字符建索引，备注、学习目标中间的词也能搜到，需要 SQLite 3.34 以上；
+// 更早的版本退回 unicode61，搜索时全部按 LIKE 匹配，见 SearchRepository::search()。
+// rowid 的低两位是来源表（1 学生，2 缴费，3 荣誉）。缴费和荣誉的 id 是整数主键，rowid = id * 4 + 来源表，
+// 触发器按 rowid 直接增删。studentInfo 没有整数主键，VACUUM 后 rowid 可能重新编号，
+// 所以学生索引行的 rowid 记在 searchStudentRow 中，按学号查到后同样按 rowid 增删；
+// 新学生取其中最大值之后下一个除 4 余 1 的数，不与旧行冲突
+bool migrateSearchIndexToV5(QSqlQuery& query)
+{
+    // 先用临时表试出可用的分词器。缺少 FTS5 时不建索引，全局搜索没有结果，
+    // 但不能因此让升级失败、整个数据库打不开
+    QString tokenizer;
+    for(const QString& candidate:{QString("trigram"),QString("unicode61 remove_diacritics 2")}){
+        if(query.exec("CREATE VIRTUAL TABLE temp.searchIndexProbe USING fts5(x, tokenize = '"+candidate+"')")){
+            query.exec("DROP TABLE temp.searchIndexProbe");
+            tokenizer=candidate;
+            break;
+        }
+    }
+    if(tokenizer.isEmpty()){
+        qDebug()<<"SQLite 不支持 FTS5，不建立全局搜索索引："<<query.lastError().text();
+        return true;
+    }
+    if(tokenizer!="trigram") qDebug()<<"SQLite 低于 3.34，全局搜索索引改用 unicode61 分词";
+
+    const QStringList statements={
+        "CREATE VIRTUAL TABLE searchIndex USING fts5(title, body, tokenize = '"+tokenizer+"')",
+        "CREATE TABLE searchStudentRow ("
+        "student_id TEXT PRIMARY KEY, fts_rowid INTEGER NOT NULL UNIQUE)",
+
+        "CREATE TRIGGER searchIndex_student_insert AFTER INSERT ON studentInfo BEGIN "
+        "INSERT INTO searchStudentRow (student_id, fts_rowid) "
+        "SELECT new.id, ifnull(max(fts_rowid), 1) + 4 FROM searchStudentRow; "
+        "INSERT INTO searchIndex (rowid, title, body) "
+        "SELECT fts_rowid, new.name, new.study_goal FROM searchStudentRow WHERE student_id = new.id; "
+        "END",
+        "CREATE TRIGGER searchIndex_student_update AFTER UPDATE OF id, name, study_goal ON studentInfo BEGIN "
+        "DELETE FROM searchIndex WHERE rowid = (SELECT fts_rowid FROM searchStudentRow WHERE student_id = old.id); "
+        "UPDATE searchStudentRow SET student_id = new.id WHERE student_id = old.id; "
+        "INSERT INTO searchIndex (rowid, title, body) "
+        "SELECT fts_rowid, new.name, new.study_goal FROM searchStudentRow WHERE student_id = new.id; "
+        "END",
+        "CREATE TRIGGER searchIndex_student_delete AFTER DELETE ON studentInfo BEGIN "
+        "DELETE FROM searchIndex WHERE rowid = (SELECT fts_rowid FROM searchStudentRow WHERE student_id = old.id); "
+        "DELETE FROM searchStudentRow WHERE student_id = old.id; "
+        "END",
+
+        // 没有备注的缴费记录不进索引
+        "CREATE TRIGGER searchIndex_payment_insert AFTER INSERT ON financialRecords BEGIN "
+        "INSERT INTO searchIndex (rowid, body) SELECT new.id * 4 + 2, new.notes WHERE new.notes <> ''; "
+        "END",
+        "CREATE TRIGGER searchIndex_payment_update AFTER UPDATE OF notes ON financialRecords BEGIN "
+        "DELETE FROM searchIndex WHERE rowid = old.id * 4 + 2; "
+        "INSERT INTO searchIndex (rowid, body) SELECT new.id * 4 + 2, new.notes WHERE new.notes <> ''; "
+        "END",
+        "CREATE TRIGGER searchIndex_payment_delete AFTER DELETE ON financialRecords BEGIN "
+        "DELETE FROM searchIndex WHERE rowid = old.id * 4 + 2; "
+        "END",
+
+        "CREATE TRIGGER searchIndex_honor_insert AFTER INSERT ON honorWall BEGIN "
+        "INSERT INTO searchIndex (rowid, body) SELECT new.id * 4 + 3, new.description WHERE new.description <> ''; "
+        "END",
+        "CREATE TRIGGER searchIndex_honor_update AFTER UPDATE OF description ON honorWall BEGIN "
+        "DELETE FROM searchIndex WHERE rowid = old.id * 4 + 3; "
+        "INSERT INTO searchIndex (rowid, body) SELECT new.id * 4 + 3, new.description WHERE new.description <> ''; "
+        "END",
+        "CREATE TRIGGER searchIndex_honor_delete AFTER DELETE ON honorWall BEGIN "
+        "DELETE FROM searchIndex WHERE rowid = old.id * 4 + 3; "
+        "END",
+
+        // 已有数据一次性写入索引
+        "INSERT INTO searchStudentRow (student_id, fts_rowid) SELECT id, rowid * 4 + 1 FROM studentInfo",
+        "INSERT INTO searchIndex (rowid, title, body) "
+        "SELECT r.fts_rowid, s.name, s.study_goal FROM studentInfo s JOIN searchStudentRow r ON r.student_id = s.id",
+        "INSERT INTO searchIndex (rowid, body) SELECT id * 4 + 2, notes FROM financialRecords WHERE notes <> ''",
+        "INSERT INTO searchIndex (rowid, body) SELECT id * 4 + 3, description FROM honorWall WHERE description <> ''",
+    };
+    for(const QString& sql:statements){
+        if(!query.exec(sql)) return false;
+    }
+    return true;
+}
+
+// 版本 5 → 6：学生表格按入学日期、进度筛选和排序时走索引
+bool migrateStudentsToV6(QSqlQuery& query)
+{
+    return query.exec("CREATE INDEX IF NOT EXISTS idx_student_join_date ON studentInfo (join_date)") &&
+           query.exec("CREATE INDEX IF NOT EXISTS idx_student_progress ON studentInfo (progress, join_date)");
+}
+}
+
+bool DataBaseManager::migrate(const QSqlDatabase &database)
+{
+    QSqlDatabase db=database;
+    QSqlQuery query(db);
+
+    if(!query.exec("PRAGMA user_version")||!query.next()){
+        qDebug()<<"读取数据库版本失败："<<query.lastError().text();
+        return false;
+    }
+    const int version=query.value(0).toInt();
+    query.finish();
+
+    if(version<schemaVersion){
+        db.transaction();
+        bool ok=true;
+        if(version<1) ok=migrateScheduleToV1(query);
+        if(version<2) ok=ok&&migrateScheduleToV2(query);
+        if(version<3) ok=ok&&migrateUsersToV3(query);
+        if(version<4) ok=ok&&migrateUsersToV4(query);
+        if(version<5) ok=ok&&migrateSearchIndexToV5(query);
+        if(version<6) ok=ok&&migrateStudentsToV6(query);
+
+        // 依赖新结构的索引在升级之后创建
+        ok=ok&&query.exec("CREATE INDEX IF NOT EXISTS idx_schedule_student "
+                          "ON schedule (student_id, date)");
+        ok=ok&&query.exec("CREATE INDEX IF NOT EXISTS idx_schedule_rule "
+                          "ON schedule (rule_id, date)");
+        ok=ok&&query.exec(QString("PRAGMA user_version = %1").arg(schemaVersion));
+        if(!ok){
+            qDebug()<<"升级数据库结构失败："<<query.lastError().text();
+            db.rollback();
+            return false;
+        }
+        db.commit();
+        qDebug()<<"数据库结构已从版本"<<version<<"升级到"<<schemaVersion;
+    }
     return true;
 }
 
+bool DataBaseManager::switchDatabase(const QString &path, bool create, const std::function<bool()> &confirm)
+{
+    error.clear();
+
+    // 路径输错时不悄悄建一个空数据库
+    if(!create&&!QFileInfo::exists(path)){
+        error="数据库文件不存在："+path;
+        return false;
+    }
+
+    // 等待后台线程中的查询结束；完整性检查在两张表之间响应取消，不必等它检查完整个文件
+    cancelRequested.storeRelaxed(1);
+    pool.waitForDone();
+    cancelRequested.storeRelaxed(0);
+
+    // 先用临时连接打开新文件并升级结构，失败时当前连接不受影响
+    const QString probeName="sms_switch_probe";
+    {
+        QSqlDatabase probe=QSqlDatabase::addDatabase("QSQLITE",probeName);
+        probe.setDatabaseName(path);
+        if(!probe.open()) error="无法打开数据库："+probe.lastError().text();
+        else{
+            applyFilePragmas(probe);
+            if(!ensureSchema(probe)) error="数据库结构检查失败";
+        }
+        probe.close();
+    }
+    QSqlDatabase::removeDatabase(probeName);
+    if(!error.isEmpty()) return false;
+
+    // 后台线程的连接在下次使用时发现路径变化后重新打开，见 threadConnection()
+    const QString previous=dbPath;
+    closeDatabase();
+    dbPath=path;
+    if(!openDatabase(path)){
+        error="无法打开数据库："+db.lastError().text();
+        dbPath=previous;
+        openDatabase(previous);
+        return false;
+    }
+
+    // 确认之前不通知各页面，界面上仍是原数据库的内容；未确认时换回原数据库，
+    // 确认期间后台维护对新文件开始的检查也要结束
+    if(confirm&&!confirm()){
+        error="已取消切换";
+        cancelRequested.storeRelaxed(1);
+        pool.waitForDone();
+        cancelRequested.storeRelaxed(0);
+        closeDatabase();
+        dbPath=previous;
+        openDatabase(previous);
+        return false;
+    }
+    resetMaintenance();
+    emit databaseSwitched(path);
+    return true;
+}
+
+namespace {
+// 线程结束时 QThreadStorage 在该线程中删除它，同时关闭并移除连接。
+// 名称用递增序号而不是线程 id：线程池中过期的线程 id 会被新线程复用，
+// 旧连接属于已经结束的线程，新线程不能使用
+struct ThreadConnection {
+    QString name;
+
+    ~ThreadConnection()
+    {
+        {
+            QSqlDatabase database=QSqlDatabase::database(name,false);
+            database.close();
+        }
+        QSqlDatabase::removeDatabase(name);
+    }
+};
+
+QThreadStorage<ThreadConnection*> threadConnections;
+QAtomicInt threadConnectionCount;
+}
+
+QSqlDatabase DataBaseManager::threadConnection(const QString &path)
+{
+    if(!threadConnections.hasLocalData()){
+        ThreadConnection *connection=new ThreadConnection;
+        connection->name=QString("sms_thread_%1").arg(threadConnectionCount.fetchAndAddRelaxed(1));
+        threadConnections.setLocalData(connection);
+    }
+    const QString name=threadConnections.localData()->name;
+    QSqlDatabase database=QSqlDatabase::contains(name)
+            ? QSqlDatabase::database(name,false)
+            : QSqlDatabase::addDatabase("QSQLITE",name);
+
+    if(database.databaseName()!=path){//切换过数据库，重新打开
+        database.close();
+        database.setDatabaseName(path);
+    }
+    if(!database.isOpen()&&!database.open()){
+        qDebug()<<"后台线程无法打开数据库："<<database.lastError().text();
+    }
+    return database;
+}
+
 QString DataBaseManager::getDatabasePath() const
 {
     return dbPath;
@@ -33,7 +419,7 @@ QString DataBaseManager::getDatabasePath() const
 
 void DataBaseManager::setDatabasePath(const QString &path)
 {
-    if(path!= dbPath){//如果路径和上一次的不一样，即新开一个数据库
+    if(path!= dbPath||!db.isOpen()){//如果路径和上一次的不一样或还没打开，即新开一个数据库
         dbPath=path;
         closeDatabase();
         openDatabase(path);
@@ -44,13 +430,211 @@ void DataBaseManager::setDatabasePath(const QString &path)
 
 DataBaseManager::~DataBaseManager()
 {
+    cancelRequested.storeRelaxed(1);
+    pool.waitForDone();
     closeDatabase();
 }
 
+// 构造时不打开数据库，由调用方用 setDatabasePath() 指定文件：
+// 命令行工具的 --db 可能和 config.ini 中的不同，不能先打开并迁移后者
 DataBaseManager::DataBaseManager(QObject *parent)
     : QObject{parent}
 {
     db= QSqlDatabase::addDatabase("QSQLITE");
-    openDatabase(dbPath);
+    connect(&Settings::instance(),&Settings::sqliteCacheKbChanged,this,&DataBaseManager::applyCacheSize);
+    connect(&maintenanceTimer,&QTimer::timeout,this,&DataBaseManager::runMaintenanceStep);
+}
+
+void DataBaseManager::applyCacheSize(int kb)
+{
+    if(!db.isOpen()) return;
+    QSqlQuery query(db);
+    //负数表示以 KB 为单位
+    if(!query.exec(QString("PRAGMA cache_size = -%1").arg(qMax(kb,64)))){
+        qDebug()<<"设置缓存大小失败："<<query.lastError().text();
+    }
+}
+
+namespace {
+const int maintenanceIntervalMs=15*1000;  //空闲检查间隔
+const int vacuumIntervalMs=1000;          //还有空闲页没清理完时的间隔
+const qint64 idleThresholdMs=60*1000;     //距上次查询超过这个时间才做维护
+const int vacuumSliceMs=50;               //每片 incremental_vacuum 的时间上限，不明显阻塞界面
+const qint64 optimizeIntervalSecs=60*60;
+const qint64 quickCheckIntervalSecs=24*60*60;
+const int maxHistory=50;
+}
+
+void DataBaseManager::startMaintenance()
+{
+    maintenanceTimer.start(maintenanceIntervalMs);
 }
 
+void DataBaseManager::runMaintenanceStep()
+{
+    maintenanceTimer.setInterval(maintenanceIntervalMs);
+
+    // 界面最近还在查询，下次再看。维护语句本身不经过 QueryProfiler，不会推迟空闲时间
+    if(!db.isOpen()||quickCheckRunning) return;
+    if(QueryProfiler::instance().idleMs()<idleThresholdMs) return;
+
+    const QDateTime now=QDateTime::currentDateTime();
+    if(!lastOptimize.isValid()||lastOptimize.secsTo(now)>=optimizeIntervalSecs){
+        optimize();
+        return;
+    }
+    if(vacuumSlice()){
+        maintenanceTimer.setInterval(vacuumIntervalMs);
+        return;
+    }
+    if(!lastQuickCheck.isValid()||lastQuickCheck.secsTo(now)>=quickCheckIntervalSecs){
+        startQuickCheck();
+    }
+}
+
+// 从未 ANALYZE 过的数据库没有 sqlite_stat1，PRAGMA optimize 不一定补上，先完整分析一次。
+// analysis_limit 限制每个索引抽样的行数，大表上也能很快结束
+void DataBaseManager::optimize()
+{
+    lastOptimize=QDateTime::currentDateTime();
+
+    QElapsedTimer timer;
+    timer.start();
+
+    QSqlQuery query(db);
+    const bool hasStats=query.exec("SELECT 1 FROM sqlite_master WHERE name = 'sqlite_stat1'")&&query.next();
+    const QString task=hasStats?"PRAGMA optimize":"ANALYZE";
+
+    query.exec("PRAGMA analysis_limit = 1000");
+    const bool ok=query.exec(task);
+    recordMaintenance(task,ok,ok?"完成":query.lastError().text(),timer.elapsed());
+}
+
+// 清理一片空闲页，还有剩余时返回 true。每执行一次 incremental_vacuum 释放一页，
+// 在一个事务中循环执行到时间用完
+bool DataBaseManager::vacuumSlice()
+{
+    QSqlQuery query(db);
+    if(!query.exec("PRAGMA auto_vacuum")||!query.next()) return false;
+
+    if(query.value(0).toInt()!=2){
+        if(!autoVacuumNoted){
+            autoVacuumNoted=true;
+            recordMaintenance("incremental_vacuum",true,
+                              "数据库未启用增量清理，执行 smscli maintenance vacuum 后生效",0);
+        }
+        return false;
+    }
+
+    auto freePages=[&query]{
+        return (query.exec("PRAGMA freelist_count")&&query.next())?query.value(0).toInt():0;
+    };
+    const int before=freePages();
+    if(before==0) return false;
+
+    QElapsedTimer timer;
+    timer.start();
+
+    db.transaction();
+    QSqlQuery vacuum(db);
+    vacuum.prepare("PRAGMA incremental_vacuum");
+    bool ok=true;
+    for(int i=0;i<before&&timer.elapsed()<vacuumSliceMs;++i){
+        if(!(ok=vacuum.exec())) break;
+    }
+    vacuum.finish();
+    if(!ok){
+        const QString message=vacuum.lastError().text();
+        db.rollback();
+        recordMaintenance("incremental_vacuum",false,message,timer.elapsed());
+        return false;
+    }
+    db.commit();
+
+    const int after=freePages();
+    vacuumedPages+=before-after;
+    vacuumMs+=timer.elapsed();
+    if(after>0) return true;
+
+    recordMaintenance("incremental_vacuum",true,QString("释放 %1 页").arg(vacuumedPages),vacuumMs);
+    vacuumedPages=0;
+    vacuumMs=0;
+    return false;
+}
+
+// quick_check 要读完整个文件，放到后台线程；WAL 模式下不影响界面读写。
+// 逐表检查，每张表之间看一次取消标志，切换数据库和退出时不必等完整个文件
+void DataBaseManager::startQuickCheck()
+{
+    quickCheckRunning=true;
+    lastQuickCheck=QDateTime::currentDateTime();
+
+    const QString path=dbPath;
+    pool.start([this,path]{
+        QElapsedTimer timer;
+        timer.start();
+
+        QSqlQuery query(threadConnection(path));
+        QStringList tables,problems;
+        bool ok=query.exec("SELECT name FROM sqlite_master "
+                           "WHERE type = 'table' AND sql NOT LIKE 'CREATE VIRTUAL%'");
+        if(!ok) problems<<query.lastError().text();
+        while(query.next()) tables<<query.value(0).toString();
+
+        bool cancelled=false;
+        for(QString table:tables){
+            if(cancelRequested.loadRelaxed()){
+                cancelled=true;
+                break;
+            }
+            if(!query.exec(QString("PRAGMA quick_check(\"%1\")").arg(table.replace('"',"\"\"")))){
+                problems<<query.lastError().text();
+                continue;
+            }
+            while(query.next()){
+                const QString line=query.value(0).toString();
+                if(line!="ok") problems<<table+"："+line;
+            }
+        }
+        query.finish();
+        ok=problems.isEmpty();
+
+        const QString result=ok?"ok":problems.join('\n');
+        const qint64 elapsed=timer.elapsed();
+        QMetaObject::invokeMethod(this,[this,path,ok,cancelled,result,elapsed]{
+            quickCheckRunning=false;
+
+            // 中途取消或已切换到别的数据库，结果不记录，下次空闲时重新检查
+            if(cancelled||(path!=dbPath)){
+                lastQuickCheck=QDateTime();
+                return;
+            }
+            recordMaintenance("PRAGMA quick_check",ok,result,elapsed);
+        },Qt::QueuedConnection);
+    });
+}
+
+void DataBaseManager::recordMaintenance(const QString &task, bool ok, const QString &result, qint64 elapsedMs)
+{
+    MaintenanceRecord record;
+    record.time=QDateTime::currentDateTime();
+    record.task=task;
+    record.result=result;
+    record.elapsedMs=elapsedMs;
+    record.ok=ok;
+
+    history.append(record);
+    if(history.size()>maxHistory) history.removeFirst();
+    if(!ok) qDebug()<<"数据库维护失败："<<task<<result;
+    emit maintenanceFinished(record);
+}
+
+// 切换数据库后新文件的维护从头开始
+void DataBaseManager::resetMaintenance()
+{
+    lastOptimize=QDateTime();
+    lastQuickCheck=QDateTime();
+    autoVacuumNoted=false;
+    vacuumedPages=0;
+    vacuumMs=0;
+}
@@ -1,8 +1,23 @@
 #ifndef DATABASEMANAGER_H
 #define DATABASEMANAGER_H
 
+#include <QDateTime>
+#include <QAtomicInt>
 #include <QObject>
 #include <QSqlDatabase>
+#include <QThreadPool>
+#include <QTimer>
+#include <functional>
+#include <QVector>
+
+// 一次后台维护的结果，显示在诊断面板中
+struct MaintenanceRecord {
+    QDateTime time;
+    QString   task;
+    QString   result;
+    qint64    elapsedMs = 0;
+    bool      ok = true;
+};
 
 class DataBaseManager : public QObject
 {
@@ -13,14 +28,66 @@ public:
     bool openDatabase(const QString& path);
     QString getDatabasePath() const;
     void setDatabasePath(const QString& path);
+
+    // 程序运行中切换到另一个数据库文件：等待后台线程中的查询结束，新文件打开并通过
+    // 结构检查后才替换主连接。confirm 不为空时接着调用它（如在新数据库上重新登录），
+    // 返回 false 时换回原来的数据库；确认之后才发出 databaseSwitched()，各页面据此丢弃缓存并重新读取。
+    // create 为 false 时文件必须已经存在。失败时保持原来的数据库，原因见 lastError()
+    bool switchDatabase(const QString& path, bool create = false,
+                        const std::function<bool()>& confirm = {});
+    QString lastError() const { return error; }
+
+    // 表不存在时按程序使用的结构创建，已有的表保持不变
+    static bool ensureSchema(const QSqlDatabase& database);
+
+    // 数据库结构版本，保存在 PRAGMA user_version 中；旧版本的数据库打开时逐级升级
+    static constexpr int schemaVersion = 6;
+    static bool migrate(const QSqlDatabase& database);
+
+    // 后台线程使用的连接：每个线程一个，首次使用时打开，线程结束时移除。
+    // QSqlDatabase 不能跨线程使用，path 需由调用方在主线程取得后传入
+    static QSqlDatabase threadConnection(const QString& path);
+
+    // 后台查询（课程表预取、完整性检查）使用的线程池，切换数据库时只等待这里的任务
+    QThreadPool *backgroundPool() { return &pool; }
+
+    // 空闲时的后台维护：距上次查询超过一分钟才动手，每次只做一件事。
+    // 每小时 PRAGMA optimize（没有统计信息时先 ANALYZE），空闲页分片做 incremental_vacuum，
+    // 每天在后台线程做一次 quick_check。只有界面程序调用，命令行工具不做后台维护
+    void startMaintenance();
+    QVector<MaintenanceRecord> maintenanceHistory() const { return history; }
     ~DataBaseManager();
 
 private:
     explicit DataBaseManager(QObject *parent = nullptr);
+
+    // 主连接的 SQLite 页缓存大小，来自 Settings::getSqliteCacheKb()，修改后立即生效
+    void applyCacheSize(int kb);
+
+    void runMaintenanceStep();
+    void optimize();
+    bool vacuumSlice();
+    void startQuickCheck();
+    void recordMaintenance(const QString& task, bool ok, const QString& result, qint64 elapsedMs);
+    void resetMaintenance();
     QSqlDatabase db;
-    QString dbPath="S:/Qt/project/StudentManagerSystem/sqlite/StuManSys.db";
+    QString dbPath;
+    QString error;
+    QThreadPool pool;
+    QAtomicInt cancelRequested;  //切换数据库或退出时置 1，完整性检查提前结束
+
+    QTimer maintenanceTimer;
+    QDateTime lastOptimize;
+    QDateTime lastQuickCheck;
+    bool quickCheckRunning=false;
+    bool autoVacuumNoted=false;  //未启用增量清理的提示只记录一次
+    int vacuumedPages=0;         //本轮 incremental_vacuum 累计释放的页数和耗时
+    qint64 vacuumMs=0;
+    QVector<MaintenanceRecord> history;
 
 signals:
+    void databaseSwitched(const QString& path);
+    void maintenanceFinished(const MaintenanceRecord& record);
 };
 
 #endif // DATABASEMANAGER_H
@@ -0,0 +1,211 @@
+#include "dataexporter.h"
+#include "schedulerepository.h"
+#include "studentrepository.h"
+#include "eventloopmonitor.h"
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMimeDatabase>
+#include <QRegularExpression>
+#include <QTextStream>
+
+namespace {
+// 每写多少行发一次进度信号
+constexpr qint64 progressInterval = 1000;
+
+// CSV 字段转义：包含分隔符、引号或换行时用引号包裹，内部引号写成 ""
+QString csvField(const QString& text)
+{
+    if (!text.contains(QLatin1Char(',')) && !text.contains(QLatin1Char('"')) &&
+        !text.contains(QLatin1Char('\n')) && !text.contains(QLatin1Char('\r'))) return text;
+
+    QString escaped = text;
+    escaped.replace(QLatin1String("\""), QLatin1String("\"\""));
+    return QLatin1Char('"') + escaped + QLatin1Char('"');
+}
+}
+
+DataExporter::DataExporter(QObject *parent)
+    : QObject{parent}
+{}
+
+bool DataExporter::exportTo(Kind kind, Format format, const QString& filePath,
+                            const ExportFilter& filter)
+{
+    EventLoopMonitor::ActivityScope activity(Q_FUNC_INFO);
+
+    rows = 0;
+    canceled = false;
+    error.clear();
+
+    const bool  withPhoto = (kind == Students) && !photoDir.isEmpty();
+    QStringList header;
+
+    switch (kind) {
+    case Students:
+        header = { "id", "name", "gender", "birthday", "join_date", "study_goal",
+                   "progress" };
+
+        if (withPhoto) header << "photo";
+        break;
+
+    case Payments:
+        // 列顺序与导入格式一致，导出的文件可以直接重新导入
+        header = { "student_id", "payment_date", "amount", "payment_type", "notes",
+                   "student_name" };
+        break;
+
+    case Schedule:
+        header = { "date", "time", "student_id", "student_name", "start_time", "note" };
+        break;
+    }
+
+    QFile file(filePath);
+
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        error = "无法创建文件：" + file.errorString();
+        return false;
+    }
+
+    const QString exportDir = QFileInfo(filePath).absolutePath();
+
+    if (withPhoto && !QDir().mkpath(photoDir)) {
+        error = "无法创建照片目录：" + photoDir;
+        return false;
+    }
+
+    // QTextStream 自带固定大小的写缓冲，写满即落盘
+    QTextStream out(&file);
+    out.setEncoding(QStringConverter::Utf8);
+
+    if (format == Csv) {
+        out.setGenerateByteOrderMark(true); // 便于 Excel 识别 UTF-8
+        out << header.join(',') << '\n';
+    }
+    else {
+        out << "[\n";
+    }
+
+    // 仓库逐行回调，每行写出后即丢弃
+    auto emitRow = [&](const QVariantList& values) {
+        writeRow(out, format, header, values);
+        ++rows;
+
+        if (rows % progressInterval == 0) emit progress(rows);
+        return !canceled;
+    };
+    bool ok = false;
+
+    switch (kind) {
+    case Students: {
+        StudentRepository repository;
+        ok = repository.forEach(withPhoto, [&](const StudentRecord& student) {
+            QVariantList values = { student.id, student.name, student.gender,
+                                    student.birthday.toString("yyyy-MM-dd"),
+                                    student.joinDate.toString("yyyy-MM-dd"),
+                                    student.studyGoal, student.progress };
+
+            if (withPhoto) {
+                values << (student.photo.isEmpty()
+                           ? QString() : writePhoto(student.id, student.photo, exportDir));
+            }
+            return emitRow(values);
+        });
+        error = repository.lastError();
+        break;
+    }
+
+    case Payments: {
+        PaymentRepository repository;
+        ok = repository.forEach(filter, [&](const PaymentRecord& payment) {
+            return emitRow({ payment.studentId,
+                             payment.paymentDate.toString("yyyy-MM-dd"),
+                             payment.amount, payment.paymentType, payment.notes,
+                             payment.studentName });
+        });
+        error = repository.lastError();
+        break;
+    }
+
+    case Schedule: {
+        ScheduleRepository repository;
+        ok = repository.forEach(filter.from, filter.to, filter.studentId,
+                                [&](const ScheduleEntry& entry) {
+            return emitRow({ entry.date.toString("yyyy-MM-dd"),
+                             ScheduleRepository::slotLabels().value(entry.slot),
+                             entry.studentId, entry.studentName,
+                             entry.startTime.toString("HH:mm"), entry.note });
+        });
+        error = repository.lastError();
+        break;
+    }
+    }
+
+    if (format == Json) out << "\n]\n";
+    out.flush();
+
+    if (!ok) {
+        error = "查询失败：" + error;
+        return false;
+    }
+
+    if (out.status() != QTextStream::Ok) {
+        error = "写入文件失败：" + file.errorString();
+        return false;
+    }
+
+    if (canceled) {
+        error = "导出已取消";
+        return false;
+    }
+    emit progress(rows);
+    return true;
+}
+
+void DataExporter::writeRow(QTextStream& out, Format format,
+                            const QStringList& header, const QVariantList& values)
+{
+    if (format == Csv) {
+        for (int col = 0; col < values.size(); ++col) {
+            if (col > 0) out << ',';
+            out << csvField(values.at(col).toString());
+        }
+        out << '\n';
+        return;
+    }
+
+    QJsonObject object;
+
+    for (int col = 0; col < values.size(); ++col) {
+        object.insert(header.at(col), QJsonValue::fromVariant(values.at(col)));
+    }
+
+    if (rows > 0) out << ",\n";
+    out << QString::fromUtf8(QJsonDocument(object).toJson(QJsonDocument::Compact));
+}
+
+// 照片以学号命名写入照片目录，扩展名按图片内容判断，返回相对导出文件的路径
+QString DataExporter::writePhoto(const QString& id, const QByteArray& data,
+                                 const QString& exportDir)
+{
+    static const QMimeDatabase mimeDb;
+    QString suffix = mimeDb.mimeTypeForData(data).preferredSuffix();
+
+    if (suffix.isEmpty()) suffix = "bin";
+
+    QString safeId = id;
+    safeId.replace(QRegularExpression(R"([\\/:*?"<>|])"), "_");
+
+    const QString photoPath = QDir(photoDir).absoluteFilePath(safeId + '.' + suffix);
+    QFile photoFile(photoPath);
+
+    if (!photoFile.open(QIODevice::WriteOnly | QIODevice::Truncate) ||
+        (photoFile.write(data) != data.size())) {
+        qWarning() << "写入照片失败：" << photoPath << photoFile.errorString();
+        return QString();
+    }
+    return QDir(exportDir).relativeFilePath(photoPath);
+}
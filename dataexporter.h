@@ -0,0 +1,77 @@
+#ifndef DATAEXPORTER_H
+#define DATAEXPORTER_H
+
+#include "paymentrepository.h"
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QVariantList>
+
+class QTextStream;
+
+// 导出筛选条件与缴费查询条件相同：缴费记录按学生和日期筛选，
+// 课程表只使用日期范围，学生信息全部导出
+using ExportFilter = PaymentFilter;
+
+// 将 studentInfo、financialRecords、schedule 导出为 CSV 或 JSON。
+// 查询结果逐行写入文件，不在内存中缓存整个结果集
+class DataExporter : public QObject {
+    Q_OBJECT
+
+public:
+
+    enum Kind {
+        Students,
+        Payments,
+        Schedule
+    };
+
+    enum Format {
+        Csv,
+        Json
+    };
+
+    explicit DataExporter(QObject *parent = nullptr);
+
+    // 成功返回 true，失败原因见 lastError()
+    bool exportTo(Kind kind, Format format, const QString& filePath,
+                  const ExportFilter& filter = ExportFilter());
+
+    // 设置后导出学生时把照片写到该目录，CSV/JSON 中记录相对路径；
+    // 为空则不导出照片
+    void setPhotoDirectory(const QString& dir) {
+        photoDir = dir;
+    }
+
+    qint64 exportedRows() const {
+        return rows;
+    }
+
+    QString lastError() const {
+        return error;
+    }
+
+public slots:
+
+    void cancel() {
+        canceled = true;
+    }
+
+signals:
+
+    void progress(qint64 rowsWritten);
+
+private:
+
+    QString writePhoto(const QString& id, const QByteArray& data,
+                       const QString& exportDir);
+    void    writeRow(QTextStream& out, Format format, const QStringList& header,
+                     const QVariantList& values);
+
+    QString photoDir;
+    QString error;
+    qint64 rows = 0;
+    bool canceled = false;
+};
+
+#endif // DATAEXPORTER_H
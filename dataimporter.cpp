@@ -0,0 +1,483 @@
+#include "dataimporter.h"
+#include "eventloopmonitor.h"
+#include <QDate>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+
+namespace {
+// 单批照片数据上限，避免带照片的大批次占用过多内存
+constexpr qint64 maxBatchBytes = 32 * 1024 * 1024;
+
+// 每处理多少行发一次进度信号
+constexpr qint64 progressInterval = 1000;
+
+// 依次尝试 Excel 常见的日期格式
+QDate parseDate(const QString& text)
+{
+    static const QStringList formats = { "yyyy-MM-dd", "yyyy/M/d", "yyyy-M-d",
+                                         "yyyy.M.d", "yyyyMMdd" };
+
+    for (const QString& format : formats) {
+        QDate date = QDate::fromString(text, format);
+
+        if (date.isValid()) return date;
+    }
+    return QDate();
+}
+}
+
+CsvReader::CsvReader(QIODevice *device, QChar delimiter)
+    : dev(device), stream(device), sep(delimiter)
+{}
+
+qint64 CsvReader::position() const
+{
+    return dev->pos();
+}
+
+bool CsvReader::nextLine(QString& line)
+{
+    if (stream.atEnd()) return false;
+
+    line = stream.readLine();
+    ++physicalLine;
+    return true;
+}
+
+bool CsvReader::readRow(QStringList& fields)
+{
+    fields.clear();
+    QString line;
+
+    // 跳过空行
+    do {
+        if (!nextLine(line)) return false;
+    } while (line.trimmed().isEmpty());
+
+    recordLine = physicalLine;
+
+    // 未指定分隔符时根据第一行自动识别（逗号、制表符或分号）
+    if (sep.isNull()) {
+        sep = ',';
+        int best = line.count(',');
+
+        for (QChar candidate : { QChar('\t'), QChar(';') }) {
+            if (line.count(candidate) > best) {
+                best = line.count(candidate);
+                sep = candidate;
+            }
+        }
+    }
+
+    QString field;
+    bool    inQuotes = false;
+    int     i = 0;
+
+    forever {
+        for (; i < line.size(); ++i) {
+            const QChar c = line.at(i);
+
+            if (inQuotes) {
+                if (c == '"') {
+                    if ((i + 1 < line.size()) && (line.at(i + 1) == '"')) {
+                        field += '"'; // "" 转义为一个引号
+                        ++i;
+                    }
+                    else inQuotes = false;
+                }
+                else field += c;
+            }
+            else if ((c == '"') && field.isEmpty()) inQuotes = true;
+            else if (c == sep) {
+                fields << field;
+                field.clear();
+            }
+            else field += c;
+        }
+
+        if (!inQuotes) break;
+
+        // 引号内的换行属于字段内容，继续读取下一物理行
+        if (!nextLine(line)) break;
+        field += '\n';
+        i = 0;
+    }
+    fields << field;
+    return true;
+}
+
+// 一个批次待插入的记录及其在文件中的行号
+struct DataImporter::Batch {
+    QVector<StudentRecord> students;
+    QVector<PaymentRecord> payments;
+    QVector<ScheduleEntry> schedule;
+    QVector<qint64>        lines;
+    qint64                 bytes = 0;
+
+    int  size() const {
+        return lines.size();
+    }
+
+    void clear() {
+        students.clear();
+        payments.clear();
+        schedule.clear();
+        lines.clear();
+        bytes = 0;
+    }
+};
+
+DataImporter::DataImporter(QObject *parent)
+    : QObject{parent}
+{}
+
+ImportReport DataImporter::importFile(Kind kind, const QString& filePath)
+{
+    EventLoopMonitor::ActivityScope activity(Q_FUNC_INFO);
+
+    ImportReport  report;
+    QElapsedTimer timer;
+
+    timer.start();
+
+    QFile file(filePath);
+
+    if (!file.open(QIODevice::ReadOnly)) {
+        report.fatalError = "无法打开文件：" + file.errorString();
+        return report;
+    }
+
+    // 已存在的学号，用于去重和外键校验
+    StudentRepository studentRepository;
+    studentIds = studentRepository.loadIds();
+
+    if (!studentRepository.lastError().isEmpty()) {
+        report.fatalError = "读取学生编号失败：" + studentRepository.lastError();
+        return report;
+    }
+
+    // 课程冲突检查用的索引，按学生在首次出现时读取其已有课程
+    ScheduleRepository existingSchedule;
+    conflictIndex.clear();
+    scheduleRepository = &existingSchedule;
+
+    CsvReader reader(&file);
+    reader.setEncoding(encoding == System ? QStringConverter::System
+                                          : QStringConverter::Utf8);
+
+    const QString baseDir = QFileInfo(filePath).absolutePath();
+    const qint64  fileSize = qMax<qint64>(1, file.size());
+    Batch         batch;
+    QStringList   fields;
+    StudentRecord student;
+    PaymentRecord payment;
+    ScheduleEntry entry;
+    QString       error;
+    bool          firstRow = true;
+
+    canceled = false;
+
+    while (!canceled && reader.readRow(fields)) {
+        // 第一行如果是表头则跳过
+        if (firstRow) {
+            firstRow = false;
+            static const QStringList headerNames =
+            { "id", "student_id", "编号", "学号", "学生编号", "date", "日期" };
+
+            if (headerNames.contains(fields.value(0).trimmed(), Qt::CaseInsensitive)) continue;
+        }
+
+        ++report.totalRows;
+
+        bool valid = (kind == Students)
+                     ? validateStudent(fields, baseDir, student, error)
+                     : (kind == Payments) ? validatePayment(fields, payment, error)
+                                          : validateSchedule(fields, entry, error);
+
+        if (!valid) {
+            reject(report, reader.lineNumber(), error);
+        }
+        else {
+            if (kind == Students) {
+                batch.students.append(student);
+                batch.bytes += student.photo.size();
+                studentIds.insert(student.id); // 同一文件内重复的学号也要拦下
+            }
+            else if (kind == Payments) {
+                batch.payments.append(payment);
+            }
+            else {
+                batch.schedule.append(entry);
+                conflictIndex.add(entry); // 文件中后面的行也要与这一行比较
+            }
+            batch.lines.append(reader.lineNumber());
+        }
+
+        if ((batch.size() >= batchSize) || (batch.bytes >= maxBatchBytes)) {
+            if (!flushBatch(kind, batch, report)) break;
+        }
+
+        if (report.totalRows % progressInterval == 0) {
+            emit progress(int(reader.position() * 100 / fileSize), report.totalRows);
+        }
+    }
+
+    if (batch.size() > 0) flushBatch(kind, batch, report);
+
+    if (canceled) report.fatalError = "导入已取消";
+
+    scheduleRepository = nullptr;
+    conflictIndex.clear();
+
+    report.elapsedMs = timer.elapsed();
+    emit progress(100, report.totalRows);
+    return report;
+}
+
+bool DataImporter::validateStudent(const QStringList& fields,
+                                   const QString    & baseDir,
+                                   StudentRecord    & student,
+                                   QString          & error)
+{
+    static const QStringList genders = { "男", "女" };
+    static const QStringList progresses =
+    { "0%", "20%", "40%", "60%", "80%", "100%" };
+
+    if (fields.size() < 7) {
+        error = QString("列数不足：需要至少 7 列，实际 %1 列").arg(fields.size());
+        return false;
+    }
+
+    const QString id = fields[0].trimmed();
+    const QString name = fields[1].trimmed();
+
+    if (id.isEmpty() || name.isEmpty()) {
+        error = "学号和姓名不能为空";
+        return false;
+    }
+
+    if (studentIds.contains(id)) {
+        error = QString("学号 %1 已存在").arg(id);
+        return false;
+    }
+
+    const QString gender = fields[2].trimmed();
+
+    if (!genders.contains(gender)) {
+        error = QString("性别无效：%1").arg(gender);
+        return false;
+    }
+
+    // 日期可以为空，不为空时必须能识别
+    const QDate birthday = parseDate(fields[3].trimmed());
+    const QDate joinDate = parseDate(fields[4].trimmed());
+
+    if ((!birthday.isValid() && !fields[3].trimmed().isEmpty()) ||
+        (!joinDate.isValid() && !fields[4].trimmed().isEmpty())) {
+        error = "日期格式无效，应为 yyyy-MM-dd";
+        return false;
+    }
+
+    // 进度允许省略百分号，例如 60 -> 60%
+    QString progress = fields[6].trimmed();
+
+    if (!progress.isEmpty() && !progress.endsWith('%')) progress += '%';
+
+    if (!progresses.contains(progress)) {
+        error = QString("进度无效：%1").arg(fields[6].trimmed());
+        return false;
+    }
+
+    // 照片列为图片文件路径，相对路径以导入文件所在目录为基准
+    QByteArray photo;
+    const QString photoPath = fields.value(7).trimmed();
+
+    if (!photoPath.isEmpty()) {
+        QFile photoFile(QDir(baseDir).absoluteFilePath(photoPath));
+
+        if (!photoFile.open(QIODevice::ReadOnly)) {
+            error = QString("无法读取照片：%1").arg(photoPath);
+            return false;
+        }
+        photo = photoFile.readAll();
+    }
+
+    student = { id, name, gender, birthday, joinDate, fields[5].trimmed(), progress,
+                photo };
+    return true;
+}
+
+bool DataImporter::validatePayment(const QStringList& fields,
+                                   PaymentRecord    & payment,
+                                   QString          & error)
+{
+    if (fields.size() < 3) {
+        error = QString("列数不足：需要至少 3 列，实际 %1 列").arg(fields.size());
+        return false;
+    }
+
+    const QString studentId = fields[0].trimmed();
+
+    if (!studentIds.contains(studentId)) {
+        error = QString("学号 %1 不存在").arg(studentId);
+        return false;
+    }
+
+    const QDate paymentDate = parseDate(fields[1].trimmed());
+
+    if (!paymentDate.isValid()) {
+        error = QString("缴费日期无效：%1").arg(fields[1].trimmed());
+        return false;
+    }
+
+    bool   ok = false;
+    double amount = fields[2].trimmed().toDouble(&ok);
+
+    if (!ok) {
+        error = QString("金额无效：%1").arg(fields[2].trimmed());
+        return false;
+    }
+
+    payment = PaymentRecord();
+    payment.studentId = studentId;
+    payment.paymentDate = paymentDate;
+    payment.amount = amount;
+    payment.paymentType = fields.value(3).trimmed();
+    payment.notes = fields.value(4).trimmed();
+    return true;
+}
+
+bool DataImporter::validateSchedule(const QStringList& fields,
+                                    ScheduleEntry    & entry,
+                                    QString          & error)
+{
+    if (fields.size() < 3) {
+        error = QString("列数不足：需要至少 3 列，实际 %1 列").arg(fields.size());
+        return false;
+    }
+
+    entry = ScheduleEntry();
+    entry.date = parseDate(fields[0].trimmed());
+
+    if (!entry.date.isValid()) {
+        error = QString("日期无效：%1").arg(fields[0].trimmed());
+        return false;
+    }
+
+    // 时间段可以是名称（"上午1"）或序号
+    const QString slotText = fields[1].trimmed();
+    entry.slot = ScheduleRepository::slotLabels().indexOf(slotText);
+
+    if (entry.slot == -1) {
+        bool isNumber = false;
+        int  slot = slotText.toInt(&isNumber);
+        entry.slot = isNumber ? slot : -1;
+    }
+
+    if ((entry.slot < 0) || (entry.slot >= ScheduleRepository::slotLabels().size())) {
+        error = QString("时间段无效：%1").arg(slotText);
+        return false;
+    }
+
+    entry.studentId = fields[2].trimmed();
+    entry.note = fields.value(5).trimmed();
+
+    if (entry.studentId.isEmpty()) {
+        // 没有关联学生的课程只保存备注
+        if (entry.note.isEmpty()) {
+            error = "学号和备注不能都为空";
+            return false;
+        }
+        return true;
+    }
+
+    if (!studentIds.contains(entry.studentId)) {
+        error = QString("学号 %1 不存在").arg(entry.studentId);
+        return false;
+    }
+
+    entry.startTime = QTime::fromString(fields.value(4).trimmed(), "H:mm");
+
+    if (!entry.startTime.isValid()) {
+        error = QString("开始时间无效：%1").arg(fields.value(4).trimmed());
+        return false;
+    }
+
+    if (!conflictIndex.loadStudent(*scheduleRepository, entry.studentId)) {
+        error = "读取已有课程失败：" + scheduleRepository->lastError();
+        return false;
+    }
+
+    if (auto conflict = conflictIndex.findConflict(entry)) {
+        error = QString("与 %1 %2 %3 的课程时间重叠")
+                .arg(conflict->date.toString("yyyy-MM-dd"))
+                .arg(ScheduleRepository::slotLabels().value(conflict->slot))
+                .arg(conflict->startTime.toString("HH:mm"));
+        return false;
+    }
+    return true;
+}
+
+bool DataImporter::flushBatch(Kind kind, Batch& batch, ImportReport& report)
+{
+    StudentRepository  students;
+    PaymentRepository  payments;
+    ScheduleRepository schedule;
+    Repository& repository = (kind == Students)
+                             ? static_cast<Repository&>(students)
+                             : (kind == Payments) ? static_cast<Repository&>(payments)
+                                                  : static_cast<Repository&>(schedule);
+
+    // 一个批次一个事务
+    repository.transaction();
+
+    bool inserted = (kind == Students) ? students.insertBatch(batch.students)
+                                       : (kind == Payments) ? payments.insertBatch(batch.payments)
+                                                            : schedule.insertBatch(batch.schedule);
+
+    if (inserted && repository.commit()) {
+        report.imported += batch.size();
+        batch.clear();
+        return true;
+    }
+    repository.rollback();
+
+    // 整批失败时逐行重放，定位出错的行，其余行照常写入
+    if (!repository.transaction()) {
+        report.fatalError = "开启事务失败：" + repository.lastError();
+        return false;
+    }
+
+    for (int r = 0; r < batch.size(); ++r) {
+        bool ok = (kind == Students) ? students.insert(batch.students.at(r))
+                                     : (kind == Payments) ? payments.insert(batch.payments.at(r))
+                                                          : schedule.insert(batch.schedule.at(r));
+
+        if (ok) {
+            ++report.imported;
+        }
+        else {
+            reject(report, batch.lines.at(r), repository.lastError());
+
+            if (kind == Students) studentIds.remove(batch.students.at(r).id);
+
+            if (kind == Schedule) conflictIndex.remove(batch.schedule.at(r));
+        }
+    }
+
+    bool committed = repository.commit();
+
+    if (!committed) report.fatalError = "提交事务失败：" + repository.lastError();
+    batch.clear();
+    return committed;
+}
+
+void DataImporter::reject(ImportReport& report, qint64 line, const QString& message)
+{
+    ++report.rejected;
+
+    if (report.errors.size() < maxStoredErrors) report.errors.append({ line, message });
+    emit rowRejected(line, message);
+}
@@ -0,0 +1,141 @@
+#ifndef DATAIMPORTER_H
+#define DATAIMPORTER_H
+
+#include "paymentrepository.h"
+#include "scheduleconflictindex.h"
+#include "studentrepository.h"
+#include <QObject>
+#include <QSet>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <QTextStream>
+
+class QIODevice;
+
+// CSV 逐条读取器：每次只解析一条记录，支持引号内的逗号、换行和 "" 转义，
+// 不会把整个文件读入内存
+class CsvReader {
+public:
+
+    explicit CsvReader(QIODevice *device, QChar delimiter = QChar());
+
+    // 读取下一条记录，文件结束时返回 false
+    bool   readRow(QStringList& fields);
+
+    // 当前记录在文件中的起始行号（从 1 开始）
+    qint64 lineNumber() const {
+        return recordLine;
+    }
+
+    QChar delimiter() const {
+        return sep;
+    }
+
+    // 已读取的字节位置，用于计算进度
+    qint64 position() const;
+
+    void   setEncoding(QStringConverter::Encoding encoding) {
+        stream.setEncoding(encoding);
+    }
+
+private:
+
+    bool nextLine(QString& line);
+
+    QIODevice *dev;
+    QTextStream stream;
+    QChar sep;
+    qint64 physicalLine = 0;
+    qint64 recordLine = 0;
+};
+
+// 单行导入错误
+struct ImportError {
+    qint64  line;
+    QString message;
+};
+
+// 导入结果统计
+struct ImportReport {
+    qint64               totalRows = 0;
+    qint64               imported = 0;
+    qint64               rejected = 0;
+    qint64               elapsedMs = 0;
+    QVector<ImportError> errors; // 最多保留 maxStoredErrors 条，其余只计数
+    QString              fatalError;
+
+    double rowsPerSecond() const {
+        return elapsedMs > 0 ? imported * 1000.0 / elapsedMs : imported;
+    }
+};
+
+// 批量导入学生、缴费记录和课程：流式解析文件，逐行校验，
+// 按批次用 execBatch() 在事务中插入
+class DataImporter : public QObject {
+    Q_OBJECT
+
+public:
+
+    enum Kind {
+        Students, // id,name,gender,birthday,join_date,study_goal,progress[,photo]
+        Payments, // student_id,payment_date,amount,payment_type,notes
+        Schedule  // date,time,student_id[,student_name,start_time,note]，与导出格式相同
+    };
+
+    enum Encoding {
+        Utf8,  // UTF-8（带或不带 BOM）
+        System // 系统本地编码，Excel 在中文 Windows 上默认另存为 GBK
+    };
+
+    explicit DataImporter(QObject *parent = nullptr);
+
+    ImportReport importFile(Kind kind, const QString& filePath);
+
+    void setBatchSize(int rows) {
+        batchSize = qMax(1, rows);
+    }
+
+    void setEncoding(Encoding enc) {
+        encoding = enc;
+    }
+
+    static constexpr int maxStoredErrors = 1000;
+
+public slots:
+
+    // 中止当前导入，已提交的批次保留
+    void cancel() {
+        canceled = true;
+    }
+
+signals:
+
+    // percent 基于已读取的字节数
+    void progress(int percent, qint64 rowsProcessed);
+    void rowRejected(qint64 line, const QString& message);
+
+private:
+
+    struct Batch;
+
+    bool validateStudent(const QStringList& fields, const QString& baseDir,
+                         StudentRecord& student, QString& error);
+    bool validatePayment(const QStringList& fields, PaymentRecord& payment,
+                         QString& error);
+
+    // 课程还要检查同一学生的时间重叠，包括与数据库中已有课程和文件中前面各行
+    bool validateSchedule(const QStringList& fields, ScheduleEntry& entry,
+                          QString& error);
+    bool flushBatch(Kind kind, Batch& batch, ImportReport& report);
+    void reject(ImportReport& report, qint64 line, const QString& message);
+
+    int batchSize = 5000;
+    Encoding encoding = Utf8;
+    bool canceled = false;
+    QSet<QString> studentIds; // 已存在的学号，用于去重和外键校验
+    ScheduleConflictIndex conflictIndex;
+    ScheduleRepository *scheduleRepository = nullptr; // 仅在导入课程期间有效
+};
+
+#endif // DATAIMPORTER_H
@@ -0,0 +1,211 @@
+#include "datasetgenerator.h"
+#include "honorrepository.h"
+#include "passwordhasher.h"
+#include "paymentrepository.h"
+#include "schedulerepository.h"
+#include "studentrepository.h"
+#include "userrepository.h"
+#include <QBuffer>
+#include <QImage>
+#include <QRandomGenerator>
+#include <QStringList>
+
+namespace {
+const quint32 seed = 20240901;
+const int batchSize = 2000;
+
+// 和界面中各下拉框的选项保持一致
+const QStringList genders = { "男", "女" };
+const QStringList progresses = { "0%", "20%", "40%", "60%", "80%", "100%" };
+const QStringList goals = { "考级", "兴趣", "比赛", "升学" };
+const QStringList paymentTypes = { "学费", "教材费", "报名费", "考级费", "其他" };
+// 与 ScheduleRepository::slotLabels() 的各时间段一一对应
+const QStringList startTimes = { "08:30", "10:00", "14:00", "15:30", "18:30", "20:00" };
+
+// 渐变底色加若干色块，PNG 压缩后大小与真实证件照相近
+QByteArray makeImage(QRandomGenerator& random, int width, int height)
+{
+    QImage image(width, height, QImage::Format_RGB32);
+    const int r = random.bounded(256), g = random.bounded(256), b = random.bounded(256);
+
+    for (int y = 0; y < height; ++y) {
+        QRgb *line = reinterpret_cast<QRgb *>(image.scanLine(y));
+
+        for (int x = 0; x < width; ++x) {
+            line[x] = qRgb((r + x) & 0xff, (g + y) & 0xff, (b + x + y) & 0xff);
+        }
+    }
+
+    for (int i = 0; i < 8; ++i) {
+        const int x = random.bounded(width), y = random.bounded(height);
+        const int w = random.bounded(1, width / 3 + 2), h = random.bounded(1, height / 3 + 2);
+        const QRgb color = qRgb(random.bounded(256), random.bounded(256), random.bounded(256));
+
+        for (int dy = y; dy < qMin(height, y + h); ++dy) {
+            QRgb *line = reinterpret_cast<QRgb *>(image.scanLine(dy));
+
+            for (int dx = x; dx < qMin(width, x + w); ++dx) line[dx] = color;
+        }
+    }
+
+    QByteArray data;
+    QBuffer    buffer(&data);
+    buffer.open(QIODevice::WriteOnly);
+    image.save(&buffer, "PNG");
+    return data;
+}
+}
+
+const QString DatasetGenerator::benchUsername = "bench";
+const QString DatasetGenerator::benchPassword = "bench123";
+
+DatasetGenerator::DatasetGenerator(const QSqlDatabase& database)
+    : db(database)
+{}
+
+QString DatasetGenerator::studentId(int index)
+{
+    return QString("S%1").arg(index, 6, 10, QChar('0'));
+}
+
+bool DatasetGenerator::generate(const Sizes& sizes)
+{
+    if (!db.transaction()) {
+        error = "无法开启事务";
+        return false;
+    }
+
+    if (!generateStudents(sizes) || !generatePayments(sizes) ||
+        !generateSchedule(sizes) || !generateHonorWall(sizes) || !generateUser()) {
+        db.rollback();
+        return false;
+    }
+
+    if (!db.commit()) {
+        error = "提交事务失败";
+        return false;
+    }
+    return true;
+}
+
+bool DatasetGenerator::generateStudents(const Sizes& sizes)
+{
+    QRandomGenerator       random(seed);
+    StudentRepository      repository(db);
+    QVector<StudentRecord> batch;
+    const QDate today = QDate::currentDate();
+
+    for (int i = 0; i < sizes.students; ++i) {
+        StudentRecord record;
+        record.id = studentId(i);
+        record.name = QString("学生%1").arg(i);
+        record.gender = genders[random.bounded(genders.size())];
+        record.birthday = today.addYears(-random.bounded(6, 18)).addDays(-random.bounded(365));
+        record.joinDate = today.addDays(-random.bounded(3 * 365));
+        record.studyGoal = goals[random.bounded(goals.size())];
+        record.progress = progresses[random.bounded(progresses.size())];
+        record.photo = makeImage(random, sizes.photoSize, sizes.photoSize);
+        batch.append(record);
+
+        if ((batch.size() >= batchSize) || (i == sizes.students - 1)) {
+            if (!repository.insertBatch(batch)) {
+                error = "写入学生失败: " + repository.lastError();
+                return false;
+            }
+            batch.clear();
+        }
+    }
+    return true;
+}
+
+bool DatasetGenerator::generatePayments(const Sizes& sizes)
+{
+    if (sizes.students <= 0) return true;
+
+    QRandomGenerator       random(seed + 1);
+    PaymentRepository      repository(db);
+    QVector<PaymentRecord> batch;
+    const QDate today = QDate::currentDate();
+
+    for (int i = 0; i < sizes.payments; ++i) {
+        PaymentRecord record;
+        record.studentId = studentId(random.bounded(sizes.students));
+        record.paymentDate = today.addDays(-random.bounded(2 * 365));
+        record.amount = 100 * random.bounded(1, 60);
+        record.paymentType = paymentTypes[random.bounded(paymentTypes.size())];
+        record.notes = QString("第%1笔").arg(i + 1);
+        batch.append(record);
+
+        if ((batch.size() >= batchSize) || (i == sizes.payments - 1)) {
+            if (!repository.insertBatch(batch)) {
+                error = "写入缴费记录失败: " + repository.lastError();
+                return false;
+            }
+            batch.clear();
+        }
+    }
+    return true;
+}
+
+// 课程以今天为中心前后排开，每天的每个时间段最多一节课
+bool DatasetGenerator::generateSchedule(const Sizes& sizes)
+{
+    if (sizes.students <= 0) return true;
+
+    QRandomGenerator   random(seed + 2);
+    ScheduleRepository repository(db);
+    const int   slotCount = ScheduleRepository::slotLabels().size();
+    const int   days = (sizes.schedule + slotCount - 1) / slotCount;
+    const QDate first = QDate::currentDate().addDays(-days / 2);
+
+    for (int i = 0; i < sizes.schedule; ++i) {
+        const int slot = i % slotCount;
+
+        ScheduleEntry entry;
+        entry.date = first.addDays(i / slotCount);
+        entry.slot = slot;
+        entry.studentId = studentId(random.bounded(sizes.students));
+        entry.startTime = QTime::fromString(startTimes[slot], "HH:mm");
+
+        if (!repository.insert(entry)) {
+            error = "写入课程失败: " + repository.lastError();
+            return false;
+        }
+    }
+    return true;
+}
+
+bool DatasetGenerator::generateHonorWall(const Sizes& sizes)
+{
+    QRandomGenerator random(seed + 3);
+    HonorRepository  repository(db);
+
+    for (int i = 0; i < sizes.honorImages; ++i) {
+        HonorImage image;
+        image.imageData = makeImage(random, 800, 600);
+        image.description = QString("荣誉%1").arg(i + 1);
+        image.addedDate = QDate::currentDate().toString();
+
+        if (!repository.insert(image)) {
+            error = "写入荣誉墙失败: " + repository.lastError();
+            return false;
+        }
+    }
+    return true;
+}
+
+bool DatasetGenerator::generateUser()
+{
+    UserRepository repository(db);
+    UserRecord     user;
+
+    user.username = benchUsername;
+    user.passwordHash = PasswordHasher::hash(benchPassword);
+    user.role = UserRepository::adminRole;
+
+    if (!repository.insert(user)) {
+        error = "写入用户失败: " + repository.lastError();
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,48 @@
+#ifndef DATASETGENERATOR_H
+#define DATASETGENERATOR_H
+
+#include <QSqlDatabase>
+#include <QString>
+
+// 生成性能测试用的合成数据：学生（带照片）、缴费记录、课程安排、荣誉墙图片和登录用户。
+// 使用固定随机种子，同样的参数每次生成的数据完全相同，便于对比不同版本的测试结果
+class DatasetGenerator {
+public:
+
+    struct Sizes {
+        int students = 1000;
+        int payments = 20000;
+        int schedule = 3000;
+        int honorImages = 30;
+        int photoSize = 160; // 学生照片边长（像素）
+    };
+
+    // 登录验证测试使用的账号
+    static const QString benchUsername;
+    static const QString benchPassword;
+
+    explicit DatasetGenerator(const QSqlDatabase& database);
+
+    // 在一个事务中写入全部数据，要求表已存在且为空
+    bool    generate(const Sizes& sizes);
+
+    QString lastError() const {
+        return error;
+    }
+
+    // 生成数据中第 index 个学生的学号
+    static QString studentId(int index);
+
+private:
+
+    bool         generateStudents(const Sizes& sizes);
+    bool         generatePayments(const Sizes& sizes);
+    bool         generateSchedule(const Sizes& sizes);
+    bool         generateHonorWall(const Sizes& sizes);
+    bool         generateUser();
+
+    QSqlDatabase db;
+    QString error;
+};
+
+#endif // DATASETGENERATOR_H
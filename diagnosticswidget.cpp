@@ -0,0 +1,192 @@
+#include "diagnosticswidget.h"
+#include "databasemanager.h"
+#include "queryprofiler.h"
+#include <QHBoxLayout>
+#include <QHeaderView>
+#include <QLabel>
+#include <QPushButton>
+#include <QSpinBox>
+#include <QTableWidget>
+#include <QTextEdit>
+#include <QVBoxLayout>
+
+namespace {
+// 表格列
+enum Column {
+    ColMax,
+    ColAverage,
+    ColCalls,
+    ColRows,
+    ColCaller,
+    ColSql,
+    ColumnCount
+};
+
+// 维护记录表格列
+enum MaintenanceColumn {
+    ColTime,
+    ColTask,
+    ColElapsed,
+    ColResult,
+    MaintenanceColumnCount
+};
+
+QTableWidgetItem* numberItem(const QString& text)
+{
+    QTableWidgetItem *item = new QTableWidgetItem(text);
+
+    item->setTextAlignment(Qt::AlignRight | Qt::AlignVCenter);
+    return item;
+}
+}
+
+DiagnosticsWidget::DiagnosticsWidget(QWidget *parent)
+    : QWidget(parent)
+{
+    createUI();
+}
+
+void DiagnosticsWidget::createUI()
+{
+    topCountSpin = new QSpinBox(this);
+    topCountSpin->setRange(5, 100);
+    topCountSpin->setValue(10);
+
+    QPushButton *refreshBtn = new QPushButton("刷新", this);
+    QPushButton *clearBtn = new QPushButton("清空统计", this);
+
+    statementTable = new QTableWidget(0, ColumnCount, this);
+    statementTable->setHorizontalHeaderLabels(
+        QStringList() << "最大(ms)" << "平均(ms)" << "次数" << "行数" << "调用方" << "SQL");
+    statementTable->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    statementTable->setSelectionBehavior(QAbstractItemView::SelectRows);
+    statementTable->setSelectionMode(QAbstractItemView::SingleSelection);
+    statementTable->verticalHeader()->setVisible(false);
+    statementTable->horizontalHeader()->setStretchLastSection(true);
+
+    planEdit = new QTextEdit(this);
+    planEdit->setReadOnly(true);
+    planEdit->setPlaceholderText("选中一条语句查看 EXPLAIN QUERY PLAN");
+    planEdit->setMaximumHeight(120);
+
+    logPathLabel = new QLabel(this);
+    logPathLabel->setWordWrap(true);
+    logPathLabel->setTextInteractionFlags(Qt::TextSelectableByMouse);
+
+    maintenanceTable = new QTableWidget(0, MaintenanceColumnCount, this);
+    maintenanceTable->setHorizontalHeaderLabels(
+        QStringList() << "时间" << "维护任务" << "耗时(ms)" << "结果");
+    maintenanceTable->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    maintenanceTable->setSelectionBehavior(QAbstractItemView::SelectRows);
+    maintenanceTable->verticalHeader()->setVisible(false);
+    maintenanceTable->horizontalHeader()->setStretchLastSection(true);
+    maintenanceTable->setMaximumHeight(140);
+
+    QHBoxLayout *topLayout = new QHBoxLayout();
+    topLayout->addWidget(new QLabel("显示最慢的前", this));
+    topLayout->addWidget(topCountSpin);
+    topLayout->addWidget(new QLabel("条", this));
+    topLayout->addStretch();
+    topLayout->addWidget(refreshBtn);
+    topLayout->addWidget(clearBtn);
+
+    QVBoxLayout *layout = new QVBoxLayout(this);
+    layout->setContentsMargins(0, 0, 0, 0);
+    layout->addLayout(topLayout);
+    layout->addWidget(statementTable);
+    layout->addWidget(planEdit);
+    layout->addWidget(logPathLabel);
+    layout->addWidget(new QLabel("后台维护（程序空闲时执行）", this));
+    layout->addWidget(maintenanceTable);
+
+    connect(refreshBtn,   &QPushButton::clicked, this, &DiagnosticsWidget::refresh);
+    connect(clearBtn,     &QPushButton::clicked, this, &DiagnosticsWidget::clearStatistics);
+    connect(topCountSpin, QOverload<int>::of(&QSpinBox::valueChanged), this,
+            &DiagnosticsWidget::refresh);
+    connect(statementTable, &QTableWidget::itemSelectionChanged, this,
+            &DiagnosticsWidget::showQueryPlan);
+    connect(&DataBaseManager::instance(), &DataBaseManager::maintenanceFinished, this,
+            &DiagnosticsWidget::refreshMaintenance);
+}
+
+void DiagnosticsWidget::showEvent(QShowEvent *event)
+{
+    QWidget::showEvent(event);
+    refresh();
+}
+
+void DiagnosticsWidget::refresh()
+{
+    const QVector<StatementStats> statements =
+        QueryProfiler::instance().slowest(topCountSpin->value());
+
+    statementTable->setRowCount(0);
+    planEdit->clear();
+
+    for (const StatementStats& stats : statements) {
+        const int row = statementTable->rowCount();
+        statementTable->insertRow(row);
+
+        QTableWidgetItem *sqlItem = new QTableWidgetItem(stats.sql.simplified());
+        sqlItem->setToolTip(stats.sql);
+        sqlItem->setData(Qt::UserRole, stats.sql);
+        sqlItem->setData(Qt::UserRole + 1, stats.bindCount);
+
+        statementTable->setItem(row, ColMax,
+                                numberItem(QString::number(stats.maxNs / 1e6, 'f', 2)));
+        statementTable->setItem(row, ColAverage,
+                                numberItem(QString::number(stats.totalNs / 1e6 / stats.calls, 'f', 2)));
+        statementTable->setItem(row, ColCalls, numberItem(QString::number(stats.calls)));
+        statementTable->setItem(row, ColRows,  numberItem(QString::number(stats.lastRows)));
+        statementTable->setItem(row, ColCaller, new QTableWidgetItem(stats.caller));
+        statementTable->setItem(row, ColSql,   sqlItem);
+    }
+    statementTable->resizeColumnsToContents();
+
+    logPathLabel->setText(QString("慢查询阈值 %1 ms，日志：%2")
+                          .arg(QueryProfiler::instance().slowThresholdMs())
+                          .arg(QueryProfiler::instance().slowLogPath()));
+
+    refreshMaintenance();
+}
+
+void DiagnosticsWidget::showQueryPlan()
+{
+    QTableWidgetItem *item = statementTable->item(statementTable->currentRow(), ColSql);
+
+    if (!item) return;
+
+    // EXPLAIN 只生成查询计划，不会真正执行语句，写操作也可以安全查看
+    planEdit->setPlainText(QueryProfiler::explainQueryPlan(item->data(Qt::UserRole).toString(),
+                                                           item->data(Qt::UserRole + 1).toInt()));
+}
+
+void DiagnosticsWidget::clearStatistics()
+{
+    QueryProfiler::instance().clear();
+    refresh();
+}
+
+// 最近的记录排在最上面，失败的标红
+void DiagnosticsWidget::refreshMaintenance()
+{
+    const QVector<MaintenanceRecord> records = DataBaseManager::instance().maintenanceHistory();
+
+    maintenanceTable->setRowCount(records.size());
+
+    for (int i = 0; i < records.size(); ++i) {
+        const MaintenanceRecord& record = records[records.size() - 1 - i];
+
+        QTableWidgetItem *resultItem = new QTableWidgetItem(record.result.section('\n', 0, 0));
+        resultItem->setToolTip(record.result);
+
+        if (!record.ok) resultItem->setForeground(Qt::red);
+
+        maintenanceTable->setItem(i, ColTime,
+                                  new QTableWidgetItem(record.time.toString("MM-dd HH:mm:ss")));
+        maintenanceTable->setItem(i, ColTask,    new QTableWidgetItem(record.task));
+        maintenanceTable->setItem(i, ColElapsed, numberItem(QString::number(record.elapsedMs)));
+        maintenanceTable->setItem(i, ColResult,  resultItem);
+    }
+    maintenanceTable->resizeColumnsToContents();
+}
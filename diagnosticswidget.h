@@ -0,0 +1,42 @@
+#ifndef DIAGNOSTICSWIDGET_H
+#define DIAGNOSTICSWIDGET_H
+
+#include <QWidget>
+
+class QSpinBox;
+class QTableWidget;
+class QTextEdit;
+class QLabel;
+
+// 诊断面板：列出 QueryProfiler 记录的最慢语句，选中一行显示其查询计划；
+// 下方列出 DataBaseManager 后台维护的结果
+class DiagnosticsWidget : public QWidget {
+    Q_OBJECT
+
+public:
+
+    explicit DiagnosticsWidget(QWidget *parent = nullptr);
+
+public slots:
+
+    void refresh();
+
+protected:
+
+    void showEvent(QShowEvent *event) override;
+
+private:
+
+    void createUI();
+    void showQueryPlan();
+    void clearStatistics();
+    void refreshMaintenance();
+
+    QSpinBox *topCountSpin;
+    QTableWidget *statementTable;
+    QTextEdit *planEdit;
+    QLabel *logPathLabel;
+    QTableWidget *maintenanceTable;
+};
+
+#endif // DIAGNOSTICSWIDGET_H
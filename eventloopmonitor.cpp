@@ -0,0 +1,327 @@
+#include "eventloopmonitor.h"
+#include "settings.h"
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QTextStream>
+#include <QThread>
+#include <QTimer>
+#include <algorithm>
+
+namespace {
+const int heartbeatIntervalMs = 50;
+const int watchdogIntervalMs = 20;
+const int maxRecentStalls = 50;
+
+// 主线程当前所在的 ActivityScope，看门狗线程读取
+std::atomic<const char *> mainActivity{ nullptr };
+
+int bucketFor(qint64 ms)
+{
+    int bucket = 0;
+
+    while (ms > 0 && bucket < EventLoopMonitor::bucketCount - 1) {
+        ms >>= 1;
+        ++bucket;
+    }
+    return bucket;
+}
+
+qint64 currentMinute()
+{
+    return QDateTime::currentSecsSinceEpoch() / 60;
+}
+
+// JSON 数字统一按 double 存储
+qint64 toInt64(const QJsonValue& value)
+{
+    return qint64(value.toDouble());
+}
+}
+
+EventLoopMonitor& EventLoopMonitor::instance()
+{
+    static EventLoopMonitor instance;
+
+    return instance;
+}
+
+EventLoopMonitor::EventLoopMonitor(QObject *parent)
+    : QObject(parent)
+    , minuteSlots(windowMinutes)
+{}
+
+EventLoopMonitor::~EventLoopMonitor()
+{
+    stop();
+}
+
+EventLoopMonitor::ActivityScope::ActivityScope(const char *name)
+    : caller(name)
+    , previous(nullptr)
+    , mainThread(QCoreApplication::instance() &&
+                 QThread::currentThread() == QCoreApplication::instance()->thread())
+{
+    if (mainThread) previous = mainActivity.exchange(name);
+}
+
+EventLoopMonitor::ActivityScope::~ActivityScope()
+{
+    if (mainThread) mainActivity.store(previous);
+}
+
+void EventLoopMonitor::start()
+{
+    if (running) return;
+
+    clock.start();
+    lastBeatMs = 0;
+    beatMs = 0;
+    running = true;
+
+    heartbeatTimer = new QTimer(this);
+    heartbeatTimer->setTimerType(Qt::PreciseTimer);
+    heartbeatTimer->setInterval(heartbeatIntervalMs);
+    connect(heartbeatTimer, &QTimer::timeout, this, &EventLoopMonitor::heartbeat);
+    heartbeatTimer->start();
+
+    // 每分钟落盘一次，程序卡死或崩溃后仍能用 smscli stalls 查看
+    saveTimer = new QTimer(this);
+    saveTimer->setInterval(60 * 1000);
+    connect(saveTimer, &QTimer::timeout, this, [this]() {
+        dumpTo(defaultDumpPath());
+    });
+    saveTimer->start();
+
+    watchdogThread = QThread::create([this]() {
+        watchdog();
+    });
+    watchdogThread->start();
+
+    connect(qApp, &QCoreApplication::aboutToQuit, this, &EventLoopMonitor::stop);
+}
+
+void EventLoopMonitor::stop()
+{
+    if (!running) return;
+
+    running = false;
+    watchdogThread->wait();
+    delete watchdogThread;
+    watchdogThread = nullptr;
+
+    delete heartbeatTimer;
+    heartbeatTimer = nullptr;
+    delete saveTimer;
+    saveTimer = nullptr;
+
+    dumpTo(defaultDumpPath());
+}
+
+// 主线程：本次触发比预期晚了多少就是事件循环的延迟
+void EventLoopMonitor::heartbeat()
+{
+    const qint64 now = clock.elapsed();
+    const qint64 lag = qMax<qint64>(0, now - lastBeatMs - heartbeatIntervalMs);
+
+    lastBeatMs = now;
+    beatMs = now;
+
+    const char *activity = stallActivity.exchange(nullptr);
+
+    recordLatency(lag, activity ? QString::fromLatin1(activity) : QString("未知"));
+}
+
+// 看门狗线程：心跳停顿超过阈值时记下主线程正在执行的操作
+void EventLoopMonitor::watchdog()
+{
+    while (running) {
+        QThread::msleep(watchdogIntervalMs);
+
+        if (clock.elapsed() - beatMs < stallThresholdMs + heartbeatIntervalMs) continue;
+
+        const char *activity = mainActivity.load();
+        const char *expected = nullptr;
+
+        if (activity) stallActivity.compare_exchange_strong(expected, activity);
+    }
+}
+
+EventLoopMonitor::MinuteSlot& EventLoopMonitor::slotFor(qint64 minute)
+{
+    MinuteSlot& slot = minuteSlots[minute % windowMinutes];
+
+    if (slot.minute != minute) slot = MinuteSlot{ minute, {}, 0, 0 };
+    return slot;
+}
+
+void EventLoopMonitor::recordLatency(qint64 ms, const QString& activity)
+{
+    {
+        QMutexLocker locker(&mutex);
+        MinuteSlot & slot = slotFor(currentMinute());
+
+        slot.buckets[bucketFor(ms)]++;
+
+        if (ms < stallThresholdMs) return;
+
+        slot.stalls++;
+        slot.maxMs = qMax(slot.maxMs, ms);
+
+        ActivityStats& stats = activities[activity];
+        stats.stalls++;
+        stats.totalMs += ms;
+        stats.maxMs = qMax(stats.maxMs, ms);
+
+        recentStalls.append({ QDateTime::currentDateTime().toString("yyyy-MM-dd HH:mm:ss"),
+                              ms, activity });
+
+        if (recentStalls.size() > maxRecentStalls) recentStalls.removeFirst();
+    }
+    emit stallDetected(ms, activity);
+}
+
+QJsonObject EventLoopMonitor::snapshot() const
+{
+    QMutexLocker locker(&mutex);
+    const qint64 minute = currentMinute();
+    std::array<qint64, bucketCount> buckets{};
+    qint64 stalls = 0, maxMs = 0;
+
+    for (const MinuteSlot& slot : minuteSlots) {
+        if ((slot.minute < 0) || (slot.minute <= minute - windowMinutes)) continue;
+
+        for (int i = 0; i < bucketCount; ++i) buckets[i] += slot.buckets[i];
+        stalls += slot.stalls;
+        maxMs = qMax(maxMs, slot.maxMs);
+    }
+
+    QJsonArray histogram;
+
+    for (int i = 0; i < bucketCount; ++i) {
+        QJsonObject bucket;
+
+        // 最后一个桶没有上限
+        if (i < bucketCount - 1) bucket["lessThanMs"] = qint64(1) << i;
+        bucket["count"] = buckets[i];
+        histogram.append(bucket);
+    }
+
+    QVector<QPair<QString, ActivityStats> > sorted;
+
+    for (auto it = activities.cbegin(); it != activities.cend(); ++it) sorted.append({ it.key(), it.value() });
+    std::sort(sorted.begin(), sorted.end(), [](const auto& a, const auto& b) {
+        return a.second.totalMs > b.second.totalMs;
+    });
+
+    QJsonArray activityArray;
+
+    for (const auto& entry : sorted) {
+        QJsonObject object;
+        object["name"] = entry.first;
+        object["stalls"] = entry.second.stalls;
+        object["totalMs"] = entry.second.totalMs;
+        object["maxMs"] = entry.second.maxMs;
+        activityArray.append(object);
+    }
+
+    QJsonArray recent;
+
+    for (const Stall& stall : recentStalls) {
+        QJsonObject object;
+        object["when"] = stall.when;
+        object["ms"] = stall.ms;
+        object["activity"] = stall.activity;
+        recent.append(object);
+    }
+
+    QJsonObject report;
+    report["generated"] = QDateTime::currentDateTime().toString(Qt::ISODate);
+    report["thresholdMs"] = stallThresholdMs;
+    report["windowMinutes"] = windowMinutes;
+    report["stalls"] = stalls;
+    report["maxStallMs"] = maxMs;
+    report["histogram"] = histogram;
+    report["activities"] = activityArray;
+    report["recent"] = recent;
+    return report;
+}
+
+int EventLoopMonitor::recentStallCount() const
+{
+    return snapshot()["stalls"].toInt();
+}
+
+qint64 EventLoopMonitor::recentMaxStallMs() const
+{
+    return toInt64(snapshot()["maxStallMs"]);
+}
+
+QString EventLoopMonitor::defaultDumpPath()
+{
+    return QDir(Settings::logDirectory()).filePath("event_loop_stalls.json");
+}
+
+bool EventLoopMonitor::dumpTo(const QString& path) const
+{
+    QDir().mkpath(QFileInfo(path).absolutePath());
+
+    QFile file(path);
+
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) return false;
+
+    file.write(QJsonDocument(snapshot()).toJson());
+    return true;
+}
+
+QString EventLoopMonitor::formatReport(const QJsonObject& report)
+{
+    QString text;
+    QTextStream stream(&text);
+
+    stream << "生成时间: " << report["generated"].toString() << '\n'
+           << "最近 " << report["windowMinutes"].toInt() << " 分钟卡顿(>="
+           << report["thresholdMs"].toInt() << "ms): " << toInt64(report["stalls"])
+           << " 次，最长 " << toInt64(report["maxStallMs"]) << " ms\n\n";
+
+    stream << "事件循环延迟分布:\n";
+    qint64 lower = 0;
+
+    for (const QJsonValue& value : report["histogram"].toArray()) {
+        const QJsonObject bucket = value.toObject();
+        const qint64 count = toInt64(bucket["count"]);
+
+        if (bucket.contains("lessThanMs")) {
+            const qint64 upper = toInt64(bucket["lessThanMs"]);
+
+            if (count > 0) stream << QString("  %1 - %2 ms: ").arg(lower, 5).arg(upper, 5) << count << '\n';
+            lower = upper;
+        }
+        else if (count > 0) {
+            stream << QString("  >= %1 ms:      ").arg(lower, 5) << count << '\n';
+        }
+    }
+
+    stream << "\n按操作统计(自启动以来):\n";
+
+    for (const QJsonValue& value : report["activities"].toArray()) {
+        const QJsonObject activity = value.toObject();
+        stream << "  " << activity["name"].toString()
+               << "  次数=" << toInt64(activity["stalls"])
+               << "  合计=" << toInt64(activity["totalMs"]) << "ms"
+               << "  最长=" << toInt64(activity["maxMs"]) << "ms\n";
+    }
+
+    stream << "\n最近的卡顿:\n";
+
+    for (const QJsonValue& value : report["recent"].toArray()) {
+        const QJsonObject stall = value.toObject();
+        stream << "  " << stall["when"].toString() << "  " << toInt64(stall["ms"])
+               << "ms  " << stall["activity"].toString() << '\n';
+    }
+    return text;
+}
@@ -0,0 +1,115 @@
+#ifndef EVENTLOOPMONITOR_H
+#define EVENTLOOPMONITOR_H
+
+#include "queryprofiler.h"
+#include <QElapsedTimer>
+#include <QHash>
+#include <QJsonObject>
+#include <QMutex>
+#include <QObject>
+#include <QVector>
+#include <array>
+#include <atomic>
+
+class QThread;
+class QTimer;
+
+// 事件循环卡顿监测：主线程上的心跳定时器测量每次触发的延迟，写入按分钟滚动的直方图；
+// 看门狗线程在心跳停顿期间读取主线程当前的 ActivityScope，把卡顿归到具体的槽函数或页面。
+// 统计每分钟保存为 JSON 文件，界面状态栏和 smscli stalls 都读取这份数据
+class EventLoopMonitor : public QObject {
+    Q_OBJECT
+
+public:
+
+    // 延迟超过该值记为一次卡顿
+    static const int stallThresholdMs = 100;
+
+    // 直方图按 2 的幂分桶：<1ms, <2ms, <4ms, ... , 其余
+    static const int bucketCount = 16;
+
+    // 滚动窗口保留的分钟数
+    static const int windowMinutes = 60;
+
+    static EventLoopMonitor& instance();
+
+    // 标记主线程正在执行的操作，同时作为 QueryProfiler 的调用方；在其他线程中只设置后者
+    class ActivityScope {
+    public:
+
+        explicit ActivityScope(const char *name);
+        ~ActivityScope();
+
+    private:
+
+        QueryProfiler::CallerScope caller;
+        const char *previous;
+        bool mainThread;
+    };
+
+    // 必须在主线程中调用
+    void start();
+    void stop();
+
+    // 当前窗口内的统计
+    QJsonObject     snapshot() const;
+    int             recentStallCount() const;
+    qint64          recentMaxStallMs() const;
+
+    bool            dumpTo(const QString& path) const;
+    static QString  defaultDumpPath();
+
+    // 把 snapshot() 的结果格式化为文本，界面和命令行共用
+    static QString  formatReport(const QJsonObject& report);
+
+signals:
+
+    // 每次检测到卡顿后发出，参数为卡顿时长和归属的操作
+    void stallDetected(qint64 ms, const QString& activity);
+
+private:
+
+    explicit EventLoopMonitor(QObject *parent = nullptr);
+    ~EventLoopMonitor();
+
+    struct MinuteSlot {
+        qint64                           minute = -1;
+        std::array<qint64, bucketCount> buckets{};
+        qint64                           stalls = 0;
+        qint64                           maxMs = 0;
+    };
+
+    struct ActivityStats {
+        qint64 stalls = 0;
+        qint64 totalMs = 0;
+        qint64 maxMs = 0;
+    };
+
+    struct Stall {
+        QString when;
+        qint64  ms;
+        QString activity;
+    };
+
+    void heartbeat();
+    void watchdog();
+    void recordLatency(qint64 ms, const QString& activity);
+    MinuteSlot& slotFor(qint64 minute);
+
+    QTimer *heartbeatTimer = nullptr;
+    QTimer *saveTimer = nullptr;
+    QThread *watchdogThread = nullptr;
+    QElapsedTimer clock;
+    qint64 lastBeatMs = 0;
+
+    std::atomic<qint64> beatMs{ 0 };
+    std::atomic<bool> running{ false };
+    std::atomic<const char *> stallActivity{ nullptr };
+
+    mutable QMutex mutex;
+    QVector<MinuteSlot> minuteSlots;
+    QHash<QString, ActivityStats> activities; // 自启动以来的累计值
+    QVector<Stall> recentStalls;
+};
+
+#endif // EVENTLOOPMONITOR_H
@@ -0,0 +1,63 @@
+#include "exportdialog.h"
+#include <QFileDialog>
+#include <QFileInfo>
+#include <QMessageBox>
+#include <QProgressDialog>
+#include <QStandardPaths>
+
+void execExportDialog(QWidget *parent, DataExporter::Kind kind,
+                      const ExportFilter& filter)
+{
+    static const QStringList baseNames = { "students", "payments", "schedule" };
+    const QString csvFilter = "CSV 文件 (*.csv)";
+    const QString jsonFilter = "JSON 文件 (*.json)";
+    QString selectedFilter = csvFilter;
+
+    QString filePath = QFileDialog::getSaveFileName(
+        parent, "导出",
+        QStandardPaths::writableLocation(QStandardPaths::DocumentsLocation) +
+        '/' + baseNames.value(kind) + ".csv",
+        csvFilter + ";;" + jsonFilter,
+        &selectedFilter);
+
+    if (filePath.isEmpty()) return;
+
+    DataExporter exporter;
+    const DataExporter::Format format =
+        (selectedFilter == jsonFilter || filePath.endsWith(".json", Qt::CaseInsensitive))
+        ? DataExporter::Json : DataExporter::Csv;
+
+    // 学生照片可选导出到导出文件旁的 <文件名>_photos 目录
+    if ((kind == DataExporter::Students) &&
+        (QMessageBox::question(parent, "导出", "是否同时导出学生照片？") == QMessageBox::Yes)) {
+        QFileInfo info(filePath);
+        exporter.setPhotoDirectory(info.absolutePath() + '/' +
+                                   info.completeBaseName() + "_photos");
+    }
+
+    QProgressDialog progressDlg("正在导出...", "取消", 0, 0, parent);
+    progressDlg.setWindowTitle("导出");
+    progressDlg.setWindowModality(Qt::WindowModal);
+    progressDlg.setMinimumDuration(300);
+
+    QObject::connect(&exporter, &DataExporter::progress, &progressDlg,
+                     [&progressDlg](qint64 rows) {
+        progressDlg.setLabelText(QString("已导出 %1 行").arg(rows));
+        progressDlg.setValue(0);
+    });
+    QObject::connect(&progressDlg, &QProgressDialog::canceled, &exporter,
+                     &DataExporter::cancel);
+
+    bool ok = exporter.exportTo(kind, format, filePath, filter);
+    progressDlg.close();
+
+    if (ok) {
+        QMessageBox::information(parent, "导出",
+                                 QString("已导出 %1 行到\n%2")
+                                 .arg(exporter.exportedRows())
+                                 .arg(filePath));
+    }
+    else {
+        QMessageBox::warning(parent, "导出", exporter.lastError());
+    }
+}
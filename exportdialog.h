@@ -0,0 +1,12 @@
+#ifndef EXPORTDIALOG_H
+#define EXPORTDIALOG_H
+
+#include "dataexporter.h"
+
+class QWidget;
+
+// 选择导出文件和格式并执行导出，filter 为调用页面当前的筛选条件
+void execExportDialog(QWidget *parent, DataExporter::Kind kind,
+                      const ExportFilter& filter = ExportFilter());
+
+#endif // EXPORTDIALOG_H
@@ -10,26 +10,38 @@
 #include <QPushButton>
 #include <QStringList>
 #include <QTableWidget>
-#include <QSqlQuery>
 #include <QHeaderView>
 #include <QDialog>
 #include <QFormLayout>
 #include <QLineEdit>
 #include <QDialogButtonBox>
-#include <QSqlError>
 #include <QPieSeries>
 #include <QPieSlice>
 #include <QLineSeries>
 #include <QDateTimeAxis>
 #include <QValueAxis>
 #include <QMessageBox>
+#include <QSignalBlocker>
+#include "importdialog.h"
+#include "exportdialog.h"
+#include "paymentrepository.h"
+#include "studentrepository.h"
+#include "databasemanager.h"
+#include "eventloopmonitor.h"
+#include "startuptrace.h"
 FinancialWidget::FinancialWidget(QWidget *parent)
     : QWidget(parent)
     , ui(new Ui::FinancialWidget)
 {
+    StartupTrace::Span span(Q_FUNC_INFO);
+
     ui->setupUi(this);
     setupUI();
     populateStudentComboBox();
+
+    // 切换数据库后重新读取学生列表，随后按所选学生重新读取缴费记录
+    connect(&DataBaseManager::instance(), &DataBaseManager::databaseSwitched, this,
+            &FinancialWidget::populateStudentComboBox);
 }
 
 FinancialWidget::~FinancialWidget()
@@ -66,9 +78,13 @@ void FinancialWidget::setupUI()
     addButton = new QPushButton("添加");
     deleteButton = new QPushButton("删除");
     editButton = new QPushButton("修改");
+    importButton = new QPushButton("导入");
+    exportButton = new QPushButton("导出");
     topLayout->addWidget(addButton);
     topLayout->addWidget(deleteButton);
     topLayout->addWidget(editButton);
+    topLayout->addWidget(importButton);
+    topLayout->addWidget(exportButton);
     topLayout->addStretch();
 
     // =============== 主内容布局 ===============
@@ -94,6 +110,10 @@ void FinancialWidget::setupUI()
             &FinancialWidget::deleteRecord);
     connect(editButton,   &QPushButton::clicked, this,
             &FinancialWidget::editRecord);
+    connect(importButton, &QPushButton::clicked, this,
+            &FinancialWidget::importRecords);
+    connect(exportButton, &QPushButton::clicked, this,
+            &FinancialWidget::exportRecords);
     connect(studentComboBox,
             QOverload<int>::of(&QComboBox::currentIndexChanged),
             this, &FinancialWidget::loadFinancialRecords);
@@ -105,31 +125,26 @@ void FinancialWidget::setupUI()
 
 void FinancialWidget::loadFinancialRecords()
 {
+    EventLoopMonitor::ActivityScope activity(Q_FUNC_INFO);
+
     tableWidget->setRowCount(0);
 
-    QString studentId = studentComboBox->currentData().toString();
-    QDate   startDate = startDateEdit->date();
-    QDate   endDate = endDateEdit->date();
-
-    QString queryStr = QString(
-        "SELECT fr.id, s.name, fr.payment_date, fr.amount, fr.payment_type, fr.notes "
-        "FROM financialRecords fr "
-        "JOIN studentInfo s ON fr.student_id = s.id "
-        "WHERE fr.payment_date BETWEEN '%1' AND '%2' %3"
-        ).arg(startDate.toString("yyyy-MM-dd"),
-              endDate.toString("yyyy-MM-dd"),
-              (studentId !=
-               "-1") ? QString("AND fr.student_id = '%1'").arg(studentId) : "");
-
-    QSqlQuery query(queryStr);
-
-    while (query.next()) {
-        int row = tableWidget->rowCount();
-        tableWidget->insertRow(row);
-
-        for (int col = 0; col < 6; ++col) {
-            QTableWidgetItem *item = new QTableWidgetItem(query.value(
-                                                              col).toString());
+    PaymentRepository repository;
+    const QVector<PaymentRecord> records = repository.load(currentFilter());
+
+    tableWidget->setRowCount(records.size());
+
+    for (int row = 0; row < records.size(); ++row) {
+        const PaymentRecord& record = records.at(row);
+        const QStringList    texts = { QString::number(record.id),
+                                       record.studentName,
+                                       record.paymentDate.toString("yyyy-MM-dd"),
+                                       QString::number(record.amount),
+                                       record.paymentType,
+                                       record.notes };
+
+        for (int col = 0; col < texts.size(); ++col) {
+            QTableWidgetItem *item = new QTableWidgetItem(texts.at(col));
             item->setTextAlignment(Qt::AlignCenter);
             tableWidget->setItem(row, col, item);
         }
@@ -141,22 +156,63 @@ void FinancialWidget::loadFinancialRecords()
     updatePieChart(); // 更新右侧饼图
 }
 
+void FinancialWidget::showPayment(const QString& studentId, int id, const QDate& date)
+{
+    {
+        // 三个筛选控件一起修改，只重新加载一次
+        const QSignalBlocker studentBlocker(studentComboBox);
+        const QSignalBlocker startBlocker(startDateEdit);
+        const QSignalBlocker endBlocker(endDateEdit);
+
+        const int index = studentComboBox->findData(studentId);
+        studentComboBox->setCurrentIndex(index >= 0 ? index : 0);
+
+        if (date.isValid() && (date < startDateEdit->date())) startDateEdit->setDate(date);
+
+        if (date.isValid() && (date > endDateEdit->date())) endDateEdit->setDate(date);
+    }
+    loadFinancialRecords();
+
+    for (int row = 0; row < tableWidget->rowCount(); ++row) {
+        QTableWidgetItem *item = tableWidget->item(row, 0);
+
+        if (item && (item->text().toInt() == id)) {
+            tableWidget->selectRow(row);
+            tableWidget->scrollToItem(item, QAbstractItemView::PositionAtCenter);
+            return;
+        }
+    }
+}
+
+// 当前界面上的筛选条件：学生和日期范围
+PaymentFilter FinancialWidget::currentFilter() const
+{
+    PaymentFilter filter;
+
+    filter.from = startDateEdit->date();
+    filter.to = endDateEdit->date();
+    filter.studentId = studentComboBox->currentData().toString();
+    return filter;
+}
+
 void FinancialWidget::populateStudentComboBox()
 {
+    EventLoopMonitor::ActivityScope activity(Q_FUNC_INFO);
+
     studentComboBox->clear();
     studentComboBox->addItem("所有学生", QVariant("-1")); // "-1" 表示所有学生
 
-    QSqlQuery query("SELECT id, name FROM studentInfo");
+    StudentRepository repository;
 
-    while (query.next()) {
-        QString id = query.value(0).toString(); // id 是字符串类型
-        QString name = query.value(1).toString();
-        studentComboBox->addItem(name, QVariant(id));
+    for (const StudentName& student : repository.loadNames()) {
+        studentComboBox->addItem(student.name, QVariant(student.id)); // id 是字符串类型
     }
 }
 
 void FinancialWidget::addRecord()
 {
+    EventLoopMonitor::ActivityScope activity(Q_FUNC_INFO);
+
     QDialog dialog(this);
 
     dialog.setWindowTitle("添加缴费记录");
@@ -164,12 +220,10 @@ void FinancialWidget::addRecord()
 
     // 学生名称下拉菜单
     QComboBox *studentNameComboBox = new QComboBox(&dialog);
-    QSqlQuery  query("SELECT id, name FROM studentInfo");
+    StudentRepository studentRepository;
 
-    while (query.next()) {
-        QString id = query.value(0).toString();
-        QString name = query.value(1).toString();
-        studentNameComboBox->addItem(name, QVariant(id)); // 将学生ID与名称关联
+    for (const StudentName& student : studentRepository.loadNames()) {
+        studentNameComboBox->addItem(student.name, QVariant(student.id)); // 将学生ID与名称关联
     }
     QDateEdit *paymentDateEdit = new QDateEdit(&dialog);
     paymentDateEdit->setDate(QDate::currentDate());       // 设置默认值为当前日期
@@ -201,58 +255,39 @@ void FinancialWidget::addRecord()
                      &QDialog::reject);
 
     if (dialog.exec() == QDialog::Accepted) {
-        QString studentId = studentNameComboBox->currentData().toString();
-        QString paymentDate = paymentDateEdit->date().toString("yyyy-MM-dd");
-        double  amount = amountEdit->text().toDouble();
-        QString feeType = feeTypeEdit->text();
-        QString remark = remarkEdit->text();
-
-        // 准备SQL查询
-        QSqlQuery query;
-        query.prepare("INSERT INTO financialRecords (student_id, payment_date, amount, payment_type, notes) "
-                      "VALUES (:student_id, :payment_date, :amount, :payment_type, :notes)");
-        query.bindValue(":student_id",     studentId); // 绑定学生ID
-        query.bindValue(":payment_date", paymentDate);
-        query.bindValue(":amount",            amount);
-        query.bindValue(":payment_type",     feeType);
-        query.bindValue(":notes",             remark);
-
-        // 执行SQL查询
-        if (query.exec()) {
+        PaymentRecord record;
+        record.studentId = studentNameComboBox->currentData().toString(); // 学生ID
+        record.paymentDate = paymentDateEdit->date();
+        record.amount = amountEdit->text().toDouble();
+        record.paymentType = feeTypeEdit->text();
+        record.notes = remarkEdit->text();
+
+        PaymentRepository repository;
+
+        if (repository.insert(record)) {
             qDebug() << "记录添加成功！";
             loadFinancialRecords(); // 刷新表格
         }
-        else qDebug() << "添加记录失败：" << query.lastError().text();
+        else qDebug() << "添加记录失败：" << repository.lastError();
     }
 }
 
 void FinancialWidget::updatePieChart()
 {
-    QString studentId = studentComboBox->currentData().toString();
-    QDate   startDate = startDateEdit->date();
-    QDate   endDate = endDateEdit->date();
-
-    QString queryStr = QString(
-        "SELECT payment_type, SUM(amount) "
-        "FROM financialRecords "
-        "WHERE payment_date BETWEEN '%1' AND '%2' %3 "
-        "GROUP BY payment_type")
-                       .arg(startDate.toString("yyyy-MM-dd"))
-                       .arg(endDate.toString("yyyy-MM-dd"))
-                       .arg(studentId != "-1" ? QString(
-                                "AND student_id = '%1'").arg(studentId) : "");
-
-    // 执行SQL查询获取统计数据
-    QSqlQuery query(queryStr);
+    EventLoopMonitor::ActivityScope activity(Q_FUNC_INFO);
+
+    // 按支付类型汇总当前筛选范围内的金额
+    PaymentRepository repository;
+    const QVector<PaymentSummary> totals = repository.totalsByType(currentFilter());
 
     // 创建饼图数据系列
     QPieSeries *series = new QPieSeries();
 
-    // 遍历查询结果，为每个数据项创建饼图切片
-    while (query.next()) {
+    // 遍历汇总结果，为每个数据项创建饼图切片
+    for (const PaymentSummary& total : totals) {
         // 获取分类名称和对应数值
-        QString type = query.value(0).toString();  // 第一列：分类名称
-        qreal   value = query.value(1).toDouble(); // 第二列：数值
+        QString type = total.key;   // 分类名称
+        qreal   value = total.total; // 数值
 
         // 仅添加数值大于0的数据（排除无效数据）
         if (value > 0) {
@@ -294,7 +329,10 @@ void FinancialWidget::updatePieChart()
 }
 
 void FinancialWidget::updateChart()
-{ // ================== 1. 获取并验证日期范围 ==================
+{
+    EventLoopMonitor::ActivityScope activity(Q_FUNC_INFO);
+
+    // ================== 1. 获取并验证日期范围 ==================
     QDate startDate = startDateEdit->date();
     QDate endDate = endDateEdit->date();
 
@@ -304,38 +342,13 @@ void FinancialWidget::updateChart()
         endDateEdit->setDate(endDate);
     }
 
-    // ================== 2. 构建安全SQL查询 ==================
-    QString studentId = studentComboBox->currentData().toString();
-    QString queryStr = QString("SELECT DATE(payment_date) AS day, SUM(amount) AS total "
-                               "FROM financialRecords "
-                               "WHERE payment_date BETWEEN :startDate AND :endDate "
-                               "%1 GROUP BY day ORDER BY day"
-                               ).arg(
-        studentId != "-1" ? "AND student_id = :studentId" : "");
-    QSqlQuery query;
-    query.prepare(queryStr);
-    query.bindValue(":startDate", startDate.toString("yyyy-MM-dd"));
-    query.bindValue(":endDate",     endDate.toString("yyyy-MM-dd"));
-
-    if (studentId != "-1") query.bindValue(":studentId", studentId);
+    // ================== 2. 按天汇总金额 ==================
+    PaymentRepository   repository;
+    QMap<QDate, double> dayData = repository.dailyTotals(currentFilter());
 
-    if (!query.exec()) qCritical() << "[SQL错误]" << query.lastError().text();
-
-    // ================== 3. 处理查询数据 ==================
-    QMap<QDate, qreal> dayData;
-    qreal maxAmount = 0;
-
-    while (query.next()) {
-        QDate day = QDate::fromString(query.value(0).toString(), "yyyy-MM-dd");
-
-        if (!day.isValid()) continue;
-        qreal amount = query.value(1).toDouble();
-        dayData[day] = amount;
-
-        if (amount > maxAmount) maxAmount = amount;
-    }
+    if (!repository.lastError().isEmpty()) qCritical() << "[SQL错误]" << repository.lastError();
 
-    // ================== 4. 创建图表系列 ==================
+    // ================== 3. 创建图表系列 ==================
     QLineSeries *series = new QLineSeries();
     series->setName("销售额");
     QPen pen(Qt::blue);
@@ -348,7 +361,7 @@ void FinancialWidget::updateChart()
         currentDate = currentDate.addDays(1);
     }
 
-    // ================== 5. 配置坐标轴 ==================
+    // ================== 4. 配置坐标轴 ==================
     QChart *chart = new QChart();
     chart->addSeries(series);
     QDateTimeAxis *axisX = new QDateTimeAxis();
@@ -363,7 +376,7 @@ void FinancialWidget::updateChart()
     chart->addAxis(axisY, Qt::AlignLeft);
     series->attachAxis(axisY);
 
-    // ================== 6. 应用图表 ==================
+    // ================== 5. 应用图表 ==================
     if (chartView->chart()) delete chartView->chart();
     chartView->setChart(chart);
     chartView->setRenderHint(QPainter::Antialiasing);
@@ -372,6 +385,8 @@ void FinancialWidget::updateChart()
 
 void FinancialWidget::editRecord()
 {
+    EventLoopMonitor::ActivityScope activity(Q_FUNC_INFO);
+
     int currentRow = tableWidget->currentRow();
 
     if (currentRow < 0) {
@@ -392,12 +407,10 @@ void FinancialWidget::editRecord()
 
     // 学生名称下拉菜单
     QComboBox *studentNameComboBox = new QComboBox(&dialog);
-    QSqlQuery  query("SELECT id, name FROM studentInfo");
+    StudentRepository studentRepository;
 
-    while (query.next()) {
-        QString id = query.value(0).toString(); // id 是字符串类型
-        QString name = query.value(1).toString();
-        studentNameComboBox->addItem(name, QVariant(id));
+    for (const StudentName& student : studentRepository.loadNames()) {
+        studentNameComboBox->addItem(student.name, QVariant(student.id)); // id 是字符串类型
     }
     studentNameComboBox->setCurrentText(studentName); // 设置当前学生名称
     QLineEdit *paymentDateEdit = new QLineEdit(paymentDate, &dialog);
@@ -425,35 +438,33 @@ void FinancialWidget::editRecord()
                      &QDialog::reject);
 
     if (dialog.exec() == QDialog::Accepted) {
-        QString studentId = studentNameComboBox->currentData().toString(); // studentId
-                                                                           // 是字符串类型
-        QString paymentDate = paymentDateEdit->text();
-        double  amount = amountEdit->text().toDouble();
-        QString feeType = feeTypeEdit->text();
-        QString remark = remarkEdit->text();
-
-        // 准备 SQL 查询
-        QSqlQuery query;
-        query.prepare("UPDATE financialRecords SET student_id = :student_id, payment_date = :payment_date, "
-                      "amount = :amount, payment_type = :payment_type, notes = :notes WHERE id = :id");
-        query.bindValue(":student_id",     studentId); // studentId 是字符串类型
-        query.bindValue(":payment_date", paymentDate);
-        query.bindValue(":amount",            amount);
-        query.bindValue(":payment_type",     feeType);
-        query.bindValue(":notes",             remark);
-        query.bindValue(":id",                    id);
-
-        // 执行 SQL 查询
-        if (query.exec()) {
+        PaymentRecord record;
+        record.id = id.toInt();
+        record.studentId = studentNameComboBox->currentData().toString(); // studentId 是字符串类型
+        record.paymentDate = QDate::fromString(paymentDateEdit->text(), "yyyy-MM-dd");
+        record.amount = amountEdit->text().toDouble();
+        record.paymentType = feeTypeEdit->text();
+        record.notes = remarkEdit->text();
+
+        if (!record.paymentDate.isValid()) {
+            QMessageBox::warning(this, "警告", "缴费日期格式应为 yyyy-MM-dd！");
+            return;
+        }
+
+        PaymentRepository repository;
+
+        if (repository.update(record)) {
             qDebug() << "记录修改成功！";
             loadFinancialRecords(); // 刷新表格
         }
-        else qDebug() << "修改记录失败：" << query.lastError().text();
+        else qDebug() << "修改记录失败：" << repository.lastError();
     }
 }
 
 void FinancialWidget::deleteRecord()
 {
+    EventLoopMonitor::ActivityScope activity(Q_FUNC_INFO);
+
     int currentRow = tableWidget->currentRow();
 
     if (currentRow < 0) {
@@ -481,11 +492,9 @@ void FinancialWidget::deleteRecord()
 
     if (confirmBox.clickedButton() == yesButton) {
         // 用户点击了“确定”
-        QSqlQuery query;
-        query.prepare("DELETE FROM financialRecords WHERE id = :id");
-        query.bindValue(":id", id);
+        PaymentRepository repository;
 
-        if (query.exec()) {
+        if (repository.remove(id)) {
             qDebug() << "记录删除成功！";
             loadFinancialRecords(); // 刷新表格
         }
@@ -494,3 +503,15 @@ void FinancialWidget::deleteRecord()
         }
     }
 }
+
+// 从 CSV 文件批量导入缴费记录
+void FinancialWidget::importRecords()
+{
+    if (execImportDialog(this, DataImporter::Payments)) loadFinancialRecords();
+}
+
+// 按当前筛选条件（学生、日期范围）导出缴费记录
+void FinancialWidget::exportRecords()
+{
+    execExportDialog(this, DataExporter::Payments, currentFilter());
+}
@@ -2,6 +2,7 @@
 #define FINANCIALWIDGET_H
 
 #include <QWidget>
+#include "paymentrepository.h"
 
 namespace Ui {
 class FinancialWidget;
@@ -25,22 +26,30 @@ public:
     explicit FinancialWidget(QWidget *parent = nullptr);
     ~FinancialWidget();
 
+    // 全局搜索结果：切换到该学生，日期范围不包含 date 时放宽，然后选中 id 对应的记录
+    void showPayment(const QString& studentId, int id, const QDate& date);
+
 private:
 
     void setupUI();
     void loadFinancialRecords();
+    PaymentFilter currentFilter() const;
     void populateStudentComboBox();
     void addRecord();
     void updatePieChart();
     void updateChart();
     void editRecord();
     void deleteRecord();
+    void importRecords();
+    void exportRecords();
     QChartView *pieChartView;
     QTableWidget *tableWidget;
     QComboBox *studentComboBox;
     QPushButton *addButton;
     QPushButton *deleteButton;
     QPushButton *editButton;
+    QPushButton *importButton;
+    QPushButton *exportButton;
     QChartView *chartView;
     QDateEdit *startDateEdit;
     QDateEdit *endDateEdit;
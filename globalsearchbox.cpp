@@ -0,0 +1,99 @@
+#include "globalsearchbox.h"
+#include "databasemanager.h"
+#include "session.h"
+#include <QAbstractItemView>
+#include <QCompleter>
+#include <QStandardItemModel>
+#include <QTimer>
+
+namespace {
+// 每次最多列出的结果数
+const int maxHits = 20;
+
+bool permitted(SearchHit::Kind kind)
+{
+    switch (kind) {
+    case SearchHit::Student: return Session::instance().has(Session::StudentPage);
+    case SearchHit::Payment: return Session::instance().has(Session::FinancePage);
+    case SearchHit::Honor:   return Session::instance().has(Session::HonorPage);
+    }
+    return false;
+}
+
+QString describe(const SearchHit& hit)
+{
+    switch (hit.kind) {
+    case SearchHit::Student:
+        return QString("学生  %1（%2）  %3").arg(hit.title, hit.ref, hit.snippet);
+    case SearchHit::Payment:
+        return QString("缴费  %1 %2  %3").arg(hit.title, hit.date.toString("yyyy-MM-dd"), hit.snippet);
+    case SearchHit::Honor:
+        return QString("荣誉  %1  %2").arg(hit.date.toString("yyyy-MM-dd"), hit.snippet);
+    }
+    return hit.snippet;
+}
+}
+
+GlobalSearchBox::GlobalSearchBox(QWidget *parent)
+    : QLineEdit(parent)
+    , debounce(new QTimer(this))
+    , completer(new QCompleter(this))
+    , model(new QStandardItemModel(this))
+{
+    setPlaceholderText("搜索学生、缴费备注、荣誉描述");
+    setClearButtonEnabled(true);
+
+    debounce->setSingleShot(true);
+    debounce->setInterval(debounceMs);
+
+    // 只用 QCompleter 的下拉列表和键盘导航，不设置到输入框上，选中结果时不改写输入的文字
+    completer->setModel(model);
+    completer->setCompletionMode(QCompleter::UnfilteredPopupCompletion);
+    completer->setMaxVisibleItems(12);
+    completer->setWidget(this);
+
+    connect(this,     &QLineEdit::textEdited, debounce, qOverload<>(&QTimer::start));
+    connect(debounce, &QTimer::timeout, this, &GlobalSearchBox::search);
+    connect(this,     &QLineEdit::returnPressed, this, &GlobalSearchBox::search);
+    connect(completer, qOverload<const QModelIndex&>(&QCompleter::activated), this,
+            &GlobalSearchBox::activate);
+    connect(&DataBaseManager::instance(), &DataBaseManager::databaseSwitched, this, [this] {
+        hits.clear();
+        model->clear();
+    });
+}
+
+void GlobalSearchBox::search()
+{
+    debounce->stop();
+    hits.clear();
+    model->clear();
+
+    QVector<SearchHit::Kind> kinds;
+
+    for (SearchHit::Kind kind : { SearchHit::Student, SearchHit::Payment, SearchHit::Honor }) {
+        if (permitted(kind)) kinds << kind;
+    }
+
+    SearchRepository repository;
+
+    for (const SearchHit& hit : repository.search(text(), kinds, maxHits)) {
+        QStandardItem *item = new QStandardItem(describe(hit));
+        item->setData(hits.size(), Qt::UserRole);
+        model->appendRow(item);
+        hits.append(hit);
+    }
+
+    if (hits.isEmpty()) {
+        completer->popup()->hide();
+        return;
+    }
+    completer->complete(rect());
+}
+
+void GlobalSearchBox::activate(const QModelIndex& index)
+{
+    const int row = index.data(Qt::UserRole).toInt();
+
+    if ((row >= 0) && (row < hits.size())) emit hitActivated(hits[row]);
+}
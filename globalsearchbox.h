@@ -0,0 +1,38 @@
+#ifndef GLOBALSEARCHBOX_H
+#define GLOBALSEARCHBOX_H
+
+#include <QLineEdit>
+#include "searchrepository.h"
+
+class QCompleter;
+class QStandardItemModel;
+class QTimer;
+
+// 主窗口顶部的全局搜索框：输入停顿后在 searchIndex 中搜索，结果列在下拉列表中，
+// 只列出当前用户有权限查看的页面的记录。选中一条后发出 hitActivated()
+class GlobalSearchBox : public QLineEdit {
+    Q_OBJECT
+
+public:
+
+    explicit GlobalSearchBox(QWidget *parent = nullptr);
+
+    // 输入停顿多久后开始搜索（毫秒）
+    static constexpr int debounceMs = 120;
+
+signals:
+
+    void hitActivated(const SearchHit& hit);
+
+private:
+
+    void search();
+    void activate(const QModelIndex& index);
+
+    QTimer *debounce;
+    QCompleter *completer;
+    QStandardItemModel *model;
+    QVector<SearchHit> hits;
+};
+
+#endif // GLOBALSEARCHBOX_H
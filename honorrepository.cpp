@@ -0,0 +1,52 @@
+#include "honorrepository.h"
+
+QVector<HonorImage> HonorRepository::loadAll()
+{
+    QVector<HonorImage> images;
+    QSqlQuery query = prepare(
+        "SELECT id, image_data, description, added_date FROM honorWall");
+
+    if (!exec(query)) return images;
+
+    while (next(query)) {
+        HonorImage image;
+        image.id = query.value(0).toInt();
+        image.imageData = query.value(1).toByteArray();
+        image.description = query.value(2).toString();
+        image.addedDate = query.value(3).toString();
+        images.append(image);
+    }
+    return images;
+}
+
+bool HonorRepository::insert(HonorImage& image)
+{
+    QSqlQuery query = prepare(
+        "INSERT INTO honorWall (image_data, description,added_date) VALUES(:image_data, :description,:added_date)");
+
+    query.bindValue(":image_data",  image.imageData);
+    query.bindValue(":description", image.description);
+    query.bindValue(":added_date",  image.addedDate);
+
+    if (!exec(query)) return false;
+
+    image.id = query.lastInsertId().toInt();
+    return true;
+}
+
+bool HonorRepository::updateImage(int id, const QByteArray& imageData)
+{
+    QSqlQuery query = prepare("UPDATE honorWall SET image_data = :image_data WHERE id = :id");
+
+    query.bindValue(":image_data", imageData);
+    query.bindValue(":id",         id);
+    return exec(query);
+}
+
+bool HonorRepository::remove(int id)
+{
+    QSqlQuery query = prepare("DELETE FROM honorWall WHERE id = :id");
+
+    query.bindValue(":id", id);
+    return exec(query);
+}
@@ -0,0 +1,29 @@
+#ifndef HONORREPOSITORY_H
+#define HONORREPOSITORY_H
+
+#include "repository.h"
+#include <QByteArray>
+#include <QVector>
+
+// honorWall 表的一行
+struct HonorImage {
+    int        id = 0;
+    QByteArray imageData;
+    QString    description;
+    QString    addedDate;
+};
+
+class HonorRepository : public Repository {
+public:
+
+    using Repository::Repository;
+
+    QVector<HonorImage> loadAll();
+
+    // 插入成功后 image.id 为新记录的 id
+    bool                insert(HonorImage& image);
+    bool                updateImage(int id, const QByteArray& imageData);
+    bool                remove(int id);
+};
+
+#endif // HONORREPOSITORY_H
@@ -4,18 +4,25 @@
 #include <QPushButton>
 #include <QScrollArea>
 #include <QHBoxLayout>
-#include <QSqlQuery>
 #include <QMessageBox>
 #include <QFileDialog>
 #include <QBuffer>
-#include <QSqlError>
+#include "databasemanager.h"
+#include "honorrepository.h"
+#include "eventloopmonitor.h"
+#include "startuptrace.h"
 HonorWallWidget::HonorWallWidget(QWidget *parent)
     : QWidget(parent)
     , ui(new Ui::HonorWallWidget)
 {
+    StartupTrace::Span span(Q_FUNC_INFO);
+
     ui->setupUi(this);
     setupUI();
     loadImagesFromDatabase();
+
+    connect(&DataBaseManager::instance(), &DataBaseManager::databaseSwitched, this,
+            &HonorWallWidget::loadImagesFromDatabase);
 }
 
 HonorWallWidget::~HonorWallWidget()
@@ -75,23 +82,24 @@ void HonorWallWidget::setupUI()
 
 void HonorWallWidget::loadImagesFromDatabase()
 {
-    // 清空布局中的所有内容
+    EventLoopMonitor::ActivityScope activity(Q_FUNC_INFO);
+
+    // 清空布局中的所有内容，图片控件一并删除
     QLayoutItem *item;
 
     while ((item = gridLayout->takeAt(0)) != nullptr) {
+        delete item->widget();
         delete item; // 删除布局项
     }
+    selectedLabel = nullptr;
 
     // 从数据库中加载图片
-    QSqlQuery query("SELECT id, image_data FROM honorWall");
-
-    while (query.next()) {
-        int id = query.value(0).toInt();
-        QByteArray imageData = query.value(1).toByteArray();
+    HonorRepository repository;
 
+    for (const HonorImage& image : repository.loadAll()) {
         // 将二进制数据转换为 QPixmap
         QPixmap pixmap;
-        pixmap.loadFromData(imageData);
+        pixmap.loadFromData(image.imageData);
 
         if (!pixmap.isNull()) {
             // 将图片显示在界面上
@@ -102,8 +110,7 @@ void HonorWallWidget::loadImagesFromDatabase()
                                                  Qt::SmoothTransformation);
             imageLabel->setPixmap(scaledPixmap);
             imageLabel->setAlignment(Qt::AlignCenter);
-            imageLabel->setStyleSheet("border: 1px solid #ccc; padding: 5px;");
-            imageLabel->setProperty("id", id); // 设置 id 属性
+            imageLabel->setProperty("id", image.id); // 设置 id 属性
 
             connect(imageLabel, &ClickableLabel::clicked, this,
                     &HonorWallWidget::onImageClicked);
@@ -132,6 +139,8 @@ void HonorWallWidget::addImage()
 
 void HonorWallWidget::addImageToWall(const QString& imagePath)
 {
+    EventLoopMonitor::ActivityScope activity(Q_FUNC_INFO);
+
     // 加载图片
     QPixmap pixmap(imagePath);
 
@@ -146,23 +155,23 @@ void HonorWallWidget::addImageToWall(const QString& imagePath)
     buffer.open(QIODevice::WriteOnly);
     pixmap.save(&buffer, "PNG"); // 保存为 PNG 格式
     // 将图片信息插入数据库
-    QSqlQuery query;
-    query.prepare(
-        "INSERT INTO honorWall (image_data, description,added_date) VALUES(:image_data, :description,:added_date)");
-    query.bindValue(":image_data",  imageData);
-    query.bindValue(":description", "未填写描述");                         // 默认描述
-    query.bindValue(":added_date",  QDate::currentDate().toString()); // 默认描述
-
-    if (!query.exec()) {
-        qWarning() << "插入数据失败：" << query.lastError().text();
+    HonorImage image;
+    image.imageData = imageData;
+    image.description = "未填写描述";                    // 默认描述
+    image.addedDate = QDate::currentDate().toString(); // 添加日期
+
+    HonorRepository repository;
+
+    if (!repository.insert(image)) {
+        qWarning() << "插入数据失败：" << repository.lastError();
         return;
     }
 
     // 将图片显示在界面上
-    addImageToUI(pixmap);
+    addImageToUI(pixmap, image.id);
 }
 
-void HonorWallWidget::addImageToUI(const QPixmap& pixmap)
+void HonorWallWidget::addImageToUI(const QPixmap& pixmap, int id)
 {
     if (pixmap.isNull()) {
         qWarning() << "图片无效！";
@@ -182,7 +191,7 @@ void HonorWallWidget::addImageToUI(const QPixmap& pixmap)
     }
     imageLabel->setPixmap(scaledPixmap);
     imageLabel->setAlignment(Qt::AlignCenter);
-    imageLabel->setStyleSheet("border: 1px solid #ccc; padding: 5px;");
+    imageLabel->setProperty("id", id); // 设置 id 属性，删除和修改时使用
 
     connect(imageLabel,
             &ClickableLabel::clicked,
@@ -198,17 +207,34 @@ void HonorWallWidget::addImageToUI(const QPixmap& pixmap)
 void HonorWallWidget::onImageClicked()
 {
     if (selectedLabel) { // 取消之前选中的图片样式
-        selectedLabel->setStyleSheet("border: 1px solid #ccc; padding: 5px;");
+        selectedLabel->setSelected(false);
     }
     selectedLabel = qobject_cast<ClickableLabel *>(sender());
 
     if (selectedLabel) { // 更新选中的图片
-        selectedLabel->setStyleSheet("border: 2px solid red; padding: 5px;");
+        selectedLabel->setSelected(true);
+    }
+}
+
+void HonorWallWidget::showImage(int id)
+{
+    for (int i = 0; i < gridLayout->count(); ++i) {
+        ClickableLabel *label = qobject_cast<ClickableLabel *>(gridLayout->itemAt(i)->widget());
+
+        if (label && (label->property("id").toInt() == id)) {
+            if (selectedLabel) selectedLabel->setSelected(false);
+            selectedLabel = label;
+            selectedLabel->setSelected(true);
+            scrollArea->ensureWidgetVisible(label);
+            return;
+        }
     }
 }
 
 void HonorWallWidget::deleteImage()
 {
+    EventLoopMonitor::ActivityScope activity(Q_FUNC_INFO);
+
     if (!selectedLabel) {
         QMessageBox::warning(this, "错误", "请先选择一张图片！");
         return;
@@ -222,12 +248,10 @@ void HonorWallWidget::deleteImage()
     int id = selectedLabel->property("id").toInt();
 
     // 从数据库中删除记录
-    QSqlQuery query;
-    query.prepare("DELETE FROM honorWall WHERE id = :id");
-    query.bindValue(":id", id);
+    HonorRepository repository;
 
-    if (!query.exec()) {
-        qWarning() << "删除数据失败：" << query.lastError().text();
+    if (!repository.remove(id)) {
+        qWarning() << "删除数据失败：" << repository.lastError();
         return;
     }
 
@@ -240,19 +264,14 @@ void HonorWallWidget::deleteImage()
 
 void HonorWallWidget::reorderImages()
 {
-    // 清空布局中的所有内容
-    QLayoutItem *item;
-
-    while ((item = gridLayout->takeAt(0)) != nullptr) {
-        delete item; // 删除布局项
-    }
-
-    // 重新加载图片;
+    // 重新加载图片，loadImagesFromDatabase() 会先清空布局
     loadImagesFromDatabase();
 }
 
 void HonorWallWidget::modifyImage()
 {
+    EventLoopMonitor::ActivityScope activity(Q_FUNC_INFO);
+
     if (!selectedLabel) {
         QMessageBox::warning(this, "错误", "请先选择一张图片！");
         return;
@@ -283,13 +302,10 @@ void HonorWallWidget::modifyImage()
     int id = selectedLabel->property("id").toInt();
 
     // 更新数据库
-    QSqlQuery query;
-    query.prepare("UPDATE honorWall SET image_data = :image_data WHERE id = :id");
-    query.bindValue(":image_data", imageData);
-    query.bindValue(":id",         id);
+    HonorRepository repository;
 
-    if (!query.exec()) {
-        qWarning() << "更新数据失败：" << query.lastError().text();
+    if (!repository.updateImage(id, imageData)) {
+        qWarning() << "更新数据失败：" << repository.lastError();
         return;
     }
 
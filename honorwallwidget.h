@@ -5,6 +5,7 @@
 #include <QLabel>
 #include <QString>
 #include <QPixmap>
+#include <QPainter>
 namespace Ui {
 class HonorWallWidget;
 }
@@ -17,12 +18,21 @@ class QGridLayout;
 constexpr int imgH = 500;
 constexpr int imgW = 300;
 
+// 荣誉墙图片。数量多、创建频繁，边框自己绘制而不是每张图片单独设置样式表
 class ClickableLabel : public QLabel {
     Q_OBJECT
 
 public:
 
-    explicit ClickableLabel(QWidget *parent = nullptr) : QLabel(parent) {}
+    explicit ClickableLabel(QWidget *parent = nullptr) : QLabel(parent) {
+        setContentsMargins(2, 2, 2, 2); // 为边框留出位置
+        setMargin(5);
+    }
+
+    void setSelected(bool selected) {
+        this->selected = selected;
+        update();
+    }
 
 signals:
 
@@ -35,6 +45,22 @@ protected:
 
         QLabel::mousePressEvent(event);
     }
+
+    void paintEvent(QPaintEvent *event) override {
+        QLabel::paintEvent(event);
+
+        // 未选中为 1px 浅灰色边框，选中为 2px 红色边框
+        const int width = selected ? 2 : 1;
+        QPainter  painter(this);
+        painter.setPen(QPen(selected ? QColor(Qt::red) : QColor(0xcc, 0xcc, 0xcc), width,
+                            Qt::SolidLine, Qt::SquareCap, Qt::MiterJoin));
+        painter.drawRect(QRectF(rect()).adjusted(width / 2.0, width / 2.0,
+                                                 -width / 2.0, -width / 2.0));
+    }
+
+private:
+
+    bool selected = false;
 };
 
 class HonorWallWidget : public QWidget {
@@ -45,13 +71,16 @@ public:
     explicit HonorWallWidget(QWidget *parent = nullptr);
     ~HonorWallWidget();
 
+    // 全局搜索结果：选中 id 对应的图片并滚动到可见
+    void showImage(int id);
+
 private:
 
     void setupUI();
     void loadImagesFromDatabase();
     void addImage();
     void addImageToWall(const QString& imagePath);
-    void addImageToUI(const QPixmap& pixmap);
+    void addImageToUI(const QPixmap& pixmap, int id);
     void onImageClicked();
     void deleteImage();
     void reorderImages();
@@ -0,0 +1,77 @@
+#include "importdialog.h"
+#include <QFileDialog>
+#include <QMessageBox>
+#include <QProgressDialog>
+#include <QStandardPaths>
+
+bool execImportDialog(QWidget *parent, DataImporter::Kind kind)
+{
+    const QString utf8Filter = "CSV 文件 UTF-8 (*.csv *.txt)";
+    const QString excelFilter = "Excel 另存的 CSV 文件 (*.csv *.txt)";
+    QString selectedFilter = utf8Filter;
+
+    static const QStringList titles = { "导入学生信息", "导入缴费记录", "导入课程" };
+
+    QString filePath = QFileDialog::getOpenFileName(
+        parent,
+        titles.value(kind),
+        QStandardPaths::writableLocation(QStandardPaths::DocumentsLocation),
+        utf8Filter + ";;" + excelFilter,
+        &selectedFilter);
+
+    if (filePath.isEmpty()) return false;
+
+    DataImporter importer;
+    importer.setEncoding(selectedFilter == excelFilter ? DataImporter::System
+                                                       : DataImporter::Utf8);
+
+    QProgressDialog progressDlg("正在导入...", "取消", 0, 100, parent);
+    progressDlg.setWindowTitle("导入");
+    progressDlg.setWindowModality(Qt::WindowModal);
+    progressDlg.setMinimumDuration(300);
+
+    // 导入在 GUI 线程执行，setValue() 会处理事件，取消按钮因此可以响应
+    QObject::connect(&importer, &DataImporter::progress, &progressDlg,
+                     [&progressDlg](int percent, qint64 rows) {
+        progressDlg.setLabelText(QString("已处理 %1 行").arg(rows));
+        progressDlg.setValue(percent);
+    });
+    QObject::connect(&progressDlg, &QProgressDialog::canceled, &importer,
+                     &DataImporter::cancel);
+
+    ImportReport report = importer.importFile(kind, filePath);
+    progressDlg.close();
+
+    QString summary = QString("共 %1 行，成功 %2 行，失败 %3 行\n用时 %4 秒，%5 行/秒")
+                      .arg(report.totalRows)
+                      .arg(report.imported)
+                      .arg(report.rejected)
+                      .arg(report.elapsedMs / 1000.0, 0, 'f', 2)
+                      .arg(report.rowsPerSecond(), 0, 'f', 0);
+
+    if (!report.fatalError.isEmpty()) summary.prepend(report.fatalError + "\n");
+
+    QMessageBox box(parent);
+    box.setWindowTitle("导入结果");
+    box.setIcon(report.rejected > 0 || !report.fatalError.isEmpty()
+                ? QMessageBox::Warning : QMessageBox::Information);
+    box.setText(summary);
+
+    // 出错行放在详细信息里，避免消息框过长
+    if (!report.errors.isEmpty()) {
+        QStringList details;
+
+        for (const ImportError& error : report.errors) {
+            details << QString("第 %1 行：%2").arg(error.line).arg(error.message);
+        }
+
+        if (report.rejected > report.errors.size()) {
+            details << QString("……另有 %1 行错误未列出")
+                .arg(report.rejected - report.errors.size());
+        }
+        box.setDetailedText(details.join('\n'));
+    }
+    box.exec();
+
+    return report.imported > 0;
+}
@@ -0,0 +1,12 @@
+#ifndef IMPORTDIALOG_H
+#define IMPORTDIALOG_H
+
+#include "dataimporter.h"
+
+class QWidget;
+
+// 选择文件并执行导入，期间显示进度，结束后汇总导入结果和出错行；
+// 有数据写入时返回 true，调用方据此刷新界面
+bool execImportDialog(QWidget *parent, DataImporter::Kind kind);
+
+#endif // IMPORTDIALOG_H
@@ -4,19 +4,24 @@
 #include <QGridLayout>
 #include <QPushButton>
 #include <QLineEdit>
-#include <QSqlQuery>
-#include <QSqlError>
-#include <QCryptographicHash>
+#include "userrepository.h"
+#include "eventloopmonitor.h"
+#include "startuptrace.h"
+#include "passwordhasher.h"
+#include "session.h"
 #include  "settings.h"
 #include <QMessageBox>
 
 // 登录对话框的构造函数，负责初始化UI界面和连接信号槽
-LoginDialog::LoginDialog(QDialog *parent)
+LoginDialog::LoginDialog(QWidget *parent)
     : QDialog(parent)
     , ui(new Ui::LoginDialog)
 {
     ui->setupUi(this);
-    checkAndCreateInitialUser(); // 检查数据库是否为空，若为空则插入初始用户
+    {
+        StartupTrace::Span span("LoginDialog::checkAndCreateInitialUser");
+        checkAndCreateInitialUser(); // 检查数据库是否为空，若为空则插入初始用户
+    }
     setWindowTitle("教学管理系统");    // 设置窗口标题
     setWindowIcon(QIcon(":/ico/NEWSAT.ICO"));
     setFixedSize(260, 180);
@@ -65,20 +70,19 @@ LoginDialog::~LoginDialog()
 
 // 检查数据库是否为空，若为空则创建初始管理员账户的函数
 void LoginDialog::checkAndCreateInitialUser() {
+    EventLoopMonitor::ActivityScope activity(Q_FUNC_INFO);
+
     const QString initialUsername = "admin"; // 初始用户名和密码
     const QString initialPassword = "admin123";
-    QSqlQuery     query;
-
-    query.exec("SELECT COUNT(*) FROM users");
+    UserRepository repository;
 
-    if (query.next() && (query.value(0).toInt() == 0)) { // 检查 users 表是否为空,表为空，插入初始用户
-        QString hashedInitialPassword = hashPassword(initialPassword);
-        query.prepare(
-            "INSERT INTO users (username, password) VALUES (:username, :password)");
-        query.bindValue(":username",       initialUsername);
-        query.bindValue(":password", hashedInitialPassword);
+    if (!repository.hasUsers()) { // 检查 users 表是否为空,表为空，插入初始用户
+        UserRecord user;
+        user.username = initialUsername;
+        user.passwordHash = PasswordHasher::hash(initialPassword);
+        user.role = UserRepository::adminRole;
 
-        if (!query.exec()) qDebug() << "插入初始用户失败:" << query.lastError().text();
+        if (!repository.insert(user)) qDebug() << "插入初始用户失败:" << repository.lastError();
     }
 }
 
@@ -97,44 +101,43 @@ void LoginDialog::on_loginButton_clicked() {
 
 // 验证用户名和密码是否匹配的函数
 bool LoginDialog::validateUser(const QString& username, const QString& password) {
-    QString   hashedPassword = hashPassword(password);
-    QSqlQuery query;
+    EventLoopMonitor::ActivityScope activity(Q_FUNC_INFO);
 
-    query.prepare(
-        "SELECT * FROM users WHERE username = :username AND password = :password");
-    query.bindValue(":username",       username);
-    query.bindValue(":password", hashedPassword);
+    UserRepository repository;
+    UserRecord     user;
 
-    if (!query.exec()) {
-        qDebug() << "查询错误:" << query.lastError().text();
+    if (!repository.findByUsername(username, user)) {
+        if (!repository.lastError().isEmpty()) qDebug() << "查询错误:" << repository.lastError();
+
+        // 用户不存在时同样计算一次哈希，避免从响应时间判断用户名是否存在
+        PasswordHasher::hash(password);
         return false;
     }
-    return query.next();
+
+    if (!PasswordHasher::verify(password, user.passwordHash)) return false;
+
+    // 旧版无盐 SHA-256 或迭代次数低于当前配置时，用这次输入的明文重新生成哈希
+    if (PasswordHasher::needsRehash(user.passwordHash) &&
+        !repository.updatePassword(username, PasswordHasher::hash(password))) {
+        qDebug() << "更新密码哈希失败:" << repository.lastError();
+    }
+
+    // 角色和权限只在登录时读取一次
+    Session::instance().begin(user.username, user.role, repository.permissionsOf(user.role));
+    return true;
 }
 
 // 保存用户登录凭证到配置文件的函数
 void LoginDialog::saveCredentials(const QString& username,
                                   const QString& password) {
     // 存储用户名和加密后的密码
-    Settings::instance().getQSettings().setValue("username", username);
-    QString encryptedPassword = encryptPassword(password);
-    Settings::instance().getQSettings().setValue("password", encryptedPassword);
-}
-
-// 使用SHA256算法对密码进行哈希加密的函数
-QString LoginDialog::hashPassword(const QString& password) {
-    QByteArray passwordBytes = password.toUtf8();
-    QByteArray hashBytes = QCryptographicHash::hash(passwordBytes,
-                                                    QCryptographicHash::Sha256);
-
-    return QString(hashBytes.toHex());
+    Settings::instance().setCachedCredentials(username, encryptPassword(password));
 }
 
 // 从配置文件加载缓存的登录凭证
 bool LoginDialog::loadCredentials(QString& username, QString& password) {
-    username = Settings::instance().getQSettings().value("username").toString();
-    QString encryptedPassword = Settings::instance().getQSettings().value(
-        "password").toString();
+    username = Settings::instance().getCachedUsername();
+    QString encryptedPassword = Settings::instance().getCachedPassword();
 
     if (!username.isEmpty() && !encryptedPassword.isEmpty()) { // 如果用户名和加密后的密码不为空，则解密密码
         password = decryptPassword(encryptedPassword);
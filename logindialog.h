@@ -15,7 +15,7 @@ class LoginDialog : public QDialog {
 
 public:
 
-    explicit LoginDialog(QDialog *parent = nullptr);
+    explicit LoginDialog(QWidget *parent = nullptr);
     ~LoginDialog();
 
 private:
@@ -24,7 +24,6 @@ private:
 
     void    checkAndCreateInitialUser();
     void    on_loginButton_clicked();
-    QString hashPassword(const QString& password);
     QString encryptPassword(const QString& password);
     bool    validateUser(const QString& username,
                          const QString& password);
@@ -1,29 +1,84 @@
 #include "mainwindow.h"
 #include "databasemanager.h"
+#include "eventloopmonitor.h"
 #include "logindialog.h"
+#include "queryprofiler.h"
+#include "settings.h"
+#include "startuptrace.h"
+#include "stylesheets.h"
 #include <QApplication>
-#include <Qfile>
+#include <QThread>
+#include <QThreadPool>
+#include <memory>
 int main(int argc, char *argv[])
 {
-    QApplication a(argc, argv);
-    QFile styleFile(":/style/1.qss");
-
-    if (styleFile.open(QFile::ReadOnly)) {
-        QString styleSheet = QString(styleFile.readAll());
-        a.setStyleSheet(styleSheet); // 应用样式表
-        styleFile.close();
-    } else {
-        qWarning() << "打开失败" << styleFile.errorString();
+    StartupTrace::instance(); // 跟踪计时从这里开始
+
+    std::unique_ptr<QApplication> app;
+    {
+        StartupTrace::Span span("QApplication");
+        app.reset(new QApplication(argc, argv));
+    }
+    QApplication& a = *app;
+
+    {
+        StartupTrace::Span span("加载样式表");
+        StyleSheets::applyBase(a); // 各页面的样式在第一次显示时再加载
+    }
+
+    // 定时器要在 QApplication 析构之前删除，不能等到单例的静态析构
+    EventLoopMonitor::instance().start();
+    QObject::connect(&a, &QCoreApplication::aboutToQuit, [] { EventLoopMonitor::instance().stop(); });
+
+    // 配置修改后立即生效；退出前写回尚未保存的配置
+    Settings& settings = Settings::instance();
+    auto applyThreads = [](int threads) {
+        const int count = threads > 0 ? threads : QThread::idealThreadCount();
+        QThreadPool::globalInstance()->setMaxThreadCount(count);
+        DataBaseManager::instance().backgroundPool()->setMaxThreadCount(count);
+    };
+    applyThreads(settings.getBackgroundThreads());
+    QObject::connect(&settings, &Settings::backgroundThreadsChanged, applyThreads);
+    QObject::connect(&settings, &Settings::slowQueryThresholdChanged, [](int ms) {
+        QueryProfiler::instance().setSlowThresholdMs(ms);
+    });
+    QObject::connect(&a, &QCoreApplication::aboutToQuit, &settings, &Settings::flush);
+
+    {
+        StartupTrace::Span span("DataBaseManager::setDatabasePath");
+        DataBaseManager::instance().setDatabasePath(settings.getDatabasePath());
     }
 
-    DataBaseManager::instance();
+    std::unique_ptr<LoginDialog> loginDlg;
+    {
+        StartupTrace::Span span("LoginDialog 构造");
+        loginDlg.reset(new LoginDialog);
+    }
+    StartupTrace::instance().watchFirstPaint(loginDlg.get(), "登录对话框首次绘制", false);
 
-    LoginDialog loginDlg;
+    int result;
+    {
+        StartupTrace::Span span("LoginDialog::exec（等待用户登录）");
+        result = loginDlg->exec();
+    }
 
-    if (loginDlg.exec() == QDialog::Accepted) {
-        MainWindow w;
-        w.show();
+    if (result == QDialog::Accepted) {
+        std::unique_ptr<MainWindow> w;
+        {
+            StartupTrace::Span span("MainWindow 构造");
+            w.reset(new MainWindow);
+        }
+        StartupTrace::instance().watchFirstPaint(w.get(), "主窗口首次绘制", true);
+        {
+            StartupTrace::Span span("MainWindow::show");
+            w->show();
+        }
+        DataBaseManager::instance().startMaintenance();
         return a.exec();
     }
+    StartupTrace::instance().write();
+
+    // 取消登录时不进入事件循环，aboutToQuit 不会发出
+    EventLoopMonitor::instance().stop();
     return 0;
 }
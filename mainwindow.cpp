@@ -1,20 +1,209 @@
 #include "mainwindow.h"
 #include "./ui_mainwindow.h"
 #include <QButtonGroup>
+#include <QCloseEvent>
+#include <QLabel>
+#include <QMessageBox>
+#include <QStatusBar>
+#include <QToolBar>
+#include <QToolButton>
+#include "databasebackup.h"
+#include "eventloopmonitor.h"
+#include "financialwidget.h"
+#include "globalsearchbox.h"
+#include "honorwallwidget.h"
+#include "schedulewidget.h"
+#include "session.h"
+#include "startuptrace.h"
+#include "studentinfowidget.h"
+#include "stylesheets.h"
+#include "systemsettingswidget.h"
 MainWindow::MainWindow(QWidget *parent)
     : QMainWindow(parent)
     , ui(new Ui::MainWindow)
 {
-    ui->setupUi(this);
-    QButtonGroup *btnGp=new QButtonGroup(this);
-    btnGp->addButton(ui->btnSudentInfo,0);
-    btnGp->addButton(ui->btnSystemSetting,4);
-    btnGp->addButton(ui->btnFinance,2);
-    btnGp->addButton(ui->btnHonor,3);
-    btnGp->addButton(ui->btnSchedule,1);
-    connect(btnGp,&QButtonGroup::idClicked,ui->stackedWidget,&QStackedWidget::setCurrentIndex);
-    btnGp->button(0)->setCheckable(true);
-    ui->stackedWidget->setCurrentIndex(0);
+    {
+        StartupTrace::Span span("MainWindow::setupUi");
+        ui->setupUi(this);
+    }
+
+    btnGp=new QButtonGroup(this);
+    connect(btnGp,&QButtonGroup::idClicked,this,[this](int id){
+        EventLoopMonitor::ActivityScope activity("MainWindow::switchPage");
+        ui->stackedWidget->setCurrentIndex(id);
+    });
+    buildPages();
+
+    // 状态栏：界面卡顿统计
+    stallLabel=new QLabel(this);
+    QToolButton *stallBtn=new QToolButton(this);
+    stallBtn->setText("卡顿统计");
+    stallBtn->setAutoRaise(true);
+    statusBar()->addPermanentWidget(stallLabel);
+    statusBar()->addPermanentWidget(stallBtn);
+    connect(stallBtn,&QToolButton::clicked,this,&MainWindow::showStallReport);
+    connect(&EventLoopMonitor::instance(),&EventLoopMonitor::stallDetected,this,&MainWindow::updateStallLabel);
+    updateStallLabel();
+}
+
+void MainWindow::buildPages()
+{
+    // 只创建当前用户有权限的页面，没有权限的页面不构造，对应按钮隐藏
+    const QVector<QPair<Session::Permission,QToolButton*>> buttons={
+        {Session::StudentPage,ui->btnSudentInfo},
+        {Session::SchedulePage,ui->btnSchedule},
+        {Session::FinancePage,ui->btnFinance},
+        {Session::HonorPage,ui->btnHonor},
+        {Session::SettingsPage,ui->btnSystemSetting},
+    };
+    QWidget *current=ui->stackedWidget->currentWidget();
+    for(QAbstractButton *button:btnGp->buttons()) btnGp->removeButton(button);
+    while(ui->stackedWidget->count()>0) ui->stackedWidget->removeWidget(ui->stackedWidget->widget(0));
+
+    QMap<int,QWidget*> previous;
+    previous.swap(pages);
+    for(const auto& button:buttons){
+        if(!Session::instance().has(button.first)){
+            button.second->hide();
+            continue;
+        }
+        QWidget *page=previous.take(button.first);
+        if(!page) page=createPage(button.first);
+        pages.insert(button.first,page);
+        ui->stackedWidget->addWidget(page);
+        button.second->show();
+        btnGp->addButton(button.second,ui->stackedWidget->count()-1);
+    }
+    for(QWidget *page:std::as_const(previous)) page->deleteLater();
+
+    if(!btnGp->buttons().isEmpty()) btnGp->button(0)->setCheckable(true);
+    const int index=qMax(ui->stackedWidget->indexOf(current),0);
+    ui->stackedWidget->setCurrentIndex(index);
+    if(QAbstractButton *button=btnGp->button(index)) button->setChecked(true);
+    statusBar()->showMessage(QString("当前用户：%1（%2）")
+                                 .arg(Session::instance().username(),Session::instance().role()));
+
+    // 顶部全局搜索，没有可搜索的页面时不显示
+    const bool searchable=pages.contains(Session::StudentPage)||pages.contains(Session::FinancePage)||pages.contains(Session::HonorPage);
+    if(searchable&&!searchBar){
+        searchBar=addToolBar("搜索");
+        searchBar->setMovable(false);
+        GlobalSearchBox *searchBox=new GlobalSearchBox(searchBar);
+        searchBox->setFixedWidth(360);
+        searchBar->addWidget(new QLabel("搜索：",searchBar));
+        searchBar->addWidget(searchBox);
+        connect(searchBox,&GlobalSearchBox::hitActivated,this,&MainWindow::openSearchHit);
+    }
+    else if(!searchable&&searchBar){
+        removeToolBar(searchBar);
+        searchBar->deleteLater();
+        searchBar=nullptr;
+    }
+}
+
+// 页面专用的样式表，第一次切换到该页面时才设置
+QWidget *MainWindow::createPage(int permission)
+{
+    QWidget *page=nullptr;
+    switch(permission){
+    case Session::StudentPage:
+        page=new StudentInfoWidget(this);
+        StyleSheets::applyOnFirstShow(page,{"table","groupbox"});
+        break;
+    case Session::SchedulePage:
+        page=new ScheduleWidget(this);
+        StyleSheets::applyOnFirstShow(page,{"table"});
+        break;
+    case Session::FinancePage:
+        page=new FinancialWidget(this);
+        StyleSheets::applyOnFirstShow(page,{"table"});
+        break;
+    case Session::HonorPage:
+        page=new HonorWallWidget(this);
+        break;
+    default:{
+        SystemSettingsWidget *settingsPage=new SystemSettingsWidget(this);
+        // 本页面发出信号时还在自己的函数中，排队到事件循环中再更新页面
+        connect(settingsPage,&SystemSettingsWidget::sessionChanged,this,&MainWindow::buildPages,Qt::QueuedConnection);
+        page=settingsPage;
+        StyleSheets::applyOnFirstShow(page,{"table","groupbox"});
+        break;
+    }
+    }
+    return page;
+}
+
+QWidget *MainWindow::showPage(int permission)
+{
+    QWidget *page=pages.value(permission);
+    if(!page) return nullptr;
+
+    const int index=ui->stackedWidget->indexOf(page);
+    ui->stackedWidget->setCurrentIndex(index);
+    if(QAbstractButton *button=btnGp->button(index)) button->setChecked(true);
+    return page;
+}
+
+void MainWindow::openSearchHit(const SearchHit &hit)
+{
+    EventLoopMonitor::ActivityScope activity(Q_FUNC_INFO);
+
+    switch(hit.kind){
+    case SearchHit::Student:
+        if(auto *page=qobject_cast<StudentInfoWidget*>(showPage(Session::StudentPage))) page->showStudent(hit.ref);
+        break;
+    case SearchHit::Payment:
+        if(auto *page=qobject_cast<FinancialWidget*>(showPage(Session::FinancePage))) page->showPayment(hit.studentId,hit.ref.toInt(),hit.date);
+        break;
+    case SearchHit::Honor:
+        if(auto *page=qobject_cast<HonorWallWidget*>(showPage(Session::HonorPage))) page->showImage(hit.ref.toInt());
+        break;
+    }
+}
+
+void MainWindow::updateStallLabel()
+{
+    const QJsonObject report=EventLoopMonitor::instance().snapshot();
+    stallLabel->setText(QString("近%1分钟卡顿 %2 次，最长 %3 ms")
+                            .arg(report["windowMinutes"].toInt())
+                            .arg(report["stalls"].toInt())
+                            .arg(report["maxStallMs"].toInt()));
+}
+
+// 保存统计文件并显示报告，文件可以直接发给开发人员
+void MainWindow::showStallReport()
+{
+    const QString path=EventLoopMonitor::defaultDumpPath();
+    EventLoopMonitor::instance().dumpTo(path);
+
+    QMessageBox box(this);
+    box.setWindowTitle("卡顿统计");
+    box.setText("统计已保存到：\n"+path);
+    box.setDetailedText(EventLoopMonitor::formatReport(EventLoopMonitor::instance().snapshot()));
+    box.exec();
+}
+
+// 备份线程中的 VACUUM INTO 无法中途停止，直接退出会卡在 ~DatabaseBackup() 中等它写完。
+// 先问用户：备份完成后自动退出，或者继续使用程序
+void MainWindow::closeEvent(QCloseEvent *event)
+{
+    auto *settingsPage=qobject_cast<SystemSettingsWidget*>(pages.value(Session::SettingsPage));
+    DatabaseBackup *backup=settingsPage?settingsPage->databaseBackup():nullptr;
+
+    if(!backup||!backup->isRunning()){
+        event->accept();
+        return;
+    }
+    event->ignore();
+    if(closeAfterBackup) return;
+
+    if(QMessageBox::question(this,"备份进行中",
+                             "数据库备份还没有完成，中途无法停止。\n"
+                             "是否在备份完成后自动退出？选择“否”继续使用程序。")!=QMessageBox::Yes) return;
+
+    closeAfterBackup=true;
+    statusBar()->showMessage("备份完成后自动退出...");
+    connect(backup,&DatabaseBackup::finished,this,&MainWindow::close,Qt::QueuedConnection);
 }
 
 MainWindow::~MainWindow()
@@ -2,6 +2,13 @@
 #define MAINWINDOW_H
 
 #include <QMainWindow>
+#include <QMap>
+
+class QButtonGroup;
+class QCloseEvent;
+class QLabel;
+class QToolBar;
+struct SearchHit;
 
 QT_BEGIN_NAMESPACE
 namespace Ui {
@@ -17,7 +24,28 @@ public:
     MainWindow(QWidget *parent = nullptr);
     ~MainWindow();
 
+protected:
+    void closeEvent(QCloseEvent *event) override;
+
 private:
+    // 按当前会话的权限创建页面、按钮和搜索栏。切换数据库重新登录后再次调用：
+    // 仍有权限的页面保留（已随 databaseSwitched() 重新读取），失去权限的删除，新获得的创建
+    void buildPages();
+
+    // 按权限创建页面，参数为 Session::Permission
+    QWidget *createPage(int permission);
+
+    // 切换到权限对应的页面并选中其按钮，页面不存在时返回 nullptr
+    QWidget *showPage(int permission);
+    void openSearchHit(const SearchHit& hit);
+    void updateStallLabel();
+    void showStallReport();
+
+    QMap<int,QWidget*> pages;
+    QButtonGroup *btnGp;
+    QToolBar *searchBar=nullptr;
+    QLabel *stallLabel;
+    bool closeAfterBackup=false;
     Ui::MainWindow *ui;
 };
 #endif // MAINWINDOW_H
@@ -0,0 +1,136 @@
+#include "passwordhasher.h"
+#include "settings.h"
+#include <QCryptographicHash>
+#include <QElapsedTimer>
+#include <QMessageAuthenticationCode>
+#include <QRandomGenerator>
+#include <QStringList>
+
+namespace {
+const QString scheme = "pbkdf2-sha256";
+const int saltBytes = 16;
+
+// PBKDF2-HMAC-SHA256，只取第一块（32 字节）。同一个 HMAC 对象反复 reset()，
+// 不重复处理密钥
+QByteArray pbkdf2(const QByteArray& password, const QByteArray& salt, int iterations)
+{
+    QMessageAuthenticationCode mac(QCryptographicHash::Sha256, password);
+
+    mac.addData(salt);
+    mac.addData(QByteArray::fromHex("00000001"));
+    QByteArray u = mac.result();
+    QByteArray t = u;
+
+    for (int i = 1; i < iterations; ++i) {
+        mac.reset();
+        mac.addData(u);
+        u = mac.result();
+
+        for (int j = 0; j < t.size(); ++j) t[j] = char(t[j] ^ u[j]);
+    }
+    return t;
+}
+
+QByteArray legacyHash(const QString& password)
+{
+    return QCryptographicHash::hash(password.toUtf8(), QCryptographicHash::Sha256).toHex();
+}
+
+// 拆分 "pbkdf2-sha256$迭代次数$盐$哈希"，格式不对时返回 false
+bool parse(const QString& stored, int& iterations, QByteArray& salt, QByteArray& digest)
+{
+    const QStringList parts = stored.split('$');
+
+    if ((parts.size() != 4) || (parts[0] != scheme)) return false;
+
+    bool ok = false;
+    iterations = parts[1].toInt(&ok);
+    salt = QByteArray::fromBase64(parts[2].toLatin1());
+    digest = QByteArray::fromBase64(parts[3].toLatin1());
+    return ok && iterations > 0 && !salt.isEmpty() && !digest.isEmpty();
+}
+}
+
+QString PasswordHasher::hash(const QString& password)
+{
+    return hash(password, configuredIterations());
+}
+
+QString PasswordHasher::hash(const QString& password, int iterations)
+{
+    QByteArray salt(saltBytes, Qt::Uninitialized);
+
+    QRandomGenerator::system()->fillRange(reinterpret_cast<quint32 *>(salt.data()),
+                                          saltBytes / sizeof(quint32));
+
+    const QByteArray digest = pbkdf2(password.toUtf8(), salt, iterations);
+
+    return QString("%1$%2$%3$%4").arg(scheme).arg(iterations)
+           .arg(QString::fromLatin1(salt.toBase64()), QString::fromLatin1(digest.toBase64()));
+}
+
+bool PasswordHasher::verify(const QString& password, const QString& stored)
+{
+    int iterations = 0;
+    QByteArray salt, digest;
+
+    if (parse(stored, iterations, salt, digest)) {
+        return constantTimeEquals(pbkdf2(password.toUtf8(), salt, iterations), digest);
+    }
+
+    // 旧版本的无盐 SHA-256
+    return constantTimeEquals(legacyHash(password), stored.toLatin1().toLower());
+}
+
+bool PasswordHasher::needsRehash(const QString& stored)
+{
+    int iterations = 0;
+    QByteArray salt, digest;
+
+    return !parse(stored, iterations, salt, digest) || iterations < configuredIterations();
+}
+
+int PasswordHasher::configuredIterations()
+{
+    int iterations = Settings::instance().getPasswordIterations();
+
+    if (iterations <= 0) {
+        iterations = calibrate(defaultTargetMs);
+        Settings::instance().setPasswordIterations(iterations);
+    }
+    return qMax(iterations, minimumIterations);
+}
+
+// 先用少量迭代计时，样本耗时不足 50ms 时加倍重测，再按比例推算
+int PasswordHasher::calibrate(int targetMs)
+{
+    const QByteArray password = "calibrate";
+    const QByteArray salt(saltBytes, 'x');
+    int    sample = 1000;
+    qint64 elapsedNs = 0;
+
+    forever {
+        QElapsedTimer timer;
+        timer.start();
+        pbkdf2(password, salt, sample);
+        elapsedNs = timer.nsecsElapsed();
+
+        if ((elapsedNs >= 50 * 1000000LL) || (sample >= (1 << 24))) break;
+        sample *= 2;
+    }
+
+    const qint64 iterations = qint64(sample) * targetMs * 1000000LL / qMax<qint64>(elapsedNs, 1);
+
+    // 取整到千，便于在 config.ini 中辨认
+    return int(qBound<qint64>(minimumIterations, iterations / 1000 * 1000, 100000000));
+}
+
+bool PasswordHasher::constantTimeEquals(const QByteArray& a, const QByteArray& b)
+{
+    if (a.size() != b.size()) return false;
+
+    uchar diff = 0;
+
+    for (int i = 0; i < a.size(); ++i) diff |= uchar(a[i] ^ b[i]);
+    return diff == 0;
+}
@@ -0,0 +1,39 @@
+#ifndef PASSWORDHASHER_H
+#define PASSWORDHASHER_H
+
+#include <QByteArray>
+#include <QString>
+
+// 用户密码哈希：PBKDF2-HMAC-SHA256，每个密码随机加盐。
+// 保存格式为 "pbkdf2-sha256$迭代次数$盐$哈希"（盐和哈希为 Base64），
+// 旧版本保存的无盐 SHA-256（64 位十六进制）仍可验证，登录成功后改存新格式
+class PasswordHasher {
+public:
+
+    // 迭代次数下限，校准结果和配置值都不低于它
+    static constexpr int minimumIterations = 10000;
+
+    // 未校准时登录验证的目标耗时（毫秒）
+    static constexpr int defaultTargetMs = 200;
+
+    // 按 config.ini 中的迭代次数生成哈希；尚未校准时先在本机校准并保存
+    static QString hash(const QString& password);
+    static QString hash(const QString& password, int iterations);
+
+    // 与保存的哈希比较，比较时间与哈希内容无关
+    static bool    verify(const QString& password, const QString& stored);
+
+    // 旧格式或迭代次数低于当前配置的哈希需要在登录成功后重新生成
+    static bool    needsRehash(const QString& stored);
+
+    // 配置的迭代次数，未配置时调用 calibrate(defaultTargetMs) 并写入配置
+    static int     configuredIterations();
+
+    // 在本机测量 PBKDF2 的速度，返回单次验证耗时约为 targetMs 的迭代次数
+    static int     calibrate(int targetMs);
+
+    // 长度相同时逐字节比较全部内容，不因第一个不同的字节提前返回
+    static bool    constantTimeEquals(const QByteArray& a, const QByteArray& b);
+};
+
+#endif // PASSWORDHASHER_H
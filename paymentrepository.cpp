@@ -0,0 +1,196 @@
+#include "paymentrepository.h"
+
+namespace {
+PaymentRecord readRecord(const QSqlQuery& query)
+{
+    PaymentRecord record;
+
+    record.id = query.value(0).toInt();
+    record.studentId = query.value(1).toString();
+    record.studentName = query.value(2).toString();
+    record.paymentDate = QDate::fromString(query.value(3).toString(), "yyyy-MM-dd");
+    record.amount = query.value(4).toDouble();
+    record.paymentType = query.value(5).toString();
+    record.notes = query.value(6).toString();
+    return record;
+}
+}
+
+QString PaymentRepository::whereClause(const PaymentFilter& filter,
+                                       QVariantList       & bindValues) const
+{
+    QStringList conditions;
+
+    if (filter.from.isValid()) {
+        conditions << "fr.payment_date >= ?";
+        bindValues << filter.from.toString("yyyy-MM-dd");
+    }
+
+    if (filter.to.isValid()) {
+        conditions << "fr.payment_date <= ?";
+        bindValues << filter.to.toString("yyyy-MM-dd");
+    }
+
+    if (!filter.studentId.isEmpty() && (filter.studentId != "-1")) {
+        conditions << "fr.student_id = ?";
+        bindValues << filter.studentId;
+    }
+    return conditions.isEmpty() ? QString() : " WHERE " + conditions.join(" AND ");
+}
+
+QVector<PaymentRecord> PaymentRepository::load(const PaymentFilter& filter)
+{
+    QVector<PaymentRecord> records;
+
+    forEach(filter, [&records](const PaymentRecord& record) {
+        records.append(record);
+        return true;
+    });
+    return records;
+}
+
+bool PaymentRepository::forEach(const PaymentFilter                           & filter,
+                                const std::function<bool(const PaymentRecord&)>& callback)
+{
+    QVariantList bindValues;
+    QSqlQuery    query = prepare(
+        "SELECT fr.id, fr.student_id, s.name, fr.payment_date, fr.amount, "
+        "fr.payment_type, fr.notes "
+        "FROM financialRecords fr "
+        "LEFT JOIN studentInfo s ON fr.student_id = s.id" +
+        whereClause(filter, bindValues) + " ORDER BY fr.payment_date");
+
+    for (const QVariant& value : bindValues) query.addBindValue(value);
+
+    if (!exec(query)) return false;
+
+    while (next(query)) {
+        if (!callback(readRecord(query))) break;
+    }
+    return true;
+}
+
+QVector<PaymentSummary> PaymentRepository::totalsByType(const PaymentFilter& filter)
+{
+    return summarize(filter, ByType);
+}
+
+QMap<QDate, double> PaymentRepository::dailyTotals(const PaymentFilter& filter)
+{
+    QMap<QDate, double> totals;
+    QVariantList bindValues;
+    QSqlQuery    query = prepare(
+        "SELECT DATE(fr.payment_date) AS day, SUM(fr.amount) "
+        "FROM financialRecords fr" + whereClause(filter, bindValues) +
+        " GROUP BY day ORDER BY day");
+
+    for (const QVariant& value : bindValues) query.addBindValue(value);
+
+    if (!exec(query)) return totals;
+
+    while (next(query)) {
+        QDate day = QDate::fromString(query.value(0).toString(), "yyyy-MM-dd");
+
+        if (day.isValid()) totals.insert(day, query.value(1).toDouble());
+    }
+    return totals;
+}
+
+QVector<PaymentSummary> PaymentRepository::summarize(const PaymentFilter& filter,
+                                                     GroupBy              groupBy)
+{
+    QString keyExpr;
+
+    switch (groupBy) {
+    case ByMonth:
+        keyExpr = "strftime('%Y-%m', fr.payment_date)";
+        break;
+
+    case ByType:
+        keyExpr = "fr.payment_type";
+        break;
+
+    case ByStudent:
+        keyExpr = "fr.student_id || ' ' || IFNULL(s.name, '')";
+        break;
+    }
+
+    QVector<PaymentSummary> summaries;
+    QVariantList bindValues;
+    QSqlQuery    query = prepare(
+        QString("SELECT %1 AS grp, COUNT(*), SUM(fr.amount) "
+                "FROM financialRecords fr "
+                "LEFT JOIN studentInfo s ON fr.student_id = s.id").arg(keyExpr) +
+        whereClause(filter, bindValues) + " GROUP BY grp ORDER BY grp");
+
+    for (const QVariant& value : bindValues) query.addBindValue(value);
+
+    if (!exec(query)) return summaries;
+
+    while (next(query)) {
+        summaries.append({ query.value(0).toString(), query.value(1).toLongLong(),
+                           query.value(2).toDouble() });
+    }
+    return summaries;
+}
+
+bool PaymentRepository::insert(const PaymentRecord& record)
+{
+    QSqlQuery query = prepare(
+        "INSERT INTO financialRecords (student_id, payment_date, amount, payment_type, notes) "
+        "VALUES (:student_id, :payment_date, :amount, :payment_type, :notes)");
+
+    query.bindValue(":student_id",   record.studentId);
+    query.bindValue(":payment_date", record.paymentDate.toString("yyyy-MM-dd"));
+    query.bindValue(":amount",       record.amount);
+    query.bindValue(":payment_type", record.paymentType);
+    query.bindValue(":notes",        record.notes);
+    return exec(query);
+}
+
+bool PaymentRepository::insertBatch(const QVector<PaymentRecord>& records)
+{
+    QVariantList studentIds, dates, amounts, types, notes;
+
+    for (const PaymentRecord& record : records) {
+        studentIds << record.studentId;
+        dates << record.paymentDate.toString("yyyy-MM-dd");
+        amounts << record.amount;
+        types << record.paymentType;
+        notes << record.notes;
+    }
+
+    QSqlQuery query = prepare(
+        "INSERT INTO financialRecords (student_id, payment_date, amount, payment_type, notes) "
+        "VALUES (?, ?, ?, ?, ?)");
+
+    query.addBindValue(studentIds);
+    query.addBindValue(dates);
+    query.addBindValue(amounts);
+    query.addBindValue(types);
+    query.addBindValue(notes);
+    return execBatch(query);
+}
+
+bool PaymentRepository::update(const PaymentRecord& record)
+{
+    QSqlQuery query = prepare(
+        "UPDATE financialRecords SET student_id = :student_id, payment_date = :payment_date, "
+        "amount = :amount, payment_type = :payment_type, notes = :notes WHERE id = :id");
+
+    query.bindValue(":student_id",   record.studentId);
+    query.bindValue(":payment_date", record.paymentDate.toString("yyyy-MM-dd"));
+    query.bindValue(":amount",       record.amount);
+    query.bindValue(":payment_type", record.paymentType);
+    query.bindValue(":notes",        record.notes);
+    query.bindValue(":id",           record.id);
+    return exec(query);
+}
+
+bool PaymentRepository::remove(int id)
+{
+    QSqlQuery query = prepare("DELETE FROM financialRecords WHERE id = :id");
+
+    query.bindValue(":id", id);
+    return exec(query);
+}
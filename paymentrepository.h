@@ -0,0 +1,74 @@
+#ifndef PAYMENTREPOSITORY_H
+#define PAYMENTREPOSITORY_H
+
+#include "repository.h"
+#include <QDate>
+#include <QMap>
+#include <QVector>
+#include <functional>
+
+// financialRecords 表的一行，studentName 来自 studentInfo 关联查询
+struct PaymentRecord {
+    int     id = 0;
+    QString studentId;
+    QString studentName;
+    QDate   paymentDate;
+    double  amount = 0;
+    QString paymentType;
+    QString notes;
+};
+
+// 缴费查询条件，与 FinancialWidget 顶部的筛选控件对应
+struct PaymentFilter {
+    QDate   from;      // 无效日期表示不限
+    QDate   to;
+    QString studentId; // 为空或 "-1" 表示所有学生
+};
+
+// 分组汇总的一行
+struct PaymentSummary {
+    QString key;
+    qint64  count = 0;
+    double  total = 0;
+};
+
+class PaymentRepository : public Repository {
+public:
+
+    enum GroupBy {
+        ByMonth,
+        ByType,
+        ByStudent
+    };
+
+    using Repository::Repository;
+
+    QVector<PaymentRecord>  load(const PaymentFilter& filter);
+
+    // 逐行回调，不在内存中保留结果集；回调返回 false 时停止遍历
+    bool                    forEach(const PaymentFilter                           & filter,
+                                    const std::function<bool(const PaymentRecord&)>& callback);
+
+    // 饼图：按支付类型汇总
+    QVector<PaymentSummary> totalsByType(const PaymentFilter& filter);
+
+    // 折线图：按天汇总
+    QMap<QDate, double>     dailyTotals(const PaymentFilter& filter);
+
+    // 报表：按月份、类型或学生汇总
+    QVector<PaymentSummary> summarize(const PaymentFilter& filter, GroupBy groupBy);
+
+    bool                    insert(const PaymentRecord& record);
+
+    // 使用 execBatch() 批量插入，不开启事务，由调用方控制
+    bool                    insertBatch(const QVector<PaymentRecord>& records);
+    bool                    update(const PaymentRecord& record);
+    bool                    remove(int id);
+
+private:
+
+    QString                 whereClause(const PaymentFilter& filter,
+                                        QVariantList       & bindValues) const;
+};
+
+#endif // PAYMENTREPOSITORY_H
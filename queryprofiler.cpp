@@ -0,0 +1,169 @@
+#include "queryprofiler.h"
+#include "settings.h"
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSqlError>
+#include <QSqlQuery>
+#include <QStringList>
+#include <QTextStream>
+#include <algorithm>
+
+namespace {
+// 不同的 SQL 语句数量有限，超过上限后不再新增，防止拼接出的语句撑满内存
+const int maxStatements = 500;
+
+thread_local const char *currentCallerName = nullptr;
+}
+
+QueryProfiler& QueryProfiler::instance()
+{
+    static QueryProfiler instance;
+
+    return instance;
+}
+
+QueryProfiler::QueryProfiler()
+    : thresholdMs(Settings::instance().getSlowQueryThreshold())
+    , logPath(QDir(Settings::logDirectory()).filePath("slow_queries.log"))
+{
+    sinceLastQuery.start();
+}
+
+QueryProfiler::CallerScope::CallerScope(const char *name)
+    : previous(currentCallerName)
+{
+    currentCallerName = name;
+}
+
+QueryProfiler::CallerScope::~CallerScope()
+{
+    currentCallerName = previous;
+}
+
+QString QueryProfiler::currentCaller()
+{
+    return currentCallerName ? QString::fromLatin1(currentCallerName) : QString();
+}
+
+void QueryProfiler::record(const QuerySample& sample)
+{
+    QMutexLocker locker(&mutex);
+
+    sinceLastQuery.restart();
+
+    auto it = statements.find(sample.sql);
+
+    if (it == statements.end()) {
+        if (statements.size() >= maxStatements) return;
+
+        it = statements.insert(sample.sql, StatementStats());
+        it->sql = sample.sql;
+    }
+
+    it->caller = sample.caller;
+    it->bindCount = sample.bindCount;
+    it->calls++;
+    it->totalNs += sample.elapsedNs;
+    it->maxNs = qMax(it->maxNs, sample.elapsedNs);
+    it->lastRows = sample.rows;
+    it->lastSeen = QDateTime::currentDateTime();
+
+    if ((thresholdMs > 0) && (sample.elapsedNs >= qint64(thresholdMs) * 1000000)) appendSlowLog(sample);
+}
+
+QVector<StatementStats> QueryProfiler::slowest(int count) const
+{
+    QMutexLocker locker(&mutex);
+    QVector<StatementStats> result(statements.cbegin(), statements.cend());
+
+    std::sort(result.begin(), result.end(),
+              [](const StatementStats& a, const StatementStats& b) {
+        return a.maxNs > b.maxNs;
+    });
+
+    if (result.size() > count) result.resize(count);
+    return result;
+}
+
+void QueryProfiler::clear()
+{
+    QMutexLocker locker(&mutex);
+
+    statements.clear();
+}
+
+int QueryProfiler::slowThresholdMs() const
+{
+    QMutexLocker locker(&mutex);
+
+    return thresholdMs;
+}
+
+void QueryProfiler::setSlowThresholdMs(int ms)
+{
+    QMutexLocker locker(&mutex);
+
+    thresholdMs = ms;
+}
+
+QString QueryProfiler::slowLogPath() const
+{
+    return logPath;
+}
+
+qint64 QueryProfiler::idleMs() const
+{
+    QMutexLocker locker(&mutex);
+
+    return sinceLastQuery.elapsed();
+}
+
+// 调用时已持有 mutex
+void QueryProfiler::appendSlowLog(const QuerySample& sample)
+{
+    const QString elapsed = QString::number(sample.elapsedNs / 1e6, 'f', 1);
+
+    qWarning().noquote() << "慢查询" << elapsed << "ms" << sample.caller << sample.sql;
+
+    QDir().mkpath(QFileInfo(logPath).absolutePath());
+
+    QFile file(logPath);
+
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Append | QIODevice::Text)) return;
+
+    QTextStream stream(&file);
+    stream << QDateTime::currentDateTime().toString(Qt::ISODate) << '\t'
+           << elapsed << "ms\t"
+           << "rows=" << sample.rows << '\t'
+           << "binds=" << sample.bindCount << '\t'
+           << (sample.caller.isEmpty() ? QString("-") : sample.caller) << '\t'
+           << QString(sample.sql).simplified() << '\n';
+}
+
+QString QueryProfiler::explainQueryPlan(const QString     & sql,
+                                        int                 bindCount,
+                                        const QSqlDatabase& database)
+{
+    QSqlQuery query(database);
+
+    query.setForwardOnly(true);
+
+    if (!query.prepare("EXPLAIN QUERY PLAN " + sql)) return query.lastError().text();
+
+    for (int i = 0; i < bindCount; ++i) query.addBindValue(QVariant());
+
+    if (!query.exec()) return query.lastError().text();
+
+    // 每行为 id, parent, notused, detail，按 parent 缩进成树形
+    QStringList   lines;
+    QHash<int, int> depth;
+
+    while (query.next()) {
+        const int level = depth.value(query.value(1).toInt(), -1) + 1;
+        depth.insert(query.value(0).toInt(), level);
+        lines << QString(level * 2, ' ') + query.value(3).toString();
+    }
+    return lines.join('\n');
+}
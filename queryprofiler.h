@@ -0,0 +1,84 @@
+#ifndef QUERYPROFILER_H
+#define QUERYPROFILER_H
+
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QMutex>
+#include <QSqlDatabase>
+#include <QString>
+#include <QVector>
+
+// 一次查询的执行情况
+struct QuerySample {
+    QString sql;
+    int     bindCount = 0;
+    qint64  elapsedNs = 0; // exec() 和逐行 next() 花费的时间之和
+    qint64  rows = 0;      // SELECT 为读取的行数，其余为受影响的行数
+    QString caller;
+};
+
+// 同一条 SQL 的累计统计
+struct StatementStats {
+    QString   sql;
+    QString   caller; // 最近一次执行时的调用方
+    int       bindCount = 0;
+    qint64    calls = 0;
+    qint64    totalNs = 0;
+    qint64    maxNs = 0;
+    qint64    lastRows = 0;
+    QDateTime lastSeen;
+};
+
+// 查询性能统计：Repository 执行的每条 SQL 都会记录到这里。
+// 超过阈值的查询写入慢查询日志，诊断面板按最大耗时列出最慢的语句
+class QueryProfiler {
+public:
+
+    static QueryProfiler& instance();
+
+    // 在作用域内把执行的查询记到 name 名下，可以嵌套，离开作用域时恢复外层调用方
+    class CallerScope {
+    public:
+
+        explicit CallerScope(const char *name);
+        ~CallerScope();
+
+    private:
+
+        const char *previous;
+    };
+
+    static QString          currentCaller();
+
+    void                    record(const QuerySample& sample);
+
+    // 按最大耗时降序
+    QVector<StatementStats> slowest(int count) const;
+    void                    clear();
+
+    int                     slowThresholdMs() const;
+    void                    setSlowThresholdMs(int ms);
+    QString                 slowLogPath() const;
+
+    // 距离最近一次记录的查询过去的毫秒数，数据库维护据此判断程序是否空闲
+    qint64                  idleMs() const;
+
+    // 对 sql 执行 EXPLAIN QUERY PLAN，参数全部绑定为 NULL，返回查询计划文本
+    static QString          explainQueryPlan(const QString     & sql,
+                                             int                 bindCount,
+                                             const QSqlDatabase& database = QSqlDatabase::database());
+
+private:
+
+    QueryProfiler();
+    void                    appendSlowLog(const QuerySample& sample);
+
+    mutable QMutex mutex;
+    QHash<QString, StatementStats> statements;
+    int     thresholdMs;
+    QString logPath;
+    QElapsedTimer sinceLastQuery;
+};
+
+#endif // QUERYPROFILER_H
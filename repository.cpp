@@ -0,0 +1,118 @@
+#include "repository.h"
+#include <QElapsedTimer>
+#include <QSqlError>
+
+Repository::Repository(const QSqlDatabase& database)
+    : db(database)
+{}
+
+Repository::~Repository()
+{
+    finishSample();
+}
+
+bool Repository::transaction()
+{
+    if (db.transaction()) return true;
+
+    error = db.lastError().text();
+    return false;
+}
+
+bool Repository::commit()
+{
+    if (db.commit()) return true;
+
+    error = db.lastError().text();
+    return false;
+}
+
+bool Repository::rollback()
+{
+    if (db.rollback()) return true;
+
+    error = db.lastError().text();
+    return false;
+}
+
+QSqlQuery Repository::prepare(const QString& sql)
+{
+    QSqlQuery query(db);
+
+    query.setForwardOnly(true);
+
+    if (!query.prepare(sql)) error = query.lastError().text();
+    return query;
+}
+
+bool Repository::exec(QSqlQuery& query)
+{
+    finishSample();
+
+    QElapsedTimer timer;
+    timer.start();
+
+    const bool ok = query.exec();
+
+    sample.sql = query.lastQuery();
+    sample.bindCount = query.boundValues().size();
+    sample.elapsedNs = timer.nsecsElapsed();
+    sample.rows = 0;
+    sample.caller = QueryProfiler::currentCaller();
+    sampling = true;
+
+    if (!ok) error = query.lastError().text();
+
+    if (!ok || !query.isSelect()) {
+        sample.rows = query.numRowsAffected();
+        finishSample();
+    }
+    return ok;
+}
+
+bool Repository::execBatch(QSqlQuery& query)
+{
+    finishSample();
+
+    QElapsedTimer timer;
+    timer.start();
+
+    const bool ok = query.execBatch();
+
+    sample.sql = query.lastQuery();
+    sample.bindCount = query.boundValues().size();
+    sample.elapsedNs = timer.nsecsElapsed();
+    sample.rows = query.numRowsAffected();
+    sample.caller = QueryProfiler::currentCaller();
+    sampling = true;
+    finishSample();
+
+    if (ok) return true;
+
+    error = query.lastError().text();
+    return false;
+}
+
+bool Repository::next(QSqlQuery& query)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    const bool hasRow = query.next();
+
+    if (!sampling) return hasRow;
+
+    sample.elapsedNs += timer.nsecsElapsed();
+
+    if (hasRow) sample.rows++;
+    else finishSample();
+    return hasRow;
+}
+
+void Repository::finishSample()
+{
+    if (!sampling) return;
+
+    sampling = false;
+    QueryProfiler::instance().record(sample);
+}
@@ -0,0 +1,52 @@
+#ifndef REPOSITORY_H
+#define REPOSITORY_H
+
+#include "queryprofiler.h"
+#include <QSqlDatabase>
+#include <QSqlQuery>
+#include <QString>
+
+// 各数据仓库的公共部分：持有数据库连接并记录最近一次错误。
+// 仓库本身不开启事务，需要原子性时由调用方通过 transaction()/commit() 控制。
+// 所有查询经过 exec()/next() 执行，耗时和行数记录到 QueryProfiler
+class Repository {
+public:
+
+    explicit Repository(const QSqlDatabase& database = QSqlDatabase::database());
+    ~Repository();
+
+    QString lastError() const {
+        return error;
+    }
+
+    QSqlDatabase database() const {
+        return db;
+    }
+
+    bool transaction();
+    bool commit();
+    bool rollback();
+
+protected:
+
+    // 生成只向前遍历的查询，QSQLITE 不会缓存已读过的行
+    QSqlQuery prepare(const QString& sql);
+    bool      exec(QSqlQuery& query);
+    bool      execBatch(QSqlQuery& query);
+
+    // 代替 query.next()，读取时间和行数计入当前查询的统计
+    bool      next(QSqlQuery& query);
+
+    QSqlDatabase db;
+    QString error;
+
+private:
+
+    // SELECT 在读完最后一行、执行下一条查询或仓库析构时提交统计
+    void      finishSample();
+
+    QuerySample sample;
+    bool        sampling = false;
+};
+
+#endif // REPOSITORY_H
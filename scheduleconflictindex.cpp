@@ -0,0 +1,86 @@
+#include "scheduleconflictindex.h"
+
+ScheduleConflictIndex::ScheduleConflictIndex(int lessonMinutes)
+    : lessonLength(qMax(1, lessonMinutes))
+{}
+
+void ScheduleConflictIndex::clear()
+{
+    students.clear();
+    loadedStudents.clear();
+}
+
+bool ScheduleConflictIndex::load(ScheduleRepository& repository, const QDate& from,
+                                 const QDate& to)
+{
+    clear();
+
+    // 跨午夜的课程可能与前一天的课程重叠，多读一天
+    return repository.forEach(from.addDays(-1), to.addDays(1), [this](const ScheduleEntry& entry) {
+        add(entry);
+        return true;
+    });
+}
+
+bool ScheduleConflictIndex::loadStudent(ScheduleRepository& repository, const QString& studentId)
+{
+    if (studentId.isEmpty() || loadedStudents.contains(studentId)) return true;
+
+    loadedStudents.insert(studentId);
+    return repository.forEach(QDate(), QDate(), studentId, [this](const ScheduleEntry& entry) {
+        add(entry);
+        return true;
+    });
+}
+
+void ScheduleConflictIndex::add(const ScheduleEntry& entry)
+{
+    if (indexed(entry)) students[entry.studentId].emplace(startMinute(entry), entry);
+}
+
+void ScheduleConflictIndex::remove(const ScheduleEntry& entry)
+{
+    if (!indexed(entry)) return;
+
+    auto student = students.find(entry.studentId);
+
+    if (student == students.end()) return;
+
+    auto range = student->equal_range(startMinute(entry));
+
+    for (auto it = range.first; it != range.second; ++it) {
+        if ((it->second.date == entry.date) && (it->second.slot == entry.slot)) {
+            student->erase(it);
+            return;
+        }
+    }
+}
+
+std::optional<ScheduleEntry> ScheduleConflictIndex::findConflict(const ScheduleEntry& entry) const
+{
+    if (!indexed(entry)) return std::nullopt;
+
+    auto student = students.constFind(entry.studentId);
+
+    if (student == students.constEnd()) return std::nullopt;
+
+    const qint64 start = startMinute(entry);
+
+    for (auto it = student->upper_bound(start - lessonLength);
+         (it != student->end()) && (it->first < start + lessonLength); ++it) {
+        if ((it->second.date == entry.date) && (it->second.slot == entry.slot)) continue;
+
+        return it->second;
+    }
+    return std::nullopt;
+}
+
+bool ScheduleConflictIndex::indexed(const ScheduleEntry& entry)
+{
+    return !entry.studentId.isEmpty() && entry.date.isValid() && entry.startTime.isValid();
+}
+
+qint64 ScheduleConflictIndex::startMinute(const ScheduleEntry& entry)
+{
+    return entry.date.toJulianDay() * 24 * 60 + entry.startTime.msecsSinceStartOfDay() / 60000;
+}
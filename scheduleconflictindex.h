@@ -0,0 +1,50 @@
+#ifndef SCHEDULECONFLICTINDEX_H
+#define SCHEDULECONFLICTINDEX_H
+
+#include "schedulerepository.h"
+#include <QHash>
+#include <QSet>
+#include <map>
+#include <optional>
+
+// 按学生索引已排课程的时间区间，用于检查同一学生的课程时间是否重叠。
+// 每节课时长相同，与 [start, start + lessonMinutes) 重叠的课程开始时间一定落在
+// (start - lessonMinutes, start + lessonMinutes) 内，因此按开始时间排序后
+// 一次 lower_bound 即可定位，添加和查询都是 O(log n)
+class ScheduleConflictIndex {
+public:
+
+    static constexpr int defaultLessonMinutes = 90;
+
+    explicit ScheduleConflictIndex(int lessonMinutes = defaultLessonMinutes);
+
+    void clear();
+
+    // 读取 [from, to] 内的课程建立索引，之前的内容会被清空
+    bool load(ScheduleRepository& repository, const QDate& from, const QDate& to);
+
+    // 读取某个学生的全部课程加入索引，已读取过的学生不再重复读取
+    bool loadStudent(ScheduleRepository& repository, const QString& studentId);
+
+    // 没有关联学生或没有开始时间的课程不参与检查
+    void add(const ScheduleEntry& entry);
+    void remove(const ScheduleEntry& entry);
+
+    // 与 entry 时间重叠的同一学生的课程；同一日期同一时间段的课程视为被 entry 替换，不算冲突
+    std::optional<ScheduleEntry> findConflict(const ScheduleEntry& entry) const;
+
+    int lessonMinutes() const {
+        return lessonLength;
+    }
+
+private:
+
+    static bool indexed(const ScheduleEntry& entry);
+    static qint64 startMinute(const ScheduleEntry& entry);
+
+    int lessonLength;
+    QHash<QString, std::multimap<qint64, ScheduleEntry> > students;
+    QSet<QString> loadedStudents;
+};
+
+#endif // SCHEDULECONFLICTINDEX_H
@@ -0,0 +1,171 @@
+#include "scheduleloaddialog.h"
+#include "schedulerepository.h"
+#include "eventloopmonitor.h"
+#include <QDateEdit>
+#include <QHBoxLayout>
+#include <QHeaderView>
+#include <QLabel>
+#include <QMessageBox>
+#include <QPushButton>
+#include <QSplitter>
+#include <QTableWidget>
+#include <QVBoxLayout>
+
+namespace {
+// 区间内某个星期几（1～7）出现的次数，用于把课程数换算成占用率
+int weekdayCount(const QDate& from, const QDate& to, int dayOfWeek)
+{
+    const int days = from.daysTo(to) + 1;
+    const int offset = (dayOfWeek - from.dayOfWeek() + 7) % 7;
+
+    return offset < days ? (days - offset - 1) / 7 + 1 : 0;
+}
+}
+
+ScheduleLoadDialog::ScheduleLoadDialog(const QDate& from, const QDate& to, QWidget *parent)
+    : QDialog(parent)
+{
+    setWindowTitle("课时统计");
+    resize(900, 560);
+    createUI();
+    fromEdit->setDate(from);
+    toEdit->setDate(to);
+    refresh();
+}
+
+void ScheduleLoadDialog::createUI()
+{
+    QVBoxLayout *mainLayout = new QVBoxLayout(this);
+    QHBoxLayout *rangeLayout = new QHBoxLayout();
+
+    fromEdit = new QDateEdit(this);
+    toEdit = new QDateEdit(this);
+    fromEdit->setDisplayFormat("yyyy-MM-dd");
+    toEdit->setDisplayFormat("yyyy-MM-dd");
+    fromEdit->setCalendarPopup(true);
+    toEdit->setCalendarPopup(true);
+
+    QPushButton *refreshButton = new QPushButton("统计", this);
+    connect(refreshButton, &QPushButton::clicked, this, &ScheduleLoadDialog::refresh);
+
+    rangeLayout->addWidget(new QLabel("从", this));
+    rangeLayout->addWidget(fromEdit);
+    rangeLayout->addWidget(new QLabel("到", this));
+    rangeLayout->addWidget(toEdit);
+    rangeLayout->addWidget(refreshButton);
+    rangeLayout->addStretch();
+
+    // 热力图：行为星期几，列为时间段，颜色越深占用越多
+    heatmapTable = new QTableWidget(7, ScheduleRepository::slotLabels().size(), this);
+    heatmapTable->setHorizontalHeaderLabels(ScheduleRepository::slotLabels());
+    heatmapTable->setVerticalHeaderLabels(
+        { "星期一", "星期二", "星期三", "星期四", "星期五", "星期六", "星期日" });
+    heatmapTable->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    heatmapTable->horizontalHeader()->setSectionResizeMode(QHeaderView::Stretch);
+    heatmapTable->verticalHeader()->setSectionResizeMode(QHeaderView::Stretch);
+
+    studentTable = new QTableWidget(0, 5, this);
+    studentTable->setHorizontalHeaderLabels({ "学号", "姓名", "课时", "上课天数", "周均课时" });
+    studentTable->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    studentTable->setSelectionBehavior(QAbstractItemView::SelectRows);
+    studentTable->setSortingEnabled(true);
+    studentTable->horizontalHeader()->setSectionResizeMode(QHeaderView::Stretch);
+    studentTable->verticalHeader()->hide();
+
+    QSplitter *splitter = new QSplitter(this);
+    splitter->addWidget(heatmapTable);
+    splitter->addWidget(studentTable);
+    splitter->setStretchFactor(0, 3);
+    splitter->setStretchFactor(1, 2);
+
+    busiestLabel = new QLabel(this);
+    busiestLabel->setWordWrap(true);
+
+    mainLayout->addLayout(rangeLayout);
+    mainLayout->addWidget(splitter);
+    mainLayout->addWidget(busiestLabel);
+}
+
+void ScheduleLoadDialog::refresh()
+{
+    EventLoopMonitor::ActivityScope activity(Q_FUNC_INFO);
+
+    const QDate from = fromEdit->date();
+    const QDate to = toEdit->date();
+
+    if (from > to) {
+        QMessageBox::warning(this, "错误", "起始日期不能晚于结束日期！");
+        return;
+    }
+
+    ScheduleRepository repository;
+    const QVector<QVector<int> > counts = repository.slotOccupancy(from, to);
+    const QVector<StudentLoad>   students = repository.studentLoad(from, to);
+    const QVector<DayLoad>       busiest = repository.busiestDays(from, to, 5);
+
+    if (!repository.lastError().isEmpty()) {
+        QMessageBox::critical(this, "错误", "统计失败：" + repository.lastError());
+        return;
+    }
+
+    fillHeatmap(counts);
+
+    // 区间内的周数，不足一周按一周计
+    const double weeks = qMax(1.0, (from.daysTo(to) + 1) / 7.0);
+
+    studentTable->setSortingEnabled(false);
+    studentTable->setRowCount(students.size());
+
+    for (int row = 0; row < students.size(); ++row) {
+        const StudentLoad& load = students[row];
+        QTableWidgetItem  *lessons = new QTableWidgetItem();
+        QTableWidgetItem  *days = new QTableWidgetItem();
+        QTableWidgetItem  *perWeek = new QTableWidgetItem();
+
+        // 数值列按数字排序
+        lessons->setData(Qt::DisplayRole, load.lessons);
+        days->setData(Qt::DisplayRole, load.days);
+        perWeek->setData(Qt::DisplayRole, qRound(load.lessons / weeks * 10) / 10.0);
+
+        studentTable->setItem(row, 0, new QTableWidgetItem(load.studentId));
+        studentTable->setItem(row, 1, new QTableWidgetItem(
+                                  load.studentId.isEmpty() ? "未关联学生" : load.studentName));
+        studentTable->setItem(row, 2, lessons);
+        studentTable->setItem(row, 3, days);
+        studentTable->setItem(row, 4, perWeek);
+    }
+    studentTable->setSortingEnabled(true);
+
+    QStringList days;
+
+    for (const DayLoad& day : busiest) {
+        days << QString("%1（%2 节）").arg(day.date.toString("yyyy-MM-dd")).arg(day.lessons);
+    }
+    busiestLabel->setText("课程最多的日期：" + (days.isEmpty() ? QString("无") : days.join("，")));
+}
+
+void ScheduleLoadDialog::fillHeatmap(const QVector<QVector<int> >& counts)
+{
+    const QDate from = fromEdit->date();
+    const QDate to = toEdit->date();
+
+    for (int day = 0; day < counts.size(); ++day) {
+        // 占用率 = 课程数 / 区间内该星期几出现的次数
+        const int occurrences = weekdayCount(from, to, day + 1);
+
+        for (int slot = 0; slot < counts[day].size(); ++slot) {
+            const int    lessons = counts[day][slot];
+            const double ratio = occurrences > 0 ? double(lessons) / occurrences : 0;
+
+            QTableWidgetItem *item = new QTableWidgetItem(
+                QString("%1\n%2%").arg(lessons).arg(qRound(ratio * 100)));
+            item->setTextAlignment(Qt::AlignCenter);
+
+            // 白色到红色插值
+            const int shade = 255 - qRound(qBound(0.0, ratio, 1.0) * 200);
+            item->setBackground(QColor(255, shade, shade));
+            item->setForeground(ratio > 0.6 ? QColor(Qt::white) : QColor(Qt::black));
+            heatmapTable->setItem(day, slot, item);
+        }
+    }
+}
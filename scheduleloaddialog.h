@@ -0,0 +1,33 @@
+#ifndef SCHEDULELOADDIALOG_H
+#define SCHEDULELOADDIALOG_H
+
+#include <QDialog>
+#include <QDate>
+
+class QDateEdit;
+class QTableWidget;
+class QLabel;
+
+// 课时统计：任意日期区间内按星期几 × 时间段的占用热力图、每个学生的课时和最忙的日期。
+// 汇总在 SQL 中完成，区间再长也只读回几十行
+class ScheduleLoadDialog : public QDialog {
+    Q_OBJECT
+
+public:
+
+    ScheduleLoadDialog(const QDate& from, const QDate& to, QWidget *parent = nullptr);
+
+private:
+
+    void createUI();
+    void refresh();
+    void fillHeatmap(const QVector<QVector<int> >& counts);
+
+    QDateEdit *fromEdit;
+    QDateEdit *toEdit;
+    QTableWidget *heatmapTable;
+    QTableWidget *studentTable;
+    QLabel *busiestLabel;
+};
+
+#endif // SCHEDULELOADDIALOG_H
@@ -0,0 +1,88 @@
+#include "schedulerangemodel.h"
+#include "schedulerepository.h"
+#include <QBrush>
+#include <QColor>
+
+ScheduleRangeModel::ScheduleRangeModel(QObject *parent)
+    : QAbstractTableModel(parent)
+{}
+
+bool ScheduleRangeModel::load(const QDate& from, const QDate& to, const QStringList& timeSlots)
+{
+    QVector<QVector<QString> > loaded(from.daysTo(to) + 1, QVector<QString>(timeSlots.count()));
+    ScheduleRepository repository;
+
+    bool ok = repository.forEach(from, to, [&](const ScheduleEntry& entry) {
+        int dayIndex = from.daysTo(entry.date);
+
+        if ((dayIndex >= 0) && (dayIndex < loaded.size()) &&
+            (entry.slot >= 0) && (entry.slot < timeSlots.count())) {
+            loaded[dayIndex][entry.slot] = entry.displayText();
+        }
+        return true;
+    });
+
+    error = repository.lastError();
+
+    if (!ok) return false;
+
+    beginResetModel();
+    startDate = from;
+    times = timeSlots;
+    courses = std::move(loaded);
+    endResetModel();
+    return true;
+}
+
+QDate ScheduleRangeModel::dateAt(int row) const
+{
+    return startDate.addDays(row);
+}
+
+int ScheduleRangeModel::rowCount(const QModelIndex& parent) const
+{
+    return parent.isValid() ? 0 : courses.size();
+}
+
+int ScheduleRangeModel::columnCount(const QModelIndex& parent) const
+{
+    return parent.isValid() ? 0 : times.size();
+}
+
+QVariant ScheduleRangeModel::data(const QModelIndex& index, int role) const
+{
+    if (!index.isValid()) return QVariant();
+
+    const QString& course = courses[index.row()][index.column()];
+
+    switch (role) {
+    case Qt::DisplayRole:
+    case Qt::ToolTipRole:
+        return course.isEmpty() ? QVariant() : QVariant(course);
+
+    case Qt::TextAlignmentRole:
+        return int(Qt::AlignCenter);
+
+    case Qt::BackgroundRole:
+
+        // 周末浅色底纹，便于在长列表中区分每一周
+        if (dateAt(index.row()).dayOfWeek() >= Qt::Saturday) return QBrush(QColor(0xf2, 0xf2, 0xf2));
+
+        return QVariant();
+
+    default:
+        return QVariant();
+    }
+}
+
+QVariant ScheduleRangeModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (role != Qt::DisplayRole) return QVariant();
+
+    if (orientation == Qt::Horizontal) return times.value(section);
+
+    static const QStringList days = { "一", "二", "三", "四", "五", "六", "日" };
+    const QDate date = dateAt(section);
+
+    return QString("%1 周%2").arg(date.toString("MM/dd")).arg(days[date.dayOfWeek() - 1]);
+}
@@ -0,0 +1,45 @@
+#ifndef SCHEDULERANGEMODEL_H
+#define SCHEDULERANGEMODEL_H
+
+#include <QAbstractTableModel>
+#include <QDate>
+#include <QStringList>
+#include <QVector>
+
+// 月视图和学期视图的数据：每行一天，每列一个时间段。
+// 整个日期范围通过一次查询读取，单元格只保存课程名称，不创建 QTableWidgetItem
+class ScheduleRangeModel : public QAbstractTableModel {
+    Q_OBJECT
+
+public:
+
+    explicit ScheduleRangeModel(QObject *parent = nullptr);
+
+    // 读取 [from, to] 内的课程，timeSlots 为各列的表头，列号即时间段序号
+    bool    load(const QDate      & from,
+                 const QDate      & to,
+                 const QStringList& timeSlots);
+
+    QDate   dateAt(int row) const;
+
+    QString lastError() const {
+        return error;
+    }
+
+    int      rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    int      columnCount(const QModelIndex& parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex& index,
+                  int                role = Qt::DisplayRole) const override;
+    QVariant headerData(int             section,
+                        Qt::Orientation orientation,
+                        int             role = Qt::DisplayRole) const override;
+
+private:
+
+    QDate startDate;
+    QStringList times;
+    QVector<QVector<QString> > courses; // [天][时间段]
+    QString error;
+};
+
+#endif // SCHEDULERANGEMODEL_H
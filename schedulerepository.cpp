@@ -0,0 +1,392 @@
+#include "schedulerepository.h"
+
+namespace {
+// 按 (date, slot, student_id, start_time, note, rule_id) 的顺序绑定，空字段写入 NULL
+void bindEntry(QSqlQuery& query, const ScheduleEntry& entry)
+{
+    query.addBindValue(entry.date.toString("yyyy-MM-dd"));
+    query.addBindValue(entry.slot);
+    query.addBindValue(entry.studentId.isEmpty() ? QVariant() : QVariant(entry.studentId));
+    query.addBindValue(entry.startTime.isValid()
+                       ? QVariant(entry.startTime.toString("HH:mm")) : QVariant());
+    query.addBindValue(entry.note.isEmpty() ? QVariant() : QVariant(entry.note));
+    query.addBindValue(entry.ruleId > 0 ? QVariant(entry.ruleId) : QVariant());
+}
+}
+
+QString ScheduleEntry::displayText() const
+{
+    if (studentId.isEmpty()) return note;
+
+    const QString name = studentName.isEmpty() ? studentId : studentName;
+
+    return startTime.isValid() ? name + ',' + startTime.toString("HH:mm") : name;
+}
+
+const QStringList& ScheduleRepository::slotLabels()
+{
+    static const QStringList labels = { "上午1", "上午2", "下午1", "下午2", "晚上1", "晚上2" };
+
+    return labels;
+}
+
+QTime ScheduleRepository::defaultStartTime(int slot)
+{
+    static const QVector<QTime> presets = {
+        QTime(9, 0), QTime(11, 0), QTime(14, 0), QTime(16, 0), QTime(19, 0), QTime(21, 0)
+    };
+
+    return presets.value(slot);
+}
+
+QVector<ScheduleEntry> ScheduleRepository::loadRange(const QDate& from, const QDate& to)
+{
+    QVector<ScheduleEntry> entries;
+
+    forEach(from, to, [&entries](const ScheduleEntry& entry) {
+        entries.append(entry);
+        return true;
+    });
+    return entries;
+}
+
+QVector<ScheduleEntry> ScheduleRepository::loadForStudent(const QString& studentId,
+                                                          const QDate  & from,
+                                                          const QDate  & to)
+{
+    QVector<ScheduleEntry> entries;
+
+    forEach(from, to, studentId, [&entries](const ScheduleEntry& entry) {
+        entries.append(entry);
+        return true;
+    });
+    return entries;
+}
+
+bool ScheduleRepository::forEach(const QDate                                   & from,
+                                 const QDate                                   & to,
+                                 const std::function<bool(const ScheduleEntry&)>& callback)
+{
+    return forEach(from, to, QString(), callback);
+}
+
+bool ScheduleRepository::forEach(const QDate                                   & from,
+                                 const QDate                                   & to,
+                                 const QString                                 & studentId,
+                                 const std::function<bool(const ScheduleEntry&)>& callback)
+{
+    QStringList  conditions;
+    QVariantList bindValues;
+
+    if (!studentId.isEmpty()) {
+        conditions << "s.student_id = ?";
+        bindValues << studentId;
+    }
+
+    // 两端都有时用 BETWEEN，走 (date, slot) 主键或 (student_id, date) 索引的一次范围扫描
+    if (from.isValid() && to.isValid()) {
+        conditions << "s.date BETWEEN ? AND ?";
+        bindValues << from.toString("yyyy-MM-dd") << to.toString("yyyy-MM-dd");
+    }
+    else if (from.isValid()) {
+        conditions << "s.date >= ?";
+        bindValues << from.toString("yyyy-MM-dd");
+    }
+    else if (to.isValid()) {
+        conditions << "s.date <= ?";
+        bindValues << to.toString("yyyy-MM-dd");
+    }
+
+    QSqlQuery query = prepare(
+        "SELECT s.date, s.slot, s.student_id, st.name, s.start_time, s.note, s.rule_id "
+        "FROM schedule s LEFT JOIN studentInfo st ON st.id = s.student_id" +
+        (conditions.isEmpty() ? QString() : " WHERE " + conditions.join(" AND ")) +
+        " ORDER BY s.date, s.slot");
+
+    for (const QVariant& value : bindValues) query.addBindValue(value);
+
+    if (!exec(query)) return false;
+
+    while (next(query)) {
+        ScheduleEntry entry;
+        entry.date = QDate::fromString(query.value(0).toString(), "yyyy-MM-dd");
+        entry.slot = query.value(1).toInt();
+        entry.studentId = query.value(2).toString();
+        entry.studentName = query.value(3).toString();
+        entry.startTime = QTime::fromString(query.value(4).toString(), "HH:mm");
+        entry.note = query.value(5).toString();
+        entry.ruleId = query.value(6).toInt();
+
+        if (!callback(entry)) break;
+    }
+    return true;
+}
+
+ScheduleEntry ScheduleRepository::fromText(const QDate& date, int slot, const QString& text)
+{
+    ScheduleEntry entry;
+
+    entry.date = date;
+    entry.slot = slot;
+
+    const QString name = text.section(',', 0, 0).trimmed();
+    const QTime   time = QTime::fromString(text.section(',', 1).trimmed(), "HH:mm");
+
+    QSqlQuery query = prepare("SELECT id FROM studentInfo WHERE name = ? LIMIT 1");
+    query.addBindValue(name);
+
+    if (time.isValid() && exec(query) && next(query)) {
+        entry.studentId = query.value(0).toString();
+        entry.studentName = name;
+        entry.startTime = time;
+    }
+    else entry.note = text;
+
+    return entry;
+}
+
+bool ScheduleRepository::insert(const ScheduleEntry& entry)
+{
+    QSqlQuery query = prepare(
+        "INSERT INTO schedule (date, slot, student_id, start_time, note, rule_id) "
+        "VALUES (?, ?, ?, ?, ?, ?)");
+
+    bindEntry(query, entry);
+    return exec(query);
+}
+
+bool ScheduleRepository::insertBatch(const QVector<ScheduleEntry>& entries)
+{
+    QVariantList dates, slotNumbers, studentIds, startTimes, notes, ruleIds;
+
+    for (const ScheduleEntry& entry : entries) {
+        dates << entry.date.toString("yyyy-MM-dd");
+        slotNumbers << entry.slot;
+        studentIds << (entry.studentId.isEmpty() ? QVariant() : QVariant(entry.studentId));
+        startTimes << (entry.startTime.isValid()
+                       ? QVariant(entry.startTime.toString("HH:mm")) : QVariant());
+        notes << (entry.note.isEmpty() ? QVariant() : QVariant(entry.note));
+        ruleIds << (entry.ruleId > 0 ? QVariant(entry.ruleId) : QVariant());
+    }
+
+    QSqlQuery query = prepare(
+        "INSERT INTO schedule (date, slot, student_id, start_time, note, rule_id) "
+        "VALUES (?, ?, ?, ?, ?, ?)");
+
+    query.addBindValue(dates);
+    query.addBindValue(slotNumbers);
+    query.addBindValue(studentIds);
+    query.addBindValue(startTimes);
+    query.addBindValue(notes);
+    query.addBindValue(ruleIds);
+    return execBatch(query);
+}
+
+bool ScheduleRepository::upsert(const ScheduleEntry& entry)
+{
+    QSqlQuery query = prepare(
+        "INSERT OR REPLACE INTO schedule (date, slot, student_id, start_time, note, rule_id) "
+        "VALUES (?, ?, ?, ?, ?, ?)");
+
+    bindEntry(query, entry);
+    return exec(query);
+}
+
+bool ScheduleRepository::remove(const QDate& date, int slot)
+{
+    QSqlQuery query = prepare("DELETE FROM schedule WHERE date = ? AND slot = ?");
+
+    query.addBindValue(date.toString("yyyy-MM-dd"));
+    query.addBindValue(slot);
+    return exec(query);
+}
+
+QVector<ScheduleEntry> ScheduleRule::expand() const
+{
+    QVector<ScheduleEntry> lessons;
+
+    if (!firstDate.isValid() || !lastDate.isValid()) return lessons;
+
+    for (QDate date = firstDate.addDays((dayOfWeek - firstDate.dayOfWeek() + 7) % 7);
+         date <= lastDate; date = date.addDays(7)) {
+        if (exceptions.contains(date)) continue;
+
+        ScheduleEntry entry;
+        entry.date = date;
+        entry.slot = slot;
+        entry.studentId = studentId;
+        entry.studentName = studentName;
+        entry.startTime = startTime;
+        entry.ruleId = id;
+        lessons.append(entry);
+    }
+    return lessons;
+}
+
+bool ScheduleRepository::insertRule(ScheduleRule& rule, const QVector<ScheduleEntry>& lessons)
+{
+    if (!transaction()) return false;
+
+    QSqlQuery query = prepare(
+        "INSERT INTO scheduleRules (student_id, day_of_week, slot, start_time, first_date, last_date) "
+        "VALUES (?, ?, ?, ?, ?, ?)");
+
+    query.addBindValue(rule.studentId);
+    query.addBindValue(rule.dayOfWeek);
+    query.addBindValue(rule.slot);
+    query.addBindValue(rule.startTime.toString("HH:mm"));
+    query.addBindValue(rule.firstDate.toString("yyyy-MM-dd"));
+    query.addBindValue(rule.lastDate.toString("yyyy-MM-dd"));
+
+    bool ok = exec(query);
+
+    if (ok) {
+        rule.id = query.lastInsertId().toInt();
+
+        if (!rule.exceptions.isEmpty()) {
+            QVariantList ruleIds, dates;
+
+            for (const QDate& date : rule.exceptions) {
+                ruleIds << rule.id;
+                dates << date.toString("yyyy-MM-dd");
+            }
+
+            QSqlQuery exceptionQuery = prepare(
+                "INSERT OR IGNORE INTO scheduleExceptions (rule_id, date) VALUES (?, ?)");
+            exceptionQuery.addBindValue(ruleIds);
+            exceptionQuery.addBindValue(dates);
+            ok = execBatch(exceptionQuery);
+        }
+    }
+
+    if (ok && !lessons.isEmpty()) {
+        QVector<ScheduleEntry> tagged = lessons;
+
+        for (ScheduleEntry& entry : tagged) entry.ruleId = rule.id;
+        ok = insertBatch(tagged);
+    }
+
+    if (ok && commit()) return true;
+
+    rollback();
+    rule.id = 0;
+    return false;
+}
+
+QVector<ScheduleRule> ScheduleRepository::loadRules()
+{
+    QVector<ScheduleRule> rules;
+    QSqlQuery query = prepare(
+        "SELECT r.id, r.student_id, st.name, r.day_of_week, r.slot, r.start_time, "
+        "r.first_date, r.last_date, "
+        "(SELECT COUNT(*) FROM schedule s WHERE s.rule_id = r.id) "
+        "FROM scheduleRules r LEFT JOIN studentInfo st ON st.id = r.student_id "
+        "ORDER BY r.last_date DESC, r.id DESC");
+
+    if (!exec(query)) return rules;
+
+    while (next(query)) {
+        ScheduleRule rule;
+        rule.id = query.value(0).toInt();
+        rule.studentId = query.value(1).toString();
+        rule.studentName = query.value(2).toString();
+        rule.dayOfWeek = query.value(3).toInt();
+        rule.slot = query.value(4).toInt();
+        rule.startTime = QTime::fromString(query.value(5).toString(), "HH:mm");
+        rule.firstDate = QDate::fromString(query.value(6).toString(), "yyyy-MM-dd");
+        rule.lastDate = QDate::fromString(query.value(7).toString(), "yyyy-MM-dd");
+        rule.lessons = query.value(8).toInt();
+        rules.append(rule);
+    }
+    return rules;
+}
+
+bool ScheduleRepository::stopRule(int ruleId, const QDate& from)
+{
+    if (!transaction()) return false;
+
+    QSqlQuery lessons = prepare("DELETE FROM schedule WHERE rule_id = ? AND date >= ?");
+    lessons.addBindValue(ruleId);
+    lessons.addBindValue(from.toString("yyyy-MM-dd"));
+
+    QSqlQuery rule = prepare(
+        "UPDATE scheduleRules SET last_date = MIN(last_date, ?) WHERE id = ?");
+    rule.addBindValue(from.addDays(-1).toString("yyyy-MM-dd"));
+    rule.addBindValue(ruleId);
+
+    if (exec(lessons) && exec(rule) && commit()) return true;
+
+    rollback();
+    return false;
+}
+
+QVector<StudentLoad> ScheduleRepository::studentLoad(const QDate& from, const QDate& to)
+{
+    QVector<StudentLoad> rows;
+    QSqlQuery query = prepare(
+        "SELECT s.student_id, st.name, COUNT(*), COUNT(DISTINCT s.date), MIN(s.date), MAX(s.date) "
+        "FROM schedule s LEFT JOIN studentInfo st ON st.id = s.student_id "
+        "WHERE s.date BETWEEN ? AND ? "
+        "GROUP BY s.student_id ORDER BY COUNT(*) DESC, s.student_id");
+
+    query.addBindValue(from.toString("yyyy-MM-dd"));
+    query.addBindValue(to.toString("yyyy-MM-dd"));
+
+    if (!exec(query)) return rows;
+
+    while (next(query)) {
+        StudentLoad row;
+        row.studentId = query.value(0).toString();
+        row.studentName = query.value(1).toString();
+        row.lessons = query.value(2).toInt();
+        row.days = query.value(3).toInt();
+        row.firstDate = QDate::fromString(query.value(4).toString(), "yyyy-MM-dd");
+        row.lastDate = QDate::fromString(query.value(5).toString(), "yyyy-MM-dd");
+        rows.append(row);
+    }
+    return rows;
+}
+
+QVector<QVector<int> > ScheduleRepository::slotOccupancy(const QDate& from, const QDate& to)
+{
+    QVector<QVector<int> > counts(7, QVector<int>(slotLabels().size(), 0));
+
+    // strftime('%w') 中星期日为 0
+    QSqlQuery query = prepare(
+        "SELECT CAST(strftime('%w', date) AS INTEGER), slot, COUNT(*) FROM schedule "
+        "WHERE date BETWEEN ? AND ? GROUP BY 1, 2");
+
+    query.addBindValue(from.toString("yyyy-MM-dd"));
+    query.addBindValue(to.toString("yyyy-MM-dd"));
+
+    if (!exec(query)) return counts;
+
+    while (next(query)) {
+        const int weekday = query.value(0).toInt();
+        const int slot = query.value(1).toInt();
+        const int dayIndex = weekday == 0 ? 6 : weekday - 1;
+
+        if ((slot >= 0) && (slot < slotLabels().size())) counts[dayIndex][slot] = query.value(2).toInt();
+    }
+    return counts;
+}
+
+QVector<DayLoad> ScheduleRepository::busiestDays(const QDate& from, const QDate& to, int limit)
+{
+    QVector<DayLoad> rows;
+    QSqlQuery query = prepare(
+        "SELECT date, COUNT(*) FROM schedule WHERE date BETWEEN ? AND ? "
+        "GROUP BY date ORDER BY COUNT(*) DESC, date LIMIT ?");
+
+    query.addBindValue(from.toString("yyyy-MM-dd"));
+    query.addBindValue(to.toString("yyyy-MM-dd"));
+    query.addBindValue(limit);
+
+    if (!exec(query)) return rows;
+
+    while (next(query)) {
+        rows.append({ QDate::fromString(query.value(0).toString(), "yyyy-MM-dd"),
+                      query.value(1).toInt() });
+    }
+    return rows;
+}
@@ -0,0 +1,117 @@
+#ifndef SCHEDULEREPOSITORY_H
+#define SCHEDULEREPOSITORY_H
+
+#include "repository.h"
+#include <QDate>
+#include <QTime>
+#include <QVector>
+#include <functional>
+
+// schedule 表的一行。课程通过 student_id 关联学生，时间段保存为序号
+struct ScheduleEntry {
+    QDate   date;
+    int     slot = -1;   // 时间段序号，对应 ScheduleRepository::slotLabels()
+    QString studentId;   // 为空表示手工输入、没有对应学生的课程
+    QString studentName; // 读取时由 studentInfo 关联得到，写入时忽略
+    QTime   startTime;
+    QString note;        // 没有对应学生时保存输入的原文
+    int     ruleId = 0;  // 由周期规则生成时为规则 id，手工添加为 0
+
+    // 界面上显示的"姓名,HH:mm"，没有对应学生时为原文
+    QString displayText() const;
+};
+
+// 课时统计：某个学生在统计区间内的课程数
+struct StudentLoad {
+    QString studentId; // 为空表示没有关联学生的课程
+    QString studentName;
+    int     lessons = 0;
+    int     days = 0;  // 有课的天数
+    QDate   firstDate;
+    QDate   lastDate;
+};
+
+// 课时统计：某一天的课程数，用于找出排课过满的日期
+struct DayLoad {
+    QDate date;
+    int   lessons = 0;
+};
+
+// 周期排课规则：每周 dayOfWeek 的 slot 时间段，在 [firstDate, lastDate] 内重复，
+// 例外日期不上课。规则保存一份，保存时一次性生成全部课程
+struct ScheduleRule {
+    int            id = 0;
+    QString        studentId;
+    QString        studentName; // 读取时由 studentInfo 关联得到
+    int            dayOfWeek = Qt::Monday;
+    int            slot = 0;
+    QTime          startTime;
+    QDate          firstDate;
+    QDate          lastDate;
+    QVector<QDate> exceptions;
+    int            lessons = 0; // 读取时统计的已生成课程数
+
+    // 规则覆盖的全部上课日期（已去掉例外日期），不访问数据库
+    QVector<ScheduleEntry> expand() const;
+};
+
+class ScheduleRepository : public Repository {
+public:
+
+    using Repository::Repository;
+
+    // 时间段序号对应的名称："上午1"、"上午2"...
+    static const QStringList& slotLabels();
+
+    // 添加课程时各时间段预设的开始时间
+    static QTime              defaultStartTime(int slot);
+
+    // 读取 [from, to] 日期范围内的全部课程
+    QVector<ScheduleEntry> loadRange(const QDate& from, const QDate& to);
+
+    // 某个学生在 [from, to] 内的课程，走 (student_id, date) 索引
+    QVector<ScheduleEntry> loadForStudent(const QString& studentId,
+                                          const QDate  & from,
+                                          const QDate  & to);
+
+    // 逐行回调，不在内存中保留结果集；日期无效表示不限，studentId 为空表示全部学生
+    bool                   forEach(const QDate                                   & from,
+                                   const QDate                                   & to,
+                                   const std::function<bool(const ScheduleEntry&)>& callback);
+    bool                   forEach(const QDate                                   & from,
+                                   const QDate                                   & to,
+                                   const QString                                 & studentId,
+                                   const std::function<bool(const ScheduleEntry&)>& callback);
+
+    // 把表格中手工输入的"姓名,HH:mm"解析为课程，姓名找不到对应学生时原文存入 note
+    ScheduleEntry          fromText(const QDate  & date,
+                                    int            slot,
+                                    const QString& text);
+
+    bool                   insert(const ScheduleEntry& entry);
+    bool                   insertBatch(const QVector<ScheduleEntry>& entries);
+
+    // 同一日期、同一时间段已有课程时覆盖
+    bool                   upsert(const ScheduleEntry& entry);
+    bool                   remove(const QDate& date, int slot);
+
+    // 保存规则并在同一事务中批量写入 lessons（通常为 rule.expand() 去掉冲突后的结果），
+    // 成功后 rule.id 为新规则的 id
+    bool                   insertRule(ScheduleRule& rule, const QVector<ScheduleEntry>& lessons);
+    QVector<ScheduleRule>  loadRules();
+
+    // 停止规则：删除 from 及以后由该规则生成的课程，规则的结束日期改为 from 前一天
+    bool                   stopRule(int ruleId, const QDate& from);
+
+    // 以下统计均在 SQL 中分组汇总，只返回汇总结果
+    // 每个学生在 [from, to] 内的课时，按课时数从多到少
+    QVector<StudentLoad>   studentLoad(const QDate& from, const QDate& to);
+
+    // [from, to] 内按星期几 × 时间段统计的课程数，结果为 [dayOfWeek - 1][slot]
+    QVector<QVector<int> > slotOccupancy(const QDate& from, const QDate& to);
+
+    // [from, to] 内课程数最多的 limit 天
+    QVector<DayLoad>       busiestDays(const QDate& from, const QDate& to, int limit);
+};
+
+#endif // SCHEDULEREPOSITORY_H
@@ -0,0 +1,284 @@
+#include "scheduleruledialog.h"
+#include "scheduleconflictindex.h"
+#include "studentrepository.h"
+#include "eventloopmonitor.h"
+#include <QComboBox>
+#include <QDateEdit>
+#include <QFormLayout>
+#include <QGroupBox>
+#include <QHBoxLayout>
+#include <QHeaderView>
+#include <QLabel>
+#include <QMessageBox>
+#include <QPlainTextEdit>
+#include <QPushButton>
+#include <QRegularExpression>
+#include <QSet>
+#include <QTableWidget>
+#include <QTimeEdit>
+#include <QVBoxLayout>
+
+namespace {
+const QStringList dayNames = { "星期一", "星期二", "星期三", "星期四", "星期五", "星期六", "星期日" };
+
+// 例外日期每行一个，也可以用逗号分隔；无法识别的内容忽略
+QVector<QDate> parseDates(const QString& text)
+{
+    QVector<QDate> dates;
+
+    for (const QString& part : text.split(QRegularExpression("[\\s,，]+"), Qt::SkipEmptyParts)) {
+        QDate date = QDate::fromString(part, "yyyy-MM-dd");
+
+        if (date.isValid()) dates.append(date);
+    }
+    return dates;
+}
+}
+
+ScheduleRuleDialog::ScheduleRuleDialog(const QDate& from, const QDate& to, QWidget *parent)
+    : QDialog(parent)
+{
+    setWindowTitle("周期排课");
+    resize(820, 620);
+    createUI();
+    firstDateEdit->setDate(from);
+    lastDateEdit->setDate(to);
+    loadRules();
+    updatePreview();
+}
+
+void ScheduleRuleDialog::createUI()
+{
+    QVBoxLayout *mainLayout = new QVBoxLayout(this);
+
+    // 已有规则
+    QGroupBox   *rulesGroup = new QGroupBox("已有规则", this);
+    QVBoxLayout *rulesLayout = new QVBoxLayout(rulesGroup);
+
+    ruleTable = new QTableWidget(0, 6, rulesGroup);
+    ruleTable->setHorizontalHeaderLabels({ "学生", "星期", "时间段", "开始时间", "日期范围", "课程数" });
+    ruleTable->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    ruleTable->setSelectionBehavior(QAbstractItemView::SelectRows);
+    ruleTable->setSelectionMode(QAbstractItemView::SingleSelection);
+    ruleTable->horizontalHeader()->setSectionResizeMode(QHeaderView::Stretch);
+    ruleTable->verticalHeader()->hide();
+
+    QPushButton *stopButton = new QPushButton("停止选中规则", rulesGroup);
+    connect(stopButton, &QPushButton::clicked, this, &ScheduleRuleDialog::stopSelectedRule);
+
+    rulesLayout->addWidget(ruleTable);
+    rulesLayout->addWidget(stopButton, 0, Qt::AlignRight);
+
+    // 新规则
+    QGroupBox   *newGroup = new QGroupBox("新建规则", this);
+    QFormLayout *form = new QFormLayout(newGroup);
+
+    studentCombo = new QComboBox(newGroup);
+    StudentRepository studentRepository;
+
+    for (const StudentName& student : studentRepository.loadNames()) {
+        studentCombo->addItem(QString("%1（%2）").arg(student.name, student.id), student.id);
+    }
+
+    dayCombo = new QComboBox(newGroup);
+
+    for (int day = 0; day < dayNames.size(); ++day) dayCombo->addItem(dayNames[day], day + 1);
+
+    slotCombo = new QComboBox(newGroup);
+    slotCombo->addItems(ScheduleRepository::slotLabels());
+
+    startTimeEdit = new QTimeEdit(ScheduleRepository::defaultStartTime(0), newGroup);
+    startTimeEdit->setDisplayFormat("HH:mm");
+
+    firstDateEdit = new QDateEdit(newGroup);
+    lastDateEdit = new QDateEdit(newGroup);
+    firstDateEdit->setDisplayFormat("yyyy-MM-dd");
+    lastDateEdit->setDisplayFormat("yyyy-MM-dd");
+    firstDateEdit->setCalendarPopup(true);
+    lastDateEdit->setCalendarPopup(true);
+
+    exceptionEdit = new QPlainTextEdit(newGroup);
+    exceptionEdit->setPlaceholderText("不上课的日期，每行一个，如 2024-10-01");
+    exceptionEdit->setMaximumHeight(80);
+
+    previewLabel = new QLabel(newGroup);
+
+    QPushButton *createButton = new QPushButton("生成课程", newGroup);
+    connect(createButton, &QPushButton::clicked, this, &ScheduleRuleDialog::createRule);
+
+    form->addRow("学生：", studentCombo);
+    form->addRow("每周：", dayCombo);
+    form->addRow("时间段：", slotCombo);
+    form->addRow("开始时间：", startTimeEdit);
+    form->addRow("起始日期：", firstDateEdit);
+    form->addRow("结束日期：", lastDateEdit);
+    form->addRow("例外日期：", exceptionEdit);
+    form->addRow(previewLabel);
+    form->addRow(createButton);
+
+    // 切换时间段时带出该时间段的默认开始时间
+    connect(slotCombo, QOverload<int>::of(&QComboBox::currentIndexChanged), this, [this](int slot) {
+        startTimeEdit->setTime(ScheduleRepository::defaultStartTime(slot));
+    });
+    connect(dayCombo, QOverload<int>::of(&QComboBox::currentIndexChanged),
+            this, &ScheduleRuleDialog::updatePreview);
+    connect(firstDateEdit, &QDateEdit::dateChanged, this, &ScheduleRuleDialog::updatePreview);
+    connect(lastDateEdit, &QDateEdit::dateChanged, this, &ScheduleRuleDialog::updatePreview);
+    connect(exceptionEdit, &QPlainTextEdit::textChanged, this, &ScheduleRuleDialog::updatePreview);
+
+    QPushButton *closeButton = new QPushButton("关闭", this);
+    connect(closeButton, &QPushButton::clicked, this, &QDialog::accept);
+
+    mainLayout->addWidget(rulesGroup);
+    mainLayout->addWidget(newGroup);
+    mainLayout->addWidget(closeButton, 0, Qt::AlignRight);
+}
+
+void ScheduleRuleDialog::loadRules()
+{
+    ScheduleRepository repository;
+    const QVector<ScheduleRule> rules = repository.loadRules();
+
+    ruleTable->setRowCount(rules.size());
+
+    for (int row = 0; row < rules.size(); ++row) {
+        const ScheduleRule& rule = rules[row];
+        QTableWidgetItem   *student = new QTableWidgetItem(
+            rule.studentName.isEmpty() ? rule.studentId : rule.studentName);
+
+        student->setData(Qt::UserRole, rule.id);
+        ruleTable->setItem(row, 0, student);
+        ruleTable->setItem(row, 1, new QTableWidgetItem(dayNames.value(rule.dayOfWeek - 1)));
+        ruleTable->setItem(row, 2, new QTableWidgetItem(ScheduleRepository::slotLabels().value(rule.slot)));
+        ruleTable->setItem(row, 3, new QTableWidgetItem(rule.startTime.toString("HH:mm")));
+        ruleTable->setItem(row, 4, new QTableWidgetItem(
+                               rule.firstDate.toString("yyyy-MM-dd") + " ~ " +
+                               rule.lastDate.toString("yyyy-MM-dd")));
+        ruleTable->setItem(row, 5, new QTableWidgetItem(QString::number(rule.lessons)));
+    }
+}
+
+ScheduleRule ScheduleRuleDialog::currentRule() const
+{
+    ScheduleRule rule;
+
+    rule.studentId = studentCombo->currentData().toString();
+    rule.dayOfWeek = dayCombo->currentData().toInt();
+    rule.slot = slotCombo->currentIndex();
+    rule.startTime = startTimeEdit->time();
+    rule.firstDate = firstDateEdit->date();
+    rule.lastDate = lastDateEdit->date();
+    rule.exceptions = parseDates(exceptionEdit->toPlainText());
+    return rule;
+}
+
+// 只根据规则本身计算课程数，不访问数据库
+void ScheduleRuleDialog::updatePreview()
+{
+    const int lessons = currentRule().expand().size();
+
+    previewLabel->setText(lessons > 0 ? QString("将生成 %1 节课").arg(lessons)
+                                      : QString("日期范围内没有可生成的课程"));
+}
+
+void ScheduleRuleDialog::createRule()
+{
+    EventLoopMonitor::ActivityScope activity(Q_FUNC_INFO);
+
+    ScheduleRule rule = currentRule();
+
+    if (rule.studentId.isEmpty()) {
+        QMessageBox::warning(this, "错误", "请先选择学生！");
+        return;
+    }
+
+    if (rule.firstDate > rule.lastDate) {
+        QMessageBox::warning(this, "错误", "起始日期不能晚于结束日期！");
+        return;
+    }
+
+    const QVector<ScheduleEntry> expanded = rule.expand();
+
+    if (expanded.isEmpty()) {
+        QMessageBox::warning(this, "错误", "日期范围内没有可生成的课程！");
+        return;
+    }
+
+    // 一次读取整个日期范围：已占用的单元格直接跳过，与该学生其他课程时间重叠的也跳过
+    ScheduleRepository    repository;
+    ScheduleConflictIndex conflicts;
+    QSet<QPair<QDate, int> > occupied;
+
+    bool ok = repository.forEach(rule.firstDate.addDays(-1), rule.lastDate.addDays(1),
+                                 [&](const ScheduleEntry& entry) {
+        occupied.insert(qMakePair(entry.date, entry.slot));
+        conflicts.add(entry);
+        return true;
+    });
+
+    if (!ok) {
+        QMessageBox::critical(this, "错误", "读取课程失败：" + repository.lastError());
+        return;
+    }
+
+    QVector<ScheduleEntry> lessons;
+    QStringList skipped;
+
+    for (const ScheduleEntry& entry : expanded) {
+        if (occupied.contains(qMakePair(entry.date, entry.slot))) {
+            skipped << entry.date.toString("yyyy-MM-dd") + " 该时间段已有课程";
+        }
+        else if (auto conflict = conflicts.findConflict(entry)) {
+            skipped << entry.date.toString("yyyy-MM-dd") + " 与 " +
+                conflict->startTime.toString("HH:mm") + " 的课程时间重叠";
+        }
+        else lessons.append(entry);
+    }
+
+    if (!skipped.isEmpty()) {
+        QStringList shown = skipped.mid(0, 10);
+
+        if (skipped.size() > shown.size()) shown << QString("……共 %1 节").arg(skipped.size());
+
+        if (QMessageBox::question(this, "冲突",
+                                  QString("以下 %1 节课将跳过：\n%2\n\n继续生成其余 %3 节课吗？")
+                                  .arg(skipped.size()).arg(shown.join('\n')).arg(lessons.size()))
+            != QMessageBox::Yes) return;
+    }
+
+    if (!repository.insertRule(rule, lessons)) {
+        QMessageBox::critical(this, "错误", "保存失败：" + repository.lastError());
+        return;
+    }
+
+    changed = true;
+    loadRules();
+    QMessageBox::information(this, "周期排课", QString("已生成 %1 节课").arg(lessons.size()));
+}
+
+void ScheduleRuleDialog::stopSelectedRule()
+{
+    const int row = ruleTable->currentRow();
+
+    if (row < 0) {
+        QMessageBox::warning(this, "错误", "请先选择一条规则！");
+        return;
+    }
+
+    const int   ruleId = ruleTable->item(row, 0)->data(Qt::UserRole).toInt();
+    const QDate today = QDate::currentDate();
+
+    if (QMessageBox::question(this, "停止规则",
+                              QString("将删除该规则从 %1 起的所有课程，已上过的课程保留。确定吗？")
+                              .arg(today.toString("yyyy-MM-dd"))) != QMessageBox::Yes) return;
+
+    ScheduleRepository repository;
+
+    if (!repository.stopRule(ruleId, today)) {
+        QMessageBox::critical(this, "错误", "操作失败：" + repository.lastError());
+        return;
+    }
+
+    changed = true;
+    loadRules();
+}
@@ -0,0 +1,50 @@
+#ifndef SCHEDULERULEDIALOG_H
+#define SCHEDULERULEDIALOG_H
+
+#include <QDialog>
+#include <QDate>
+
+class QComboBox;
+class QDateEdit;
+class QTimeEdit;
+class QPlainTextEdit;
+class QTableWidget;
+class QLabel;
+struct ScheduleRule;
+
+// 周期排课：按"每周几、哪个时间段、起止日期、例外日期"一次生成整个学期的课程，
+// 在一个事务中批量写入；也可以停止已有规则，删除其今后的课程
+class ScheduleRuleDialog : public QDialog {
+    Q_OBJECT
+
+public:
+
+    ScheduleRuleDialog(const QDate& from, const QDate& to, QWidget *parent = nullptr);
+
+    // 本次打开期间是否修改过课程，调用方据此刷新课程表
+    bool scheduleChanged() const {
+        return changed;
+    }
+
+private:
+
+    void createUI();
+    void loadRules();
+    void updatePreview();
+    void createRule();
+    void stopSelectedRule();
+    ScheduleRule currentRule() const;
+
+    QTableWidget *ruleTable;
+    QComboBox *studentCombo;
+    QComboBox *dayCombo;
+    QComboBox *slotCombo;
+    QTimeEdit *startTimeEdit;
+    QDateEdit *firstDateEdit;
+    QDateEdit *lastDateEdit;
+    QPlainTextEdit *exceptionEdit;
+    QLabel *previewLabel;
+    bool changed = false;
+};
+
+#endif // SCHEDULERULEDIALOG_H
@@ -8,34 +8,88 @@
 #include <QHBoxLayout>
 #include <QPushButton>
 #include <QLabel>
-#include <QSqlQuery>
 #include <QMessageBox>
 #include <QFormLayout>
 #include <QTimeEdit>
-#include <QSqlError>
-int customWeekNumber(const QDate& date) {
-    QDate startOfYear(date.year(), 1, 1);
-    int   dayOfWeek = startOfYear.dayOfWeek();
-    int   days = startOfYear.daysTo(date);
-    int   week = (days + dayOfWeek - 1) / 7 + 1;
+#include <QDateEdit>
+#include <QCalendarWidget>
+#include <QTableView>
+#include <QtConcurrent>
+#include "databasemanager.h"
+#include "settings.h"
+#include "exportdialog.h"
+#include "importdialog.h"
+#include "schedulerangemodel.h"
+#include "scheduleloaddialog.h"
+#include "scheduleruledialog.h"
+#include "tabledelegates.h"
+#include "schedulerepository.h"
+#include "studentrepository.h"
+#include "eventloopmonitor.h"
+#include "startuptrace.h"
+namespace {
+// 把一条课程填入从 startDate 开始那一周的表格，不在该周或时间段未知的记录忽略
+void fillWeek(WeekGrid& grid, const QDate& startDate, const ScheduleEntry& entry)
+{
+    int dayIndex = startDate.daysTo(entry.date);
+
+    if ((dayIndex >= 0) && (dayIndex < 7) && (entry.slot >= 0) &&
+        (entry.slot < grid[dayIndex].size())) {
+        grid[dayIndex][entry.slot] = entry.displayText();
+    }
+}
+
+// date 所在学期：2～7 月为春季学期，8 月～次年 1 月为秋季学期
+QPair<QDate, QDate>semesterBounds(const QDate& date)
+{
+    const int month = date.month();
+
+    if ((month >= 2) && (month <= 7)) {
+        return qMakePair(QDate(date.year(), 2, 1), QDate(date.year(), 7, 31));
+    }
+
+    const int year = month == 1 ? date.year() - 1 : date.year();
+    return qMakePair(QDate(year, 8, 1), QDate(year + 1, 1, 31));
+}
+
+// date 所在周的星期一
+QDate mondayOf(const QDate& date)
+{
+    return date.addDays(Qt::Monday - date.dayOfWeek());
+}
 
-    return week;
+// ISO 周年的周数：12 月 28 日总在最后一周，有 52 或 53 周
+int weeksInYear(int year)
+{
+    return QDate(year, 12, 28).weekNumber();
+}
 }
 
 ScheduleWidget::ScheduleWidget(QWidget *parent)
     : QWidget(parent)
     , ui(new Ui::ScheduleWidget)
 {
+    StartupTrace::Span span(Q_FUNC_INFO);
+
     ui->setupUi(this);
-    setupUI();
 
-    int currentYear = QDate::currentDate().year();
-    int currentWeek = customWeekNumber(QDate::currentDate());
+    cacheRadius = Settings::instance().getScheduleCacheWeeks();
+    connect(&Settings::instance(), &Settings::scheduleCacheWeeksChanged, this, [this](int weeks) {
+        cacheRadius = weeks;
+        trimCache(weekStart);
+        prefetchAround(weekStart);
+    });
 
-    yearComboBox->setCurrentText(QString::number(currentYear));
-    weekComboBox->setCurrentText(QString("第 %1 周").arg(currentWeek));
+    prefetchWatcher = new QFutureWatcher<QMap<WeekKey, WeekGrid> >(this);
+    connect(prefetchWatcher, &QFutureWatcher<QMap<WeekKey, WeekGrid> >::finished,
+            this, &ScheduleWidget::onPrefetchFinished);
 
-    loadSchedule();
+    setupUI();
+    setWeekStart(mondayOf(QDate::currentDate()));
+
+    // 切换数据库后丢弃全部缓存
+    connect(&DataBaseManager::instance(), &DataBaseManager::databaseSwitched, this,
+            &ScheduleWidget::reloadAll);
 }
 
 // 定义 setupTable 函数，用于设置表格内容和表头
@@ -43,8 +97,8 @@ void ScheduleWidget::setupTable() {
     // 定义一周七天的字符串列表
     QStringList days = { "星期一", "星期二", "星期三", "星期四", "星期五", "星期六", "星期日" };
 
-    // 定义一天内的时间段列表（假设times为QStringList类型，此处可能需检查变量定义）
-    times = { "上午1", "上午2", "下午1", "下午2", "晚上1", "晚上2" };
+    // 一天内的时间段列表，列号即数据库中的 slot
+    times = ScheduleRepository::slotLabels();
 
     // 设置表格行数为7（一周七天）
     tableWidget->setRowCount(days.count());
@@ -52,34 +106,7 @@ void ScheduleWidget::setupTable() {
     // 设置表格列数为6（六个时间段）
     tableWidget->setColumnCount(times.count());
 
-    // 获取年份组合框当前选择的年份（整数）
-    int year = yearComboBox->currentData().toInt();
-
-    // 获取周数组合框当前选择的周数（整数）
-    int week = weekComboBox->currentData().toInt();
-
-    // 调用getWeekRange获取该周的起始和结束日期
-    QPair<QDate, QDate> weekRange = getWeekRange(year, week);
-
-    // 提取起始日期
-    QDate startDate = weekRange.first;
-
-    // 定义垂直表头（行表头）的字符串列表
-    QStringList verticalHeaders;
-
-    // 遍历一周七天，生成每行的表头内容（星期几 + 日期）
-    for (int i = 0; i < days.count(); ++i) {
-        // 计算当前行对应的日期（起始日期 + i天，i=0到6对应一周七天）
-        QDate currentDate = startDate.addDays(i);
-
-        // 格式化表头内容："星期X\nMM/dd"，添加到垂直表头列表
-        verticalHeaders.append(QString("%1\n%2").arg(days[i]).arg(currentDate.
-                                                                  toString(
-                                                                      "MM/dd")));
-    }
-
-    // 设置表格的垂直表头（行表头）
-    tableWidget->setVerticalHeaderLabels(verticalHeaders);
+    // 垂直表头（星期几 + 日期）随周变化，在 loadSchedule() 中设置
 
     // 设置表格的水平表头（列表头，时间段）
     tableWidget->setHorizontalHeaderLabels(times);
@@ -97,55 +124,38 @@ void ScheduleWidget::setupTable() {
 
 void ScheduleWidget::loadSchedule()
 {
+    EventLoopMonitor::ActivityScope activity(Q_FUNC_INFO);
+
     // 防止加载数据时触发itemChanged信号
     tableWidget->blockSignals(true);
 
     // 清空表格内容但保留表头
     tableWidget->clearContents();
 
-    // 获取当前选择的年份和周数
-    int year = yearComboBox->currentData().toInt();
-    int week = weekComboBox->currentData().toInt();
-
-    // 计算当前周的日期范围（周一到周日）
-    QPair<QDate, QDate> weekRange = getWeekRange(year, week);
-    QDate startDate = weekRange.first;
-    QDate endDate = weekRange.second;
+    // 当前周的日期范围（周一到周日）
+    const WeekKey key = weekStart;
+    QDate startDate = weekStart;
+    QDate endDate = weekStart.addDays(6);
 
     // 更新日期范围显示
     dateRangeLabel->setText(startDate.toString(
                                 "yyyy-MM-dd") + "到" +
                             endDate.toString("yyyy-MM-dd"));
 
-    // 初始化课程数据结构，7天×多个时间段
-    QVector<QVector<QString> > courses(7, QVector<QString>(times.count(), ""));
-
-    // 准备SQL查询，获取指定日期范围内的所有课程
-    QSqlQuery query;
-    query.prepare(
-        "SELECT date, time, course_name FROM schedule WHERE date BETWEEN ? AND ?");
-    query.addBindValue(startDate.toString("yyyy-MM-dd"));
-    query.addBindValue(endDate.toString("yyyy-MM-dd"));
-
-    // 执行SQL查询
-    if (query.exec()) {
-        // 遍历查询结果
-        while (query.next()) {
-            // 获取课程日期、时间和名称
-            QDate date = QDate::fromString(query.value(0).toString(),
-                                           "yyyy-MM-dd");
-            QString time = query.value(1).toString();
-
-            // 计算课程在表格中的位置
-            int dayIndex = startDate.daysTo(date);
-            int timeIndex = times.indexOf(time);
-
-            // 检查索引有效性并存储课程数据
-            if ((dayIndex >= 0) && (dayIndex < 7) && (timeIndex != -1)) {
-                courses[dayIndex][timeIndex] = query.value(2).toString();
-            }
-        }
+    // 垂直表头：星期X + 日期
+    static const QStringList days = { "星期一", "星期二", "星期三", "星期四", "星期五", "星期六", "星期日" };
+    QStringList verticalHeaders;
+
+    for (int i = 0; i < days.count(); ++i) {
+        verticalHeaders.append(QString("%1\n%2").arg(days[i])
+                               .arg(startDate.addDays(i).toString("MM/dd")));
     }
+    tableWidget->setVerticalHeaderLabels(verticalHeaders);
+
+    // 优先使用缓存，未命中（首次打开或预取尚未完成）时同步读取这一周
+    if (!scheduleData.contains(key)) scheduleData.insert(key, loadWeek(key));
+
+    const WeekGrid courses = scheduleData.value(key);
 
     // 填充表格数据
     for (int day = 0; day < 7; ++day) {
@@ -159,9 +169,181 @@ void ScheduleWidget::loadSchedule()
 
     // 恢复信号处理
     tableWidget->blockSignals(false);
+
+    trimCache(key);
+    prefetchAround(key);
+}
+
+// 切换到 date 所在的周：所有翻页、下拉框和跳转都经过这里，每次只读取一次课程表
+void ScheduleWidget::setWeekStart(const QDate& date)
+{
+    if (!date.isValid()) return;
+
+    weekStart = mondayOf(date);
+    syncWeekControls();
+
+    if (viewMode() == WeekView) loadSchedule();
+}
+
+// 让年份、周数下拉框和跳转日期显示 weekStart 所在的 ISO 周，不触发信号
+void ScheduleWidget::syncWeekControls()
+{
+    int isoYear = 0;
+    const int isoWeek = weekStart.weekNumber(&isoYear);
+
+    const QSignalBlocker yearBlocker(yearComboBox);
+    const QSignalBlocker weekBlocker(weekComboBox);
+    const QSignalBlocker dateBlocker(jumpDateEdit);
+
+    // 跳转到下拉框范围以外的年份时补上该年份，保持升序
+    if (yearComboBox->findData(isoYear) == -1) {
+        int index = 0;
+
+        while (index < yearComboBox->count() && yearComboBox->itemData(index).toInt() < isoYear) ++index;
+        yearComboBox->insertItem(index, QString::number(isoYear), isoYear);
+    }
+    yearComboBox->setCurrentIndex(yearComboBox->findData(isoYear));
+
+    // 周数下拉框按该年的实际周数（52 或 53）重建
+    const int weeks = weeksInYear(isoYear);
+
+    if (weekComboBox->count() != weeks) {
+        weekComboBox->clear();
+
+        for (int week = 1; week <= weeks; ++week) {
+            weekComboBox->addItem(QString("第 %1 周").arg(week), week);
+        }
+    }
+    weekComboBox->setCurrentIndex(isoWeek - 1);
+
+    // 用户正在输入日期时不改写输入框
+    if (!jumpDateEdit->hasFocus()) jumpDateEdit->setDate(weekStart);
+}
+
+// 用户在下拉框中选择了年份或周数
+void ScheduleWidget::onWeekComboChanged()
+{
+    const int year = yearComboBox->currentData().toInt();
+    const int week = qMin(weekComboBox->currentData().toInt(), weeksInYear(year));
+
+    setWeekStart(getWeekRange(year, week).first);
+}
+
+WeekGrid ScheduleWidget::loadWeek(const WeekKey& key)
+{
+    WeekGrid grid(7, QVector<QString>(times.count()));
+    ScheduleRepository repository;
+
+    for (const ScheduleEntry& entry : repository.loadRange(key, key.addDays(6))) {
+        fillWeek(grid, key, entry);
+    }
+    return grid;
+}
+
+// 在后台线程读取当前周前后 cacheRadius 周中还没有缓存的部分，
+// 缺失的周合并成一个日期范围只查询一次
+void ScheduleWidget::prefetchAround(const WeekKey& key)
+{
+    // 上一次预取还没结束，结束后会以当时的周为中心再检查一次
+    if (prefetchWatcher->isRunning()) return;
+
+    QVector<WeekKey> weeks;
+
+    for (int offset = -cacheRadius; offset <= cacheRadius; ++offset) {
+        WeekKey week = key.addDays(7 * offset);
+
+        if (!scheduleData.contains(week)) weeks.append(week);
+    }
+
+    if (weeks.isEmpty()) return;
+
+    const QDate from = weeks.first();
+    const QDate to = weeks.last().addDays(6);
+    const QString path = DataBaseManager::instance().getDatabasePath();
+    const QStringList timeSlots = times;
+
+    prefetchGeneration = cacheGeneration;
+    prefetchWatcher->setFuture(QtConcurrent::run(DataBaseManager::instance().backgroundPool(),
+                                                 [=]() -> QMap<WeekKey, WeekGrid> {
+        QMap<WeekKey, WeekGrid> result;
+
+        for (const WeekKey& week : weeks) {
+            result.insert(week, WeekGrid(7, QVector<QString>(timeSlots.count())));
+        }
+
+        ScheduleRepository repository(DataBaseManager::threadConnection(path));
+        bool ok = repository.forEach(from, to, [&](const ScheduleEntry& entry) {
+            const WeekKey week = mondayOf(entry.date);
+
+            if (result.contains(week)) fillWeek(result[week], week, entry);
+            return true;
+        });
+
+        // 读取失败时不缓存，进入该周时再同步读取
+        return ok ? result : QMap<WeekKey, WeekGrid>();
+    }));
+}
+
+void ScheduleWidget::onPrefetchFinished()
+{
+    // 预取期间课程被修改过，结果可能已过期
+    if (prefetchGeneration == cacheGeneration) {
+        const QMap<WeekKey, WeekGrid> result = prefetchWatcher->result();
+
+        for (auto it = result.constBegin(); it != result.constEnd(); ++it) {
+            if (!scheduleData.contains(it.key())) scheduleData.insert(it.key(), it.value());
+        }
+    }
+
+    // 预取期间可能已经翻到了别的周
+    trimCache(weekStart);
+    prefetchAround(weekStart);
+}
+
+// 丢弃离当前周超过 cacheRadius 的缓存，控制内存占用
+void ScheduleWidget::trimCache(const WeekKey& key)
+{
+    for (auto it = scheduleData.begin(); it != scheduleData.end();) {
+        if (qAbs(it.key().daysTo(key)) > cacheRadius * 7) it = scheduleData.erase(it);
+        else ++it;
+    }
+}
+
+void ScheduleWidget::invalidateWeek(const WeekKey& key)
+{
+    scheduleData.remove(key);
+    ++cacheGeneration;
+    conflictWeek = WeekKey();
+}
+
+bool ScheduleWidget::confirmNoConflict(const WeekKey& key, const ScheduleEntry& entry)
+{
+    if (conflictWeek != key) {
+        ScheduleRepository repository;
+
+        if (!conflictIndex.load(repository, key, key.addDays(6))) {
+            conflictWeek = WeekKey();
+            return true; // 读取失败时不阻止保存，保存本身会报告数据库错误
+        }
+        conflictWeek = key;
+    }
+
+    const std::optional<ScheduleEntry> conflict = conflictIndex.findConflict(entry);
+
+    if (!conflict) return true;
+
+    return QMessageBox::question(
+        this, "时间冲突",
+        QString("该学生在 %1 %2 已有 %3 开始的课程，与本节课时间重叠（每节课按 %4 分钟计）。\n仍要保存吗？")
+        .arg(conflict->date.toString("yyyy-MM-dd"))
+        .arg(times.value(conflict->slot))
+        .arg(conflict->startTime.toString("HH:mm"))
+        .arg(conflictIndex.lessonMinutes())) == QMessageBox::Yes;
 }
 
 void ScheduleWidget::addCourse() {
+    EventLoopMonitor::ActivityScope activity(Q_FUNC_INFO);
+
     // 获取当前选中的表格单元格位置
     int dayIndex = tableWidget->currentRow();
     int timeIndex = tableWidget->currentColumn();
@@ -185,20 +367,16 @@ void ScheduleWidget::addCourse() {
 
     // 创建学生姓名选择下拉框
     QComboBox nameCombo;
-    QSqlQuery nameQuery("SELECT name FROM studentInfo");
-
-    while (nameQuery.next()) nameCombo.addItem(nameQuery.value(0).toString());
+    StudentRepository studentRepository;
 
-    // 定义时间预设映射表（列索引 -> 默认时间）
-    QMap<int, QTime> timePresets = {
-        { 0, QTime(9,  0)         },  { 1, QTime(11, 0) }, { 2, QTime(14, 0) },
-        { 3, QTime(16, 0)         },  { 4, QTime(19, 0) }, { 5, QTime(21, 0) }
-    };
+    for (const StudentName& student : studentRepository.loadNames()) {
+        nameCombo.addItem(student.name, student.id);
+    }
 
     // 创建时间选择控件
     QTimeEdit timeEdit;
     timeEdit.setDisplayFormat("HH:mm");
-    timeEdit.setTime(timePresets.value(timeIndex)); // 设置为对应列的默认时间
+    timeEdit.setTime(ScheduleRepository::defaultStartTime(timeIndex)); // 设置为对应列的默认时间
 
     // 添加控件到对话框布局
     layout.addRow("学生姓名:", &nameCombo);
@@ -217,55 +395,40 @@ void ScheduleWidget::addCourse() {
     // 显示对话框并等待用户操作
     if (dialog.exec() != QDialog::Accepted) return;
 
-    // 生成课程名称字符串（格式："姓名,HH:mm"）
-    QString courseName = QString("%1,%2").arg(nameCombo.currentText())
-                         .arg(timeEdit.time().toString("HH:mm"));
-
-    // 获取当前选择的年份和周数
-    int year = yearComboBox->currentData().toInt();
-    int week = weekComboBox->currentData().toInt();
-    QPair<QDate, QDate> weekRange = getWeekRange(year, week);
-
     // 计算当前选择单元格对应的日期（周起始日期 + 天偏移）
-    QDate currentDate = weekRange.first.addDays(dayIndex);
+    QDate currentDate = weekStart.addDays(dayIndex);
+
+    // 课程按学号关联学生，时间段存储列号
+    ScheduleEntry entry;
+    entry.date = currentDate;
+    entry.slot = timeIndex;
+    entry.studentId = nameCombo.currentData().toString();
+    entry.startTime = timeEdit.time();
 
-    // 获取原始时间段标识（如"上午1"、"下午2"等）
-    QString timeSlot = times[timeIndex];
+    if (!confirmNoConflict(weekStart, entry)) return;
 
-    // 准备SQL插入语句
-    QSqlQuery query;
-    query.prepare(
-        "INSERT INTO schedule (date, time, course_name) VALUES (?, ?, ?)");
-    query.addBindValue(currentDate.toString("yyyy-MM-dd"));
-    query.addBindValue(timeSlot);   // 存储原始时间段标识
-    query.addBindValue(courseName); // 存储"姓名,HH:mm"格式的字符串
+    ScheduleRepository repository;
 
-    // 执行SQL插入
-    if (!query.exec()) QMessageBox::critical(this,
-                                             "错误",
-                                             "添加失败：" + query.lastError().text());
-    else loadSchedule();  // 插入成功后刷新课程表显示
+    if (!repository.insert(entry)) {
+        QMessageBox::critical(this, "错误", "添加失败：" + repository.lastError());
+    }
+    else {
+        // 插入成功后刷新课程表显示
+        invalidateWeek(weekStart);
+        loadSchedule();
+    }
 }
 
-// 定义getWeekRange函数，计算指定年份和周数的起始和结束日期（周一到周日）
+// 计算指定 ISO 年份和周数的起始和结束日期（周一到周日），与 QDate::weekNumber() 一致
 QPair<QDate, QDate>ScheduleWidget::getWeekRange(int year, int week) {
-    // 初始化起始日期为该年1月1日
-    QDate startDate(year, 1, 1);
-
-    // 计算1月1日距离星期一的天数差（若为星期一，daysToSubtract=0；否则为正数，需调整到周一）
-    int daysToSubtract = startDate.dayOfWeek() - Qt::Monday;
-
-    // 如果1月1日不是周一，调整到该年第一个周一（例如1月1日是周二，daysToSubtract=1，减去1天到周一）
-    if (daysToSubtract > 0) startDate = startDate.addDays(-daysToSubtract);
-
-    // 计算第week周的起始日期：第1周从第一个周一开始，每周加7天
-    QDate weekStart = startDate.addDays((week - 1) * 7);
+    // 1月4日总在第1周，第1周从它所在周的星期一开始
+    QDate firstMonday = mondayOf(QDate(year, 1, 4));
 
-    // 计算第week周的结束日期：起始日期 + 6天（周一到周日共7天，索引0到6）
-    QDate weekEnd = weekStart.addDays(6);
+    // 计算第week周的起始日期：每周加7天
+    QDate monday = firstMonday.addDays((week - 1) * 7);
 
     // 返回该周的起始和结束日期对
-    return qMakePair(weekStart, weekEnd);
+    return qMakePair(monday, monday.addDays(6));
 }
 
 ScheduleWidget::~ScheduleWidget()
@@ -287,23 +450,34 @@ void ScheduleWidget::setupUI()
                                                                                      year),
                                                                                  year);
 
-    for (int week = 1; week <= 52; ++week) weekComboBox->addItem(QString(
-                                                                     "第 %1 周").arg(
-                                                                     week),
-                                                                 week);
+    // 周数下拉框按所选年份的周数（52 或 53）在 syncWeekControls() 中填充
+
+    // 跳转到任意日期所在的周
+    jumpDateEdit = new QDateEdit(this);
+    jumpDateEdit->setCalendarPopup(true);
+    jumpDateEdit->setDisplayFormat("yyyy-MM-dd");
 
     dateRangeLabel = new QLabel(this);
 
     // 添加周导航按钮
-    QPushButton *prevWeekBtn = new QPushButton("上一周", this);
-    QPushButton *nextWeekBtn = new QPushButton("下一周", this);
+    prevWeekBtn = new QPushButton("上一周", this);
+    nextWeekBtn = new QPushButton("下一周", this);
     prevWeekBtn->setFixedWidth(200);
     nextWeekBtn->setFixedWidth(200);
 
+    // 视图切换：周视图可编辑，月视图和学期视图只读，双击某天跳到该周
+    viewModeComboBox = new QComboBox(this);
+    viewModeComboBox->addItem("周视图", WeekView);
+    viewModeComboBox->addItem("月视图", MonthView);
+    viewModeComboBox->addItem("学期视图", SemesterView);
+
+    dateLayout->addWidget(viewModeComboBox);
     dateLayout->addWidget(new QLabel("年份：", this));
     dateLayout->addWidget(yearComboBox);
     dateLayout->addWidget(new QLabel("周数：", this));
     dateLayout->addWidget(weekComboBox);
+    dateLayout->addWidget(new QLabel("跳转到：", this));
+    dateLayout->addWidget(jumpDateEdit);
     dateLayout->addWidget(dateRangeLabel);
     dateLayout->addStretch();
 
@@ -312,22 +486,58 @@ void ScheduleWidget::setupUI()
     tableWidget->setSelectionMode(QAbstractItemView::SingleSelection);
     setupTable();
 
+    rangeModel = new ScheduleRangeModel(this);
+    rangeView = new QTableView(this);
+    rangeView->setModel(rangeModel);
+    rangeView->setItemDelegate(new ScheduleCellDelegate(rangeView));
+    rangeView->setAlternatingRowColors(false);
+    rangeView->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    rangeView->setSelectionMode(QAbstractItemView::SingleSelection);
+    rangeView->horizontalHeader()->setSectionResizeMode(QHeaderView::Stretch);
+    rangeView->verticalHeader()->setDefaultSectionSize(
+        rangeView->fontMetrics().height() * 2 + 8);
+    rangeView->hide();
+
     addButton = new QPushButton("添加课程", this);
     deleteButton = new QPushButton("删除课程", this);
+    exportButton = new QPushButton("导出本周", this);
     addButton->setFixedWidth(200);
     deleteButton->setFixedWidth(200);
+    exportButton->setFixedWidth(200);
+
+    // 批量操作和统计放在日期栏右侧
+    loadButton = new QPushButton("课时统计", this);
+    importButton = new QPushButton("导入课程", this);
+    ruleButton = new QPushButton("周期排课", this);
+    dateLayout->addWidget(ruleButton);
+    dateLayout->addWidget(importButton);
+    dateLayout->addWidget(loadButton);
 
     connect(yearComboBox,
             QOverload<int>::of(&QComboBox::currentIndexChanged),
-            this, &ScheduleWidget::loadSchedule);
+            this, &ScheduleWidget::onWeekComboChanged);
     connect(weekComboBox,
             QOverload<int>::of(&QComboBox::currentIndexChanged),
-            this, &ScheduleWidget::loadSchedule);
+            this, &ScheduleWidget::onWeekComboChanged);
+    // 手工输入的日期在输入完成后才跳转，每按一个键都跳转会打断输入；日历弹窗中点击立即跳转
+    connect(jumpDateEdit, &QDateEdit::editingFinished, this, [this] {
+        if (mondayOf(jumpDateEdit->date()) != weekStart) setWeekStart(jumpDateEdit->date());
+    });
+    connect(jumpDateEdit->calendarWidget(), &QCalendarWidget::clicked, this,
+            &ScheduleWidget::setWeekStart);
     connect(addButton,    &QPushButton::clicked,      this,
             &ScheduleWidget::addCourse);
 
     connect(deleteButton, &QPushButton::clicked,      this,
             &ScheduleWidget::deleteCourse);
+    connect(exportButton, &QPushButton::clicked,      this,
+            &ScheduleWidget::exportSchedule);
+    connect(loadButton,   &QPushButton::clicked,      this,
+            &ScheduleWidget::showLoadReport);
+    connect(importButton, &QPushButton::clicked,      this,
+            &ScheduleWidget::importSchedule);
+    connect(ruleButton,   &QPushButton::clicked,      this,
+            &ScheduleWidget::editRules);
 
     connect(prevWeekBtn,  &QPushButton::clicked,      this,
             &ScheduleWidget::showPreviousWeek);
@@ -335,6 +545,11 @@ void ScheduleWidget::setupUI()
             &ScheduleWidget::showNextWeek);
     connect(tableWidget,  &QTableWidget::itemChanged, this,
             &ScheduleWidget::handleItemChanged);
+    connect(viewModeComboBox,
+            QOverload<int>::of(&QComboBox::currentIndexChanged),
+            this, &ScheduleWidget::changeViewMode);
+    connect(rangeView,    &QTableView::doubleClicked, this,
+            &ScheduleWidget::openWeekAt);
 
     QHBoxLayout *buttonLayout = new QHBoxLayout();
     buttonLayout->addStretch();
@@ -342,9 +557,11 @@ void ScheduleWidget::setupUI()
     buttonLayout->addWidget(nextWeekBtn);
     buttonLayout->addWidget(addButton);
     buttonLayout->addWidget(deleteButton);
+    buttonLayout->addWidget(exportButton);
     buttonLayout->addStretch();
     mainLayout->addLayout(dateLayout);
     mainLayout->addWidget(tableWidget);
+    mainLayout->addWidget(rangeView);
     mainLayout->addLayout(buttonLayout);
 
     setLayout(mainLayout);
@@ -352,41 +569,43 @@ void ScheduleWidget::setupUI()
 
 void ScheduleWidget::handleItemChanged(QTableWidgetItem *item)
 {
+    EventLoopMonitor::ActivityScope activity(Q_FUNC_INFO);
+
     int day = item->row();
     int timeSlot = item->column();
     QString newCourse = item->text().trimmed();
 
-    int year = yearComboBox->currentData().toInt();
-    int week = weekComboBox->currentData().toInt();
-    QPair<QDate, QDate> weekRange = getWeekRange(year, week);
-    QDate   date = weekRange.first.addDays(day);
-    QString time = times[timeSlot];
+    QDate date = weekStart.addDays(day);
 
-    QSqlQuery query;
+    // 输入的"姓名,HH:mm"能对应到学生时按学号保存，否则保存原文
+    ScheduleRepository repository;
+    ScheduleEntry      entry;
 
-    if (newCourse.isEmpty()) {
-        // 删除课程
-        query.prepare("DELETE FROM schedule WHERE date = ? AND time = ?");
-        query.addBindValue(date.toString("yyyy-MM-dd"));
-        query.addBindValue(time);
-    }
-    else {
-        // 使用REPLACE语句更新或插入
-        query.prepare(
-            "INSERT OR REPLACE INTO schedule (date, time, course_name) VALUES (?, ?, ?)");
-        query.addBindValue(date.toString("yyyy-MM-dd"));
-        query.addBindValue(time);
-        query.addBindValue(newCourse);
+    if (!newCourse.isEmpty()) {
+        entry = repository.fromText(date, timeSlot, newCourse);
+
+        if (!confirmNoConflict(weekStart, entry)) {
+            loadSchedule(); // 恢复修改前的内容
+            return;
+        }
     }
 
-    if (!query.exec()) {
-        QMessageBox::critical(this, "错误", "操作失败：" + query.lastError().text());
+    bool ok = newCourse.isEmpty()
+              ? repository.remove(date, timeSlot) // 删除课程
+              : repository.upsert(entry);         // 更新或插入
+
+    invalidateWeek(weekStart);
+
+    if (!ok) {
+        QMessageBox::critical(this, "错误", "操作失败：" + repository.lastError());
         loadSchedule(); // 恢复数据
     }
 }
 
 void ScheduleWidget::deleteCourse()
 {
+    EventLoopMonitor::ActivityScope activity(Q_FUNC_INFO);
+
     // 创建确认对话框，防止误删除
     QMessageBox confirmBox(this);
 
@@ -423,32 +642,20 @@ void ScheduleWidget::deleteCourse()
             return;
         }
 
-        // 获取当前选择的年份和周数
-        int year = yearComboBox->currentData().toInt();
-        int week = weekComboBox->currentData().toInt();
-
-        // 计算当前周的日期范围（周一到周日）
-        QPair<QDate, QDate> weekRange = getWeekRange(year, week);
-
         // 根据表格行索引计算具体日期（dayIndex=0表示周一）
-        QDate currentDate = weekRange.first.addDays(dayIndex);
-
-        // 获取时间段标识（如"上午1"、"下午2"等）
-        QString time = times[timeIndex];
+        QDate currentDate = weekStart.addDays(dayIndex);
 
-        // 准备SQL删除语句，通过日期和时间段唯一确定一条记录
-        QSqlQuery query;
-        query.prepare("DELETE FROM schedule WHERE date = ? AND time = ?");
-        query.addBindValue(currentDate.toString("yyyy-MM-dd"));
-        query.addBindValue(time);
+        // 通过日期和时间段序号唯一确定一条记录
+        ScheduleRepository repository;
 
-        // 执行SQL删除操作
-        if (!query.exec()) {
+        // 执行删除操作
+        if (!repository.remove(currentDate, timeIndex)) {
             // 删除失败时显示错误信息
-            QMessageBox::critical(this, "错误", "删除失败：" + query.lastError().text());
+            QMessageBox::critical(this, "错误", "删除失败：" + repository.lastError());
         }
         else {
             // 删除成功后刷新课程表显示
+            invalidateWeek(weekStart);
             loadSchedule();
         }
     }
@@ -456,34 +663,153 @@ void ScheduleWidget::deleteCourse()
 
 void ScheduleWidget::showPreviousWeek()
 {
-    int currentWeek = weekComboBox->currentIndex();
-    int currentYear = yearComboBox->currentIndex();
+    if (viewMode() != WeekView) {
+        rangeAnchor = rangeAnchor.addMonths(viewMode() == MonthView ? -1 : -6);
+        loadRange();
+        return;
+    }
+
+    // 跨年时由 setWeekStart() 同步到上一年的最后一周（第 52 或 53 周）
+    setWeekStart(weekStart.addDays(-7));
+}
+
+void ScheduleWidget::showNextWeek()
+{
+    if (viewMode() != WeekView) {
+        rangeAnchor = rangeAnchor.addMonths(viewMode() == MonthView ? 1 : 6);
+        loadRange();
+        return;
+    }
+
+    setWeekStart(weekStart.addDays(7));
+}
+
+// 导出当前选中周（月视图、学期视图时为当前范围）的课程
+void ScheduleWidget::exportSchedule()
+{
+    QPair<QDate, QDate> weekRange = viewMode() == WeekView
+                                    ? qMakePair(weekStart, weekStart.addDays(6))
+                                    : rangeBounds();
+    ExportFilter filter;
+
+    filter.from = weekRange.first;
+    filter.to = weekRange.second;
+    execExportDialog(this, DataExporter::Schedule, filter);
+}
+
+ScheduleWidget::ViewMode ScheduleWidget::viewMode() const
+{
+    return ViewMode(viewModeComboBox->currentData().toInt());
+}
 
-    if (currentWeek > 0) {
-        weekComboBox->setCurrentIndex(currentWeek - 1);
+void ScheduleWidget::changeViewMode()
+{
+    const bool week = viewMode() == WeekView;
+
+    tableWidget->setVisible(week);
+    rangeView->setVisible(!week);
+    yearComboBox->setEnabled(week);
+    weekComboBox->setEnabled(week);
+    jumpDateEdit->setEnabled(week);
+    addButton->setEnabled(week);
+    deleteButton->setEnabled(week);
+
+    const QString unit = week ? "周" : (viewMode() == MonthView ? "月" : "学期");
+    prevWeekBtn->setText("上一" + unit);
+    nextWeekBtn->setText("下一" + unit);
+    exportButton->setText("导出本" + unit);
+
+    if (week) {
+        loadSchedule();
+        return;
     }
-    else {
-        if (yearComboBox->currentIndex() > 0) {
-            yearComboBox->setCurrentIndex(currentYear - 1);
 
-            // 跳转到上一年最后一周（第52周）
-            weekComboBox->setCurrentIndex(51);
-        }
+    // 从当前选中周开始
+    rangeAnchor = weekStart;
+    loadRange();
+}
+
+// 月视图为 rangeAnchor 所在自然月；学期视图 2～7 月为春季学期，8 月～次年 1 月为秋季学期
+QPair<QDate, QDate>ScheduleWidget::rangeBounds() const
+{
+    if (viewMode() == MonthView) {
+        QDate first(rangeAnchor.year(), rangeAnchor.month(), 1);
+        return qMakePair(first, first.addMonths(1).addDays(-1));
     }
+
+    return semesterBounds(rangeAnchor);
 }
 
-void ScheduleWidget::showNextWeek()
+// 整个范围一次查询读入 rangeModel
+void ScheduleWidget::loadRange()
 {
-    int currentWeek = weekComboBox->currentIndex();
-    int currentYear = yearComboBox->currentIndex();
+    EventLoopMonitor::ActivityScope activity(Q_FUNC_INFO);
+
+    const QPair<QDate, QDate> range = rangeBounds();
 
-    if (currentWeek < 51) {
-        weekComboBox->setCurrentIndex(currentWeek + 1);
+    if (!rangeModel->load(range.first, range.second, times)) {
+        QMessageBox::critical(this, "错误", "读取课程失败：" + rangeModel->lastError());
+        return;
     }
-    else {
-        if (yearComboBox->currentIndex() < yearComboBox->count() - 1) {
-            yearComboBox->setCurrentIndex(currentYear + 1);
-            weekComboBox->setCurrentIndex(0);
-        }
+
+    QString title = range.first.toString("yyyy年M月");
+
+    if (viewMode() == SemesterView) {
+        title = QString("%1 %2学期").arg(range.first.year())
+                .arg(range.first.month() == 2 ? "春季" : "秋季");
     }
+    dateRangeLabel->setText(title + "  " + range.first.toString("yyyy-MM-dd") + "到" +
+                            range.second.toString("yyyy-MM-dd"));
+}
+
+// 双击某一天切换到该天所在的周视图，便于修改
+void ScheduleWidget::openWeekAt(const QModelIndex& index)
+{
+    if (!index.isValid()) return;
+
+    const QDate date = rangeModel->dateAt(index.row());
+
+    // 此时仍是月视图或学期视图，setWeekStart() 不读取，切回周视图时读取一次
+    setWeekStart(date);
+    viewModeComboBox->setCurrentIndex(viewModeComboBox->findData(WeekView));
+    tableWidget->setCurrentCell(weekStart.daysTo(date), index.column());
+}
+
+// 课时统计默认统计当前显示的范围，可在对话框中改为任意区间
+void ScheduleWidget::showLoadReport()
+{
+    QPair<QDate, QDate> range = viewMode() == WeekView
+                                ? qMakePair(weekStart, weekStart.addDays(6))
+                                : rangeBounds();
+    ScheduleLoadDialog dialog(range.first, range.second, this);
+
+    dialog.exec();
+}
+
+// 导入课程，文件格式与"导出本周"相同；与已有课程时间重叠的行会被拒绝
+void ScheduleWidget::importSchedule()
+{
+    if (execImportDialog(this, DataImporter::Schedule)) reloadAll();
+}
+
+// 周期排课默认从当前周开始，到所在学期结束
+void ScheduleWidget::editRules()
+{
+    const QDate from = viewMode() == WeekView ? weekStart : rangeBounds().first;
+    ScheduleRuleDialog dialog(from, semesterBounds(from).second, this);
+
+    dialog.exec();
+
+    if (dialog.scheduleChanged()) reloadAll();
+}
+
+// 批量修改课程后丢弃全部缓存并重新读取当前视图
+void ScheduleWidget::reloadAll()
+{
+    scheduleData.clear();
+    ++cacheGeneration;
+    conflictWeek = WeekKey();
+
+    if (viewMode() == WeekView) loadSchedule();
+    else loadRange();
 }
@@ -2,16 +2,31 @@
 #define SCHEDULEWIDGET_H
 
 #include <QWidget>
+#include <QDate>
+#include <QMap>
+#include <QPair>
+#include <QVector>
+#include <QFutureWatcher>
+#include "scheduleconflictindex.h"
 
 namespace Ui {
 class ScheduleWidget;
 }
 
 class QTableWidget;
+class QDateEdit;
 class QComboBox;
 class QLabel;
 class QPushButton;
 class QTableWidgetItem;
+class QTableView;
+class QModelIndex;
+class ScheduleRangeModel;
+
+// 课程表缓存的键为该周的星期一，值为 7 天 × 时间段的课程名称
+using WeekKey = QDate;
+using WeekGrid = QVector<QVector<QString> >;
+
 class ScheduleWidget : public QWidget {
     Q_OBJECT
 
@@ -28,21 +43,74 @@ private:
     void               addCourse();
     void               handleItemChanged(QTableWidgetItem *item);
     void               deleteCourse();
+    void               exportSchedule();
     void               showPreviousWeek();
     void               showNextWeek();
     QPair<QDate, QDate>getWeekRange(int year,
                                     int week);
+
+    // 当前显示的周由 weekStart 决定，年份、周数下拉框和跳转日期只是它的显示
+    void               setWeekStart(const QDate& date);
+    void               syncWeekControls();
+    void               onWeekComboChanged();
+    WeekGrid           loadWeek(const WeekKey& key);
+    void               prefetchAround(const WeekKey& key);
+    void               onPrefetchFinished();
+    void               trimCache(const WeekKey& key);
+    void               invalidateWeek(const WeekKey& key);
+
+    // 月视图、学期视图
+    enum ViewMode {
+        WeekView,
+        MonthView,
+        SemesterView
+    };
+    ViewMode           viewMode() const;
+    void               changeViewMode();
+    void               loadRange();
+    QPair<QDate, QDate>rangeBounds() const;
+    void               openWeekAt(const QModelIndex& index);
+    void               showLoadReport();
+    void               importSchedule();
+    void               editRules();
+    void               reloadAll();
+
+    // 同一学生课程时间重叠时询问是否继续，返回 true 表示继续保存
+    bool               confirmNoConflict(const WeekKey      & key,
+                                         const ScheduleEntry& entry);
     QTableWidget *tableWidget;
     QComboBox *yearComboBox;
     QComboBox *weekComboBox;
+    QDateEdit *jumpDateEdit;
+    QDate weekStart; // 当前周的星期一
     QLabel *dateRangeLabel; // 显示日期范围的标签
     QPushButton *addButton;
     QPushButton *deleteButton;
+    QPushButton *exportButton;
+    QPushButton *loadButton;
+    QPushButton *importButton;
+    QPushButton *ruleButton;
+
+    // 当前编辑周（含前后一天）的课程时间索引，课程修改后重新读取
+    ScheduleConflictIndex conflictIndex;
+    WeekKey conflictWeek;
     QPushButton *prevWeekBtn;
     QPushButton *nextWeekBtn;
+    QComboBox *viewModeComboBox;
+    QTableView *rangeView;
+    ScheduleRangeModel *rangeModel;
+    QDate rangeAnchor; // 月视图、学期视图中位于当前范围内的任意一天
+
+    // 课程数据存储结构：键为周一的日期，值为课程表数据。
+    // 只保留当前周前后 cacheRadius 周，翻页时直接从这里取，不再查询数据库。
+    // cacheRadius 来自 Settings::getScheduleCacheWeeks()，修改后立即生效
+    QMap<WeekKey, WeekGrid>scheduleData;
+    int cacheRadius;
 
-    // 课程数据存储结构：键为 (year, week)，值为课程表数据
-    QMap<QPair<int, int>, QVector<QVector<QString> > >scheduleData;
+    // 后台预取相邻周；修改课程时 cacheGeneration 加一，丢弃修改前开始的预取结果
+    QFutureWatcher<QMap<WeekKey, WeekGrid> > *prefetchWatcher;
+    quint64 prefetchGeneration = 0;
+    quint64 cacheGeneration = 0;
     QStringList times; //上午1，上午2...
 
 
@@ -0,0 +1,150 @@
+#include "searchrepository.h"
+#include <QRegularExpression>
+#include <QStringList>
+
+namespace {
+// 不走索引时自己截取的摘要长度（字符）
+const int snippetChars = 12;
+
+// 与 FTS5 snippet() 相同的格式：取 term 第一次出现的位置前后若干字符，命中部分用【】标出
+QString highlight(const QString& title, const QString& body, const QString& term)
+{
+    const QString& text = body.contains(term, Qt::CaseInsensitive) ? body : title;
+    const int at = text.indexOf(term, 0, Qt::CaseInsensitive);
+
+    if (at < 0) return text.left(snippetChars);
+
+    const int from = qMax(0, at - qMax(0, snippetChars - int(term.size())) / 2);
+    const int to = qMin(int(text.size()), qMax(at + int(term.size()), from + snippetChars));
+    QString result = text.mid(from, at - from) + "【" + text.mid(at, term.size()) + "】" +
+                     text.mid(at + term.size(), to - at - term.size());
+
+    if (from > 0) result.prepend("…");
+    if (to < text.size()) result.append("…");
+    return result;
+}
+}
+
+QString SearchRepository::matchExpression(const QStringList& terms)
+{
+    QStringList quoted;
+
+    for (QString term : terms) {
+        term.replace('"', "\"\"");
+        quoted << "\"" + term + "\"";
+    }
+    return quoted.join(' ');
+}
+
+// rowid 的低两位是来源表；缴费和荣誉其余位是来源记录的 id，学生经 searchStudentRow 查到学号。
+// trigram 索引只能查找不少于三个字符的词，更短的词用 LIKE 逐行过滤；SQLite 不支持 trigram、
+// 索引退回 unicode61 时全部用 LIKE。LIKE 前加一元 +，不交给 FTS5 处理：
+// 部分 SQLite 版本把短于三个字符的 LIKE 交给 trigram 时什么也查不到。
+// 先在索引中排序取前 limit 条，再关联来源表取显示用的字段；来源已删除的行跳过
+QVector<SearchHit> SearchRepository::search(const QString               & text,
+                                            const QVector<SearchHit::Kind>& kinds,
+                                            int                           limit)
+{
+    static const QRegularExpression whitespace("\\s+");
+    QVector<SearchHit> hits;
+    QStringList indexedTerms, likeTerms;
+
+    if (kinds.isEmpty()) return hits;
+
+    // SQLite 不支持 FTS5 时升级没有建立索引，没有结果
+    const QString schema = indexSchema();
+
+    if (schema.isEmpty()) return hits;
+
+    const bool trigram = schema.contains("trigram");
+
+    for (const QString& term : text.split(whitespace, Qt::SkipEmptyParts)) {
+        if (trigram && (term.size() >= minIndexedChars)) indexedTerms << term;
+        else likeTerms << term;
+    }
+
+    if (indexedTerms.isEmpty() && likeTerms.isEmpty()) return hits;
+
+    QStringList kindList;
+
+    for (SearchHit::Kind kind : kinds) kindList << QString::number(kind);
+
+    QStringList conditions = { "rowid % 4 IN (" + kindList.join(", ") + ")" };
+    QVariantList values;
+    const bool ranked = !indexedTerms.isEmpty();
+
+    if (ranked) {
+        conditions << "searchIndex MATCH ?";
+        values << matchExpression(indexedTerms);
+    }
+
+    for (QString term : likeTerms) {
+        term.replace("\\", "\\\\").replace("%", "\\%").replace("_", "\\_");
+        conditions << "(+title LIKE ? ESCAPE '\\' OR +body LIKE ? ESCAPE '\\')";
+        values << "%" + term + "%" << "%" + term + "%";
+    }
+
+    QSqlQuery query = prepare(
+        "SELECT m.kind, m.snippet, m.title, m.body, st.id, st.name, "
+        "f.id, f.student_id, fs.name, f.payment_date, h.id, h.added_date "
+        "FROM (SELECT rowid AS ftsRowid, rowid % 4 AS kind, rowid / 4 AS source, title, body, " +
+        QString(ranked ? "snippet(searchIndex, -1, '【', '】', '…', 12) AS snippet, "
+                         "bm25(searchIndex, 10.0, 1.0) AS score "
+                       : "NULL AS snippet, -rowid AS score ") +
+        "FROM searchIndex WHERE " + conditions.join(" AND ") + " ORDER BY score LIMIT ?) m "
+        "LEFT JOIN searchStudentRow sr ON m.kind = 1 AND sr.fts_rowid = m.ftsRowid "
+        "LEFT JOIN studentInfo st ON st.id = sr.student_id "
+        "LEFT JOIN financialRecords f ON m.kind = 2 AND f.id = m.source "
+        "LEFT JOIN studentInfo fs ON fs.id = f.student_id "
+        "LEFT JOIN honorWall h ON m.kind = 3 AND h.id = m.source "
+        "ORDER BY m.score");
+
+    for (const QVariant& value : values) query.addBindValue(value);
+    query.addBindValue(limit);
+
+    if (!exec(query)) return hits;
+
+    while (next(query)) {
+        SearchHit hit;
+        hit.kind = SearchHit::Kind(query.value(0).toInt());
+        hit.snippet = query.value(1).isNull()
+                      ? highlight(query.value(2).toString(), query.value(3).toString(), likeTerms.first())
+                      : query.value(1).toString();
+
+        switch (hit.kind) {
+        case SearchHit::Student:
+            if (query.value(4).isNull()) continue;
+            hit.ref = query.value(4).toString();
+            hit.studentId = hit.ref;
+            hit.title = query.value(5).toString();
+            break;
+
+        case SearchHit::Payment:
+            if (query.value(6).isNull()) continue;
+            hit.ref = query.value(6).toString();
+            hit.studentId = query.value(7).toString();
+            hit.title = query.value(8).toString();
+            hit.date = query.value(9).toDate();
+            break;
+
+        case SearchHit::Honor:
+            if (query.value(10).isNull()) continue;
+            hit.ref = query.value(10).toString();
+            hit.date = QDate::fromString(query.value(11).toString().left(10), Qt::ISODate);
+            break;
+
+        default:
+            continue;
+        }
+        hits.append(hit);
+    }
+    return hits;
+}
+
+QString SearchRepository::indexSchema()
+{
+    QSqlQuery query = prepare("SELECT sql FROM sqlite_master WHERE type = 'table' AND name = 'searchIndex'");
+
+    if (!exec(query) || !next(query)) return QString();
+    return query.value(0).toString();
+}
@@ -0,0 +1,50 @@
+#ifndef SEARCHREPOSITORY_H
+#define SEARCHREPOSITORY_H
+
+#include "repository.h"
+#include <QDate>
+#include <QVector>
+
+// 全局搜索的一条结果。ref 为来源记录的主键：学号、缴费记录 id 或荣誉墙图片 id
+struct SearchHit {
+    enum Kind {
+        Student = 1,
+        Payment = 2,
+        Honor   = 3
+    };
+
+    Kind    kind = Student;
+    QString ref;
+    QString studentId;   // 学生和缴费记录所属的学生
+    QString title;       // 学生姓名；缴费和荣誉为所属学生或日期
+    QString snippet;     // 命中的文字，匹配部分用【】标出
+    QDate   date;        // 缴费日期或荣誉添加日期
+};
+
+// 在 searchIndex（FTS5，trigram 分词）中搜索学生姓名、学习目标、缴费备注和荣誉描述。
+// 索引由数据库触发器维护，见 DataBaseManager::migrate()
+class SearchRepository : public Repository {
+public:
+
+    using Repository::Repository;
+
+    // 不少于这么多字符的词走 trigram 索引，更短的词逐行 LIKE 匹配。
+    // 索引不是 trigram 分词（SQLite 低于 3.34）时全部逐行匹配
+    static constexpr int minIndexedChars = 3;
+
+    // text 按空白拆成多个词，记录中任意位置包含全部的词即命中。只查找 kinds 中的来源，
+    // 在取前 limit 条之前过滤。有可走索引的词时按 bm25 排序，姓名的权重高于正文；否则新添加的记录在前
+    QVector<SearchHit> search(const QString               & text,
+                              const QVector<SearchHit::Kind>& kinds,
+                              int                           limit = 20);
+
+    // 把各个词转成 FTS5 查询表达式，每个词加引号，不会被当成查询语法
+    static QString     matchExpression(const QStringList& terms);
+
+private:
+
+    // searchIndex 的建表语句，据此判断分词器；没有索引时为空
+    QString            indexSchema();
+};
+
+#endif // SEARCHREPOSITORY_H
@@ -0,0 +1,39 @@
+#include "session.h"
+
+Session& Session::instance()
+{
+    static Session instance;
+
+    return instance;
+}
+
+const QStringList& Session::permissionNames()
+{
+    static const QStringList names = {
+        "students", "schedule", "finance", "honor", "settings", "users"
+    };
+
+    return names;
+}
+
+const QStringList& Session::permissionLabels()
+{
+    static const QStringList labels = {
+        "学生信息", "课程表", "财务管理", "荣誉墙", "系统设置", "用户管理"
+    };
+
+    return labels;
+}
+
+void Session::begin(const QString& username, const QString& role, const QStringList& permissions)
+{
+    user = username;
+    userRole = role;
+    granted = 0;
+
+    for (const QString& name : permissions) {
+        const int index = permissionNames().indexOf(name);
+
+        if (index >= 0) granted |= 1u << index;
+    }
+}
@@ -0,0 +1,59 @@
+#ifndef SESSION_H
+#define SESSION_H
+
+#include <QString>
+#include <QStringList>
+
+// 当前登录的用户。登录成功时从数据库读取一次角色和权限，
+// 之后主窗口和各页面只查询这里，不再访问 users 表
+class Session {
+public:
+
+    // 权限，数据库中保存为 permissionNames() 中对应的名称
+    enum Permission {
+        StudentPage,
+        SchedulePage,
+        FinancePage,
+        HonorPage,
+        SettingsPage,
+        ManageUsers
+    };
+
+    static Session          & instance();
+
+    // 权限在 rolePermissions 表中的名称，下标与 Permission 对应
+    static const QStringList& permissionNames();
+
+    // 界面上显示的权限名称，下标与 Permission 对应
+    static const QStringList& permissionLabels();
+
+    // 登录成功后调用，permissions 为角色拥有的权限名称，不认识的名称忽略
+    void                      begin(const QString    & username,
+                                    const QString    & role,
+                                    const QStringList& permissions);
+
+    bool                      isActive() const {
+        return !user.isEmpty();
+    }
+
+    QString username() const {
+        return user;
+    }
+
+    QString role() const {
+        return userRole;
+    }
+
+    bool has(Permission permission) const {
+        return granted & (1u << permission);
+    }
+
+private:
+
+    Session() = default;
+    QString user;
+    QString userRole;
+    quint32 granted = 0;
+};
+
+#endif // SESSION_H
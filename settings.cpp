@@ -1,4 +1,13 @@
 #include "settings.h"
+#include <QDir>
+#include <QFileInfo>
+#include <QSettings>
+#include <QStandardPaths>
+
+namespace {
+// 修改后等待这么久再写回，期间的多次修改合并成一次写入
+const int writeDelayMs = 500;
+}
 
 // 获取Settings类的单例实例（线程安全的懒汉模式）
 Settings& Settings::instance()
@@ -8,44 +17,153 @@ Settings& Settings::instance()
     return instance;
 }
 
-// 构造函数：初始化QSettings对象，使用config.ini文件存储配置
-Settings::Settings() : settings("config.ini", QSettings::IniFormat)
-{}
+// 日志目录：系统公共数据目录下的 StudentManagerSystem，不随可执行文件名变化
+QString Settings::logDirectory()
+{
+    QString dir = QStandardPaths::writableLocation(QStandardPaths::GenericDataLocation);
 
-// 获取数据库路径，默认值为"users.db"
-QString Settings::getDatabasePath() const
+    if (dir.isEmpty()) dir = QDir::currentPath();
+    return QDir(dir).filePath("StudentManagerSystem");
+}
+
+// 构造函数：从config.ini读入全部配置，之后只在写回时访问文件
+Settings::Settings() : fileName(QFileInfo("config.ini").absoluteFilePath())
 {
-    return settings.value("Database/Path",
-                          "S:/Qt/project/StudentManagerSystem/sqlite/StuManSys.db")
-           .toString();
+    QSettings settings(fileName, QSettings::IniFormat);
+
+    databasePath = settings.value("Database/Path",
+                                  "S:/Qt/project/StudentManagerSystem/sqlite/StuManSys.db").toString();
+    cacheEnabled = settings.value("Login/CacheEnabled", true).toBool();
+    lastUser = settings.value("Login/LastUser", "").toString();
+    cachedUsername = settings.value("username").toString();
+    cachedPassword = settings.value("password").toString();
+    slowQueryThreshold = settings.value("Diagnostics/SlowQueryMs", 100).toInt();
+    passwordIterations = settings.value("Login/PasswordIterations", 0).toInt();
+    scheduleCacheWeeks = settings.value("Performance/ScheduleCacheWeeks", 4).toInt();
+    backgroundThreads = settings.value("Performance/BackgroundThreads", 0).toInt();
+    sqliteCacheKb = settings.value("Performance/SqliteCacheKb", 8192).toInt();
+    backupDirectory = settings.value("Backup/Directory",
+                                     QDir(logDirectory()).filePath("backups")).toString();
+    backupKeep = settings.value("Backup/Keep", 7).toInt();
+
+    writer.setMaxThreadCount(1);
+    writeTimer.setSingleShot(true);
+    writeTimer.setInterval(writeDelayMs);
+    connect(&writeTimer, &QTimer::timeout, this, &Settings::writePending);
 }
 
-// 设置数据库路径
-void Settings::setDatabasePath(const QString& path)
+// 析构时写回剩余的修改；smscli 等不进入事件循环的程序也靠这里保存
+Settings::~Settings()
 {
-    settings.setValue("Database/Path", path);
+    flush();
 }
 
-// 获取是否启用缓存的设置，默认值为true
-bool Settings::getCacheEnabled() const
+template<typename T>
+bool Settings::assign(T& field, const T& value, const char *key)
 {
-    return settings.value("Login/CacheEnabled", true).toBool();
+    if (field == value) return false;
+
+    field = value;
+    pending.insert(QString::fromLatin1(key), QVariant::fromValue(value));
+    writeTimer.start();
+    return true;
 }
 
-// 设置是否启用缓存
-void Settings::setCacheEnabled(bool enabled)
+// 把积累的修改交给后台线程写入文件
+void Settings::writePending()
 {
-    settings.setValue("Login/CacheEnabled", enabled);
+    if (pending.isEmpty()) return;
+
+    const QVariantMap batch = pending;
+    const QString     file = fileName;
+
+    pending.clear();
+    writer.start([batch, file]() {
+        QSettings settings(file, QSettings::IniFormat);
+
+        for (auto it = batch.constBegin(); it != batch.constEnd(); ++it) {
+            settings.setValue(it.key(), it.value());
+        }
+        settings.sync();
+    });
+}
+
+void Settings::flush()
+{
+    writeTimer.stop();
+    writePending();
+    writer.waitForDone();
+}
+
+// 设置数据库路径
+void Settings::setDatabasePath(const QString& path)
+{
+    if (assign(databasePath, path, "Database/Path")) emit databasePathChanged(path);
 }
 
-// 获取上次登录的用户名，默认值为空字符串
-QString Settings::getLastUser() const
+// 设置是否启用缓存
+void Settings::setCacheEnabled(bool enabled)
 {
-    return settings.value("Login/LastUser", "").toString();
+    if (assign(cacheEnabled, enabled, "Login/CacheEnabled")) emit cacheEnabledChanged(enabled);
 }
 
 // 设置上次登录的用户名
 void Settings::setLastUser(const QString& user)
 {
-    settings.setValue("Login/LastUser", user);
+    if (assign(lastUser, user, "Login/LastUser")) emit lastUserChanged(user);
+}
+
+// 保存记住的用户名和加密后的密码
+void Settings::setCachedCredentials(const QString& username, const QString& encryptedPassword)
+{
+    assign(cachedUsername, username,          "username");
+    assign(cachedPassword, encryptedPassword, "password");
+}
+
+// 设置慢查询阈值
+void Settings::setSlowQueryThreshold(int ms)
+{
+    if (assign(slowQueryThreshold, ms, "Diagnostics/SlowQueryMs")) emit slowQueryThresholdChanged(ms);
+}
+
+// 设置密码哈希迭代次数
+void Settings::setPasswordIterations(int iterations)
+{
+    if (assign(passwordIterations, iterations, "Login/PasswordIterations")) {
+        emit passwordIterationsChanged(iterations);
+    }
+}
+
+// 设置课程表缓存的周数
+void Settings::setScheduleCacheWeeks(int weeks)
+{
+    if (assign(scheduleCacheWeeks, weeks, "Performance/ScheduleCacheWeeks")) {
+        emit scheduleCacheWeeksChanged(weeks);
+    }
+}
+
+// 设置后台线程数
+void Settings::setBackgroundThreads(int threads)
+{
+    if (assign(backgroundThreads, threads, "Performance/BackgroundThreads")) {
+        emit backgroundThreadsChanged(threads);
+    }
+}
+
+// 设置 SQLite 页缓存大小
+void Settings::setSqliteCacheKb(int kb)
+{
+    if (assign(sqliteCacheKb, kb, "Performance/SqliteCacheKb")) emit sqliteCacheKbChanged(kb);
+}
+
+// 设置快照目录
+void Settings::setBackupDirectory(const QString& directory)
+{
+    if (assign(backupDirectory, directory, "Backup/Directory")) emit backupDirectoryChanged(directory);
+}
+
+// 设置快照保留份数
+void Settings::setBackupKeep(int keep)
+{
+    if (assign(backupKeep, keep, "Backup/Keep")) emit backupKeepChanged(keep);
 }
@@ -1,26 +1,145 @@
 #ifndef SETTINGS_H
 #define SETTINGS_H
-#include <QSettings>
+#include <QObject>
 #include <QString>
-class Settings {
+#include <QThreadPool>
+#include <QTimer>
+#include <QVariantMap>
+
+// 程序配置。构造时从 config.ini 一次读入内存，之后的读取都不访问文件；
+// 修改时立即更新内存并发出对应的 xxxChanged 信号，写回文件合并成批、在后台线程进行。
+// 只能在主线程中使用（第一次调用 instance() 也应在主线程）
+class Settings : public QObject {
+    Q_OBJECT
+
 public:
 
     static Settings& instance();
-    QSettings      & getQSettings() {
-        return settings;
-    } // 直接暴露底层的 QSettings 对象，允许外部代码绕过类的封装，直接操作配置文件
 
-    QString getDatabasePath() const;
-    void    setDatabasePath(const QString& path);
-    bool    getCacheEnabled() const;
-    void    setCacheEnabled(bool enabled);
-    QString getLastUser() const;
-    void    setLastUser(const QString& user);
+    // 日志和诊断数据目录，界面程序和 smscli 共用
+    static QString   logDirectory();
+
+    QString getDatabasePath() const {
+        return databasePath;
+    }
+
+    void setDatabasePath(const QString& path);
+
+    bool getCacheEnabled() const {
+        return cacheEnabled;
+    }
+
+    void setCacheEnabled(bool enabled);
+
+    QString getLastUser() const {
+        return lastUser;
+    }
+
+    void setLastUser(const QString& user);
+
+    // 记住的登录信息，密码为登录对话框加密后的文本
+    QString getCachedUsername() const {
+        return cachedUsername;
+    }
+
+    QString getCachedPassword() const {
+        return cachedPassword;
+    }
+
+    void setCachedCredentials(const QString& username, const QString& encryptedPassword);
+
+    // 慢查询阈值（毫秒），0 表示不记录慢查询日志
+    int getSlowQueryThreshold() const {
+        return slowQueryThreshold;
+    }
+
+    void setSlowQueryThreshold(int ms);
+
+    // 密码哈希的 PBKDF2 迭代次数，0 表示尚未在本机校准
+    int getPasswordIterations() const {
+        return passwordIterations;
+    }
+
+    void setPasswordIterations(int iterations);
+
+    // 以下为性能参数，修改后通过信号立即生效，不需要重启
+    // 课程表在内存中保留当前周前后各多少周
+    int getScheduleCacheWeeks() const {
+        return scheduleCacheWeeks;
+    }
+
+    void setScheduleCacheWeeks(int weeks);
+
+    // 后台线程池（预取、导入导出）的线程数，0 表示按 CPU 核数
+    int getBackgroundThreads() const {
+        return backgroundThreads;
+    }
+
+    void setBackgroundThreads(int threads);
+
+    // 主数据库连接的 SQLite 页缓存大小（KB）
+    int getSqliteCacheKb() const {
+        return sqliteCacheKb;
+    }
+
+    void setSqliteCacheKb(int kb);
+
+    // 数据库快照的保存目录和保留份数
+    QString getBackupDirectory() const {
+        return backupDirectory;
+    }
+
+    void setBackupDirectory(const QString& directory);
+
+    int getBackupKeep() const {
+        return backupKeep;
+    }
+
+    void setBackupKeep(int keep);
+
+    // 立即写回尚未保存的修改并等待写入完成，程序退出前调用
+    void flush();
+
+signals:
+
+    void databasePathChanged(const QString& path);
+    void cacheEnabledChanged(bool enabled);
+    void lastUserChanged(const QString& user);
+    void slowQueryThresholdChanged(int ms);
+    void passwordIterationsChanged(int iterations);
+    void scheduleCacheWeeksChanged(int weeks);
+    void backgroundThreadsChanged(int threads);
+    void sqliteCacheKbChanged(int kb);
+    void backupDirectoryChanged(const QString& directory);
+    void backupKeepChanged(int keep);
 
 private:
 
     Settings();
-    QSettings settings;
+    ~Settings();
+
+    // 更新内存中的值并安排写回，值没有变化时返回 false
+    template<typename T>
+    bool assign(T& field, const T& value, const char *key);
+    void writePending();
+
+    QString fileName;
+    QString databasePath;
+    bool cacheEnabled = true;
+    QString lastUser;
+    QString cachedUsername;
+    QString cachedPassword;
+    int slowQueryThreshold = 100;
+    int passwordIterations = 0;
+    int scheduleCacheWeeks = 4;
+    int backgroundThreads = 0;
+    int sqliteCacheKb = 8192;
+    QString backupDirectory;
+    int backupKeep = 7;
+
+    QVariantMap pending; // 尚未写回的键和值
+    QTimer writeTimer;
+    QThreadPool writer;  // 单线程，保证各批按顺序写入
 };
 
 #endif // SETTINGS_H
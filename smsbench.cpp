@@ -0,0 +1,346 @@
+// 性能基准测试：在临时数据库中生成合成数据，对界面中最常用的数据访问路径计时，
+// 结果以 JSON 输出，便于在不同版本之间比较。
+// 用法: smsbench [--students N] [--payments M] [--schedule K] [--honor H]
+//               [--json 文件] [Qt Test 参数...]
+#include "datasetgenerator.h"
+#include "databasemanager.h"
+#include "honorrepository.h"
+#include "passwordhasher.h"
+#include "paymentrepository.h"
+#include "schedulerepository.h"
+#include "searchrepository.h"
+#include "studentrepository.h"
+#include "userrepository.h"
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QDebug>
+#include <QFile>
+#include <QFileInfo>
+#include <QImage>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QTemporaryDir>
+#include <QTest>
+#include <QXmlStreamReader>
+
+namespace {
+const char *const connectionName = "smsbench";
+const QVector<SearchHit::Kind> allKinds = { SearchHit::Student, SearchHit::Payment, SearchHit::Honor };
+}
+
+class SmsBench : public QObject {
+    Q_OBJECT
+
+public:
+
+    explicit SmsBench(const DatasetGenerator::Sizes& sizes)
+        : sizes(sizes)
+    {}
+
+    qint64 databaseBytes() const {
+        return dbBytes;
+    }
+
+private slots:
+
+    void initTestCase()
+    {
+        QVERIFY(tempDir.isValid());
+
+        QSqlDatabase db = QSqlDatabase::addDatabase("QSQLITE", connectionName);
+        db.setDatabaseName(tempDir.filePath("bench.db"));
+        QVERIFY(db.open());
+        QVERIFY(DataBaseManager::ensureSchema(db));
+
+        DatasetGenerator generator(db);
+        QVERIFY2(generator.generate(sizes), qPrintable(generator.lastError()));
+        dbBytes = QFileInfo(db.databaseName()).size();
+    }
+
+    void cleanupTestCase()
+    {
+        QSqlDatabase::database(connectionName).close();
+        QSqlDatabase::removeDatabase(connectionName);
+    }
+
+    // 学生信息页 refreshTable()：全表连同照片
+    void studentLoad()
+    {
+        StudentRepository repository(database());
+        int rows = 0;
+
+        QBENCHMARK {
+            rows = repository.loadAll(true).size();
+        }
+        QCOMPARE(rows, sizes.students);
+    }
+
+    // 下拉框只需要学号和姓名
+    void studentNames()
+    {
+        StudentRepository repository(database());
+        int rows = 0;
+
+        QBENCHMARK {
+            rows = repository.loadNames().size();
+        }
+        QCOMPARE(rows, sizes.students);
+    }
+
+    // 学生表格筛选栏：进度和最近一年入学的学生，按入学日期倒序，不读照片
+    void studentFilter()
+    {
+        StudentRepository repository(database());
+        StudentFilter filter;
+        filter.progress = "40%";
+        filter.joinFrom = QDate::currentDate().addYears(-1);
+        filter.sortKeys = { { StudentRepository::JoinDate, Qt::DescendingOrder } };
+        int rows = 0;
+
+        QBENCHMARK {
+            rows = repository.load(filter, false).size();
+        }
+        QVERIFY(rows <= sizes.students);
+        QVERIFY(repository.lastError().isEmpty());
+    }
+
+    void paymentRange_data()
+    {
+        QTest::addColumn<int>("days");
+
+        QTest::newRow("7") << 7;
+        QTest::newRow("30") << 30;
+        QTest::newRow("365") << 365;
+    }
+
+    // 财务页按日期范围筛选
+    void paymentRange()
+    {
+        QFETCH(int, days);
+
+        PaymentRepository repository(database());
+        PaymentFilter     filter;
+        filter.from = QDate::currentDate().addDays(-days);
+        filter.to = QDate::currentDate();
+
+        QBENCHMARK {
+            repository.load(filter);
+        }
+        QVERIFY(repository.lastError().isEmpty());
+    }
+
+    // 财务页饼图和折线图，最近一个月
+    void chartAggregation()
+    {
+        PaymentRepository repository(database());
+        PaymentFilter     filter;
+        filter.from = QDate::currentDate().addMonths(-1);
+        filter.to = QDate::currentDate();
+
+        QBENCHMARK {
+            repository.totalsByType(filter);
+            repository.dailyTotals(filter);
+        }
+        QVERIFY(repository.lastError().isEmpty());
+    }
+
+    // 课程表切换到本周
+    void scheduleWeekLoad()
+    {
+        ScheduleRepository repository(database());
+        const QDate monday = QDate::currentDate().addDays(1 - QDate::currentDate().dayOfWeek());
+
+        QBENCHMARK {
+            repository.loadRange(monday, monday.addDays(6));
+        }
+        QVERIFY(repository.lastError().isEmpty());
+    }
+
+    // 某个学生半年内的全部课程，走 (student_id, date) 索引
+    void scheduleStudentTerm()
+    {
+        ScheduleRepository repository(database());
+        const QString studentId = DatasetGenerator::studentId(0);
+
+        QBENCHMARK {
+            repository.loadForStudent(studentId, QDate::currentDate().addMonths(-3),
+                                      QDate::currentDate().addMonths(3));
+        }
+        QVERIFY(repository.lastError().isEmpty());
+    }
+
+    void honorWallLoad()
+    {
+        HonorRepository repository(database());
+        int images = 0;
+
+        QBENCHMARK {
+            images = repository.loadAll().size();
+        }
+        QCOMPARE(images, sizes.honorImages);
+    }
+
+    // 荣誉墙显示前还要解码全部图片
+    void honorWallDecode()
+    {
+        const QVector<HonorImage> images = HonorRepository(database()).loadAll();
+
+        QBENCHMARK {
+            for (const HonorImage& image : images) QImage::fromData(image.imageData);
+        }
+    }
+
+    // 全局搜索框：两个字的词逐行 LIKE，命中全部学生后取最新的 20 条；
+    // 三个字以上的词走 trigram 索引，按 bm25 排序
+    void globalSearch_data()
+    {
+        QTest::addColumn<QString>("text");
+
+        QTest::newRow("broad") << QString("学生");
+        QTest::newRow("narrow") << QString("学生12");
+        QTest::newRow("notes") << QString("第1");
+        QTest::newRow("notes-indexed") << QString("第12笔");
+    }
+
+    void globalSearch()
+    {
+        QFETCH(QString, text);
+
+        SearchRepository repository(database());
+        int hits = 0;
+
+        QBENCHMARK {
+            hits = repository.search(text, allKinds, 20).size();
+        }
+        QVERIFY(hits > 0);
+    }
+
+    // 登录对话框 validateUser()
+    void loginValidation()
+    {
+        UserRepository repository(database());
+        bool valid = false;
+
+        QBENCHMARK {
+            UserRecord user;
+            valid = repository.findByUsername(DatasetGenerator::benchUsername, user) &&
+                    PasswordHasher::verify(DatasetGenerator::benchPassword, user.passwordHash);
+        }
+        QVERIFY(valid);
+    }
+
+private:
+
+    QSqlDatabase database() const {
+        return QSqlDatabase::database(connectionName);
+    }
+
+    DatasetGenerator::Sizes sizes;
+    QTemporaryDir tempDir;
+    qint64 dbBytes = 0;
+};
+
+namespace {
+// 把 Qt Test 的 XML 结果转换为 JSON，每个 QBENCHMARK 一项
+bool writeJson(const QString& xmlPath, const QString& jsonPath,
+               const DatasetGenerator::Sizes& sizes, qint64 databaseBytes)
+{
+    QFile xmlFile(xmlPath);
+
+    if (!xmlFile.open(QIODevice::ReadOnly)) return false;
+
+    QJsonArray       results;
+    QJsonArray       failures;
+    QString          function;
+    QXmlStreamReader xml(&xmlFile);
+
+    while (!xml.atEnd()) {
+        if (!xml.readNextStartElement()) continue;
+
+        const QXmlStreamAttributes attributes = xml.attributes();
+
+        if (xml.name() == QLatin1String("TestFunction")) {
+            function = attributes.value("name").toString();
+        }
+        else if (xml.name() == QLatin1String("BenchmarkResult")) {
+            QJsonObject result;
+            result["name"] = function;
+            result["tag"] = attributes.value("tag").toString();
+            result["metric"] = attributes.value("metric").toString();
+            result["value"] = attributes.value("value").toDouble();
+            result["iterations"] = attributes.value("iterations").toInt();
+            results.append(result);
+        }
+        else if ((xml.name() == QLatin1String("Incident")) &&
+                 attributes.value("type").startsWith(QLatin1String("fail"))) {
+            failures.append(function);
+        }
+    }
+
+    if (xml.hasError()) return false;
+
+    QJsonObject dataset;
+    dataset["students"] = sizes.students;
+    dataset["payments"] = sizes.payments;
+    dataset["schedule"] = sizes.schedule;
+    dataset["honorImages"] = sizes.honorImages;
+    dataset["photoSize"] = sizes.photoSize;
+    dataset["databaseBytes"] = databaseBytes;
+
+    QJsonObject root;
+    root["suite"] = "smsbench";
+    root["timestamp"] = QDateTime::currentDateTimeUtc().toString(Qt::ISODate);
+    root["qtVersion"] = qVersion();
+    root["dataset"] = dataset;
+    root["results"] = results;
+    root["failures"] = failures;
+
+    QFile jsonFile(jsonPath);
+
+    if (!jsonFile.open(QIODevice::WriteOnly | QIODevice::Truncate)) return false;
+
+    jsonFile.write(QJsonDocument(root).toJson());
+    return true;
+}
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+
+    DatasetGenerator::Sizes sizes;
+    QString     jsonPath = "smsbench.json";
+    QStringList testArgs = { app.arguments().value(0) };
+
+    // 自己的参数在这里处理，其余原样交给 Qt Test（如 -iterations、-minimumvalue、函数名）
+    const QStringList args = app.arguments();
+
+    for (int i = 1; i < args.size(); ++i) {
+        const QString arg = args[i];
+        const bool    hasValue = i + 1 < args.size();
+
+        if ((arg == "--students") && hasValue) sizes.students = args[++i].toInt();
+        else if ((arg == "--payments") && hasValue) sizes.payments = args[++i].toInt();
+        else if ((arg == "--schedule") && hasValue) sizes.schedule = args[++i].toInt();
+        else if ((arg == "--honor") && hasValue) sizes.honorImages = args[++i].toInt();
+        else if ((arg == "--json") && hasValue) jsonPath = args[++i];
+        else testArgs << arg;
+    }
+
+    QTemporaryDir outputDir;
+    const QString xmlPath = outputDir.filePath("smsbench.xml");
+
+    testArgs << "-o" << xmlPath + ",xml" << "-o" << "-,txt";
+
+    SmsBench  bench(sizes);
+    const int failed = QTest::qExec(&bench, testArgs);
+
+    if (!writeJson(xmlPath, jsonPath, sizes, bench.databaseBytes())) {
+        qWarning() << "无法写入 JSON 结果:" << jsonPath;
+        return 1;
+    }
+    return failed;
+}
+
+#include "smsbench.moc"
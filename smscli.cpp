@@ -0,0 +1,478 @@
+// 命令行入口：不创建任何窗口，不加载样式表，用于服务器上的批量导入导出、
+// 报表、数据库维护和性能测试。与界面程序共用 smscore 中的数据访问代码
+#include "databasemanager.h"
+#include "databasebackup.h"
+#include "dataexporter.h"
+#include "dataimporter.h"
+#include "eventloopmonitor.h"
+#include "passwordhasher.h"
+#include "paymentrepository.h"
+#include "schedulerepository.h"
+#include "settings.h"
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonDocument>
+#include <QSqlError>
+#include <QSqlQuery>
+#include <QTextStream>
+
+namespace {
+QTextStream& out()
+{
+    static QTextStream stream(stdout);
+    return stream;
+}
+
+QTextStream& err()
+{
+    static QTextStream stream(stderr);
+    return stream;
+}
+
+// 退出码：0 成功，1 执行失败，2 参数错误
+enum ExitCode {
+    ExitOk = 0,
+    ExitFailed = 1,
+    ExitUsage = 2
+};
+
+int usageError(QCommandLineParser& parser, const QString& message)
+{
+    err() << message << Qt::endl << Qt::endl << parser.helpText();
+    return ExitUsage;
+}
+
+int runImport(const QCommandLineParser& parser, const QStringList& args)
+{
+    static const QStringList kinds = { "students", "payments", "schedule" };
+
+    if ((args.size() < 3) || !kinds.contains(args[1])) {
+        err() << "用法: smscli import students|payments|schedule <文件>" << Qt::endl;
+        return ExitUsage;
+    }
+
+    DataImporter importer;
+    importer.setEncoding(parser.value("encoding") == "system"
+                         ? DataImporter::System : DataImporter::Utf8);
+
+    if (parser.isSet("batch")) importer.setBatchSize(parser.value("batch").toInt());
+
+    QObject::connect(&importer, &DataImporter::rowRejected,
+                     [](qint64 line, const QString& message) {
+        err() << "第 " << line << " 行: " << message << Qt::endl;
+    });
+
+    ImportReport report = importer.importFile(DataImporter::Kind(kinds.indexOf(args[1])), args[2]);
+
+    out() << "rows=" << report.totalRows
+          << " imported=" << report.imported
+          << " rejected=" << report.rejected
+          << " elapsed_ms=" << report.elapsedMs
+          << " rows_per_sec=" << QString::number(report.rowsPerSecond(), 'f', 0)
+          << Qt::endl;
+
+    if (!report.fatalError.isEmpty()) {
+        err() << report.fatalError << Qt::endl;
+        return ExitFailed;
+    }
+    return ExitOk;
+}
+
+ExportFilter filterFromOptions(const QCommandLineParser& parser)
+{
+    ExportFilter filter;
+
+    filter.from = QDate::fromString(parser.value("from"), "yyyy-MM-dd");
+    filter.to = QDate::fromString(parser.value("to"), "yyyy-MM-dd");
+    filter.studentId = parser.value("student");
+    return filter;
+}
+
+int runExport(const QCommandLineParser& parser, const QStringList& args)
+{
+    static const QStringList kinds = { "students", "payments", "schedule" };
+
+    if ((args.size() < 3) || !kinds.contains(args[1])) {
+        err() << "用法: smscli export students|payments|schedule <文件>" << Qt::endl;
+        return ExitUsage;
+    }
+
+    DataExporter exporter;
+    exporter.setPhotoDirectory(parser.value("photos"));
+
+    QElapsedTimer timer;
+    timer.start();
+
+    bool ok = exporter.exportTo(DataExporter::Kind(kinds.indexOf(args[1])),
+                                parser.value("format") == "json"
+                                ? DataExporter::Json : DataExporter::Csv,
+                                args[2], filterFromOptions(parser));
+
+    if (!ok) {
+        err() << exporter.lastError() << Qt::endl;
+        return ExitFailed;
+    }
+    out() << "rows=" << exporter.exportedRows()
+          << " elapsed_ms=" << timer.elapsed() << Qt::endl;
+    return ExitOk;
+}
+
+// --output 指定时写入文件，否则写到标准输出；打开失败返回 nullptr
+QTextStream* openOutput(const QCommandLineParser& parser, QFile& file, QTextStream& fileStream)
+{
+    if (!parser.isSet("output")) return &out();
+
+    file.setFileName(parser.value("output"));
+
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        err() << "无法创建文件: " << file.errorString() << Qt::endl;
+        return nullptr;
+    }
+    fileStream.setDevice(&file);
+    return &fileStream;
+}
+
+// 缴费汇总报表，按月份、支付类型或学生分组，CSV 格式输出
+int runReport(const QCommandLineParser& parser, const QStringList& args)
+{
+    const QString groupBy = args.value(1, "month");
+    const QStringList groups = { "month", "type", "student" };
+
+    if (!groups.contains(groupBy)) {
+        err() << "用法: smscli report [month|type|student]" << Qt::endl;
+        return ExitUsage;
+    }
+
+    PaymentRepository repository;
+    const QVector<PaymentSummary> rows = repository.summarize(
+        filterFromOptions(parser), PaymentRepository::GroupBy(groups.indexOf(groupBy)));
+
+    if (!repository.lastError().isEmpty()) {
+        err() << "查询失败: " << repository.lastError() << Qt::endl;
+        return ExitFailed;
+    }
+
+    QFile       outputFile;
+    QTextStream fileStream;
+    QTextStream *stream = openOutput(parser, outputFile, fileStream);
+
+    if (!stream) return ExitFailed;
+
+    *stream << groupBy << ",count,total\n";
+
+    for (const PaymentSummary& row : rows) {
+        *stream << row.key << ',' << row.count << ','
+                << QString::number(row.total, 'f', 2) << '\n';
+    }
+    stream->flush();
+    return ExitOk;
+}
+
+// 课时统计：students 为每个学生的课时，slots 为星期几 × 时间段的课程数，
+// days 为课程最多的日期。默认统计最近四周，CSV 格式输出
+int runOccupancy(const QCommandLineParser& parser, const QStringList& args)
+{
+    const QString view = args.value(1, "students");
+
+    if (!QStringList({ "students", "slots", "days" }).contains(view)) {
+        err() << "用法: smscli occupancy [students|slots|days]" << Qt::endl;
+        return ExitUsage;
+    }
+
+    ExportFilter filter = filterFromOptions(parser);
+    const QDate  to = filter.to.isValid() ? filter.to : QDate::currentDate();
+    const QDate  from = filter.from.isValid() ? filter.from : to.addDays(-27);
+
+    ScheduleRepository repository;
+    QFile       outputFile;
+    QTextStream fileStream;
+    QTextStream *stream = openOutput(parser, outputFile, fileStream);
+
+    if (!stream) return ExitFailed;
+
+    if (view == "students") {
+        *stream << "student_id,student_name,lessons,days,first_date,last_date\n";
+
+        for (const StudentLoad& row : repository.studentLoad(from, to)) {
+            *stream << row.studentId << ',' << row.studentName << ',' << row.lessons << ','
+                    << row.days << ',' << row.firstDate.toString("yyyy-MM-dd") << ','
+                    << row.lastDate.toString("yyyy-MM-dd") << '\n';
+        }
+    }
+    else if (view == "slots") {
+        const QStringList& labels = ScheduleRepository::slotLabels();
+        const QVector<QVector<int> > counts = repository.slotOccupancy(from, to);
+
+        *stream << "day_of_week," << labels.join(',') << '\n';
+
+        for (int day = 0; day < counts.size(); ++day) {
+            *stream << day + 1;
+
+            for (int lessons : counts[day]) *stream << ',' << lessons;
+            *stream << '\n';
+        }
+    }
+    else {
+        *stream << "date,lessons\n";
+
+        for (const DayLoad& row : repository.busiestDays(from, to, 20)) {
+            *stream << row.date.toString("yyyy-MM-dd") << ',' << row.lessons << '\n';
+        }
+    }
+    stream->flush();
+
+    if (!repository.lastError().isEmpty()) {
+        err() << "查询失败: " << repository.lastError() << Qt::endl;
+        return ExitFailed;
+    }
+    return ExitOk;
+}
+
+// 数据库维护：vacuum 整理碎片，analyze 更新查询计划统计，check 完整性检查
+int runMaintenance(const QStringList& args)
+{
+    const QString task = args.value(1);
+    QString       sql;
+
+    if (task == "vacuum") sql = "VACUUM";
+    else if (task == "analyze") sql = "ANALYZE";
+    else if (task == "check") sql = "PRAGMA integrity_check";
+    else {
+        err() << "用法: smscli maintenance vacuum|analyze|check" << Qt::endl;
+        return ExitUsage;
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+
+    QSqlQuery query;
+
+    // 早期建的数据库没有启用增量清理，VACUUM 时一并转换，之后由界面程序空闲时分片清理
+    if ((task == "vacuum") && !query.exec("PRAGMA auto_vacuum = INCREMENTAL")) {
+        err() << "无法设置增量清理: " << query.lastError().text() << Qt::endl;
+    }
+
+    if (!query.exec(sql)) {
+        err() << task << " 失败: " << query.lastError().text() << Qt::endl;
+        return ExitFailed;
+    }
+
+    bool healthy = true;
+
+    while (query.next()) {
+        const QString line = query.value(0).toString();
+        out() << line << Qt::endl;
+
+        if (line != "ok") healthy = false;
+    }
+    out() << task << " elapsed_ms=" << timer.elapsed() << Qt::endl;
+    return healthy ? ExitOk : ExitFailed;
+}
+
+// 对界面中最常用的查询计时，每项重复执行 N 次后输出平均耗时
+int runBench(const QCommandLineParser& parser)
+{
+    const int iterations = qMax(1, parser.value("iterations").toInt());
+    const QString today = QDate::currentDate().toString("yyyy-MM-dd");
+    const QString monthAgo = QDate::currentDate().addMonths(-1).toString("yyyy-MM-dd");
+
+    struct Case {
+        const char  *name;
+        QString      sql;
+        QVariantList binds;
+    };
+    const QList<Case> cases = {
+        { "student_load",         "SELECT * FROM studentInfo",        {} },
+        { "student_names",        "SELECT id, name FROM studentInfo", {} },
+        { "payment_range",
+          "SELECT fr.id, s.name, fr.payment_date, fr.amount, fr.payment_type, fr.notes "
+          "FROM financialRecords fr JOIN studentInfo s ON fr.student_id = s.id "
+          "WHERE fr.payment_date BETWEEN ? AND ?",
+          { monthAgo, today } },
+        { "payment_by_type",
+          "SELECT payment_type, SUM(amount) FROM financialRecords "
+          "WHERE payment_date BETWEEN ? AND ? GROUP BY payment_type",
+          { monthAgo, today } },
+        { "schedule_week",
+          "SELECT date, slot, student_id, start_time FROM schedule WHERE date BETWEEN ? AND ?",
+          { QDate::currentDate().addDays(1 - QDate::currentDate().dayOfWeek())
+            .toString("yyyy-MM-dd"), today } },
+        { "honor_wall_load",      "SELECT id, image_data FROM honorWall", {} },
+    };
+
+    for (const Case& benchCase : cases) {
+        QElapsedTimer timer;
+        qint64 rows = 0;
+
+        timer.start();
+
+        for (int i = 0; i < iterations; ++i) {
+            QSqlQuery query;
+            query.setForwardOnly(true);
+            query.prepare(benchCase.sql);
+
+            for (const QVariant& value : benchCase.binds) query.addBindValue(value);
+
+            if (!query.exec()) {
+                err() << benchCase.name << " 失败: " << query.lastError().text() << Qt::endl;
+                return ExitFailed;
+            }
+
+            while (query.next()) ++rows;
+        }
+
+        out() << benchCase.name
+              << " avg_ms=" << QString::number(timer.nsecsElapsed() / 1e6 / iterations, 'f', 3)
+              << " rows=" << rows / iterations << Qt::endl;
+    }
+    return ExitOk;
+}
+
+// 在线备份：数据库可以同时被界面程序使用，快照保存到目录中并只保留最近的若干份
+int runBackup(const QCommandLineParser& parser, const QStringList& args)
+{
+    const QString directory = args.value(1, Settings::instance().getBackupDirectory());
+    const int     keep = parser.isSet("keep") ? parser.value("keep").toInt()
+                                              : Settings::instance().getBackupKeep();
+    QString file, error;
+    QElapsedTimer timer;
+
+    timer.start();
+
+    if (!DatabaseBackup::snapshot(DataBaseManager::instance().getDatabasePath(),
+                                  directory, keep, file, error)) {
+        err() << error << Qt::endl;
+        return ExitFailed;
+    }
+
+    out() << file
+          << " bytes=" << QFileInfo(file).size()
+          << " elapsed_ms=" << timer.elapsed()
+          << " kept=" << DatabaseBackup::snapshots(directory).size() << Qt::endl;
+    return ExitOk;
+}
+
+// 在本机校准密码哈希的迭代次数并写入 config.ini，之后新生成的哈希使用新的次数，
+// 旧哈希在用户下次登录时重新生成
+int runCalibrate(const QStringList& args)
+{
+    bool ok = true;
+    const int targetMs = args.size() > 1 ? args[1].toInt(&ok) : PasswordHasher::defaultTargetMs;
+
+    if (!ok || (targetMs <= 0)) {
+        err() << "用法: smscli calibrate [目标毫秒]" << Qt::endl;
+        return ExitUsage;
+    }
+
+    const int iterations = PasswordHasher::calibrate(targetMs);
+    const QString stored = PasswordHasher::hash("calibrate", iterations);
+    QElapsedTimer timer;
+
+    timer.start();
+    PasswordHasher::verify("calibrate", stored);
+
+    out() << "target_ms=" << targetMs
+          << " iterations=" << iterations
+          << " verify_ms=" << QString::number(timer.nsecsElapsed() / 1e6, 'f', 1)
+          << " previous=" << Settings::instance().getPasswordIterations() << Qt::endl;
+    Settings::instance().setPasswordIterations(iterations);
+    return ExitOk;
+}
+
+// 显示界面程序每分钟保存的事件循环卡顿统计
+int runStalls(const QStringList& args)
+{
+    const QString path = args.value(1, EventLoopMonitor::defaultDumpPath());
+    QFile file(path);
+
+    if (!file.open(QIODevice::ReadOnly)) {
+        err() << "无法打开文件: " << path << Qt::endl;
+        return ExitFailed;
+    }
+
+    const QJsonDocument document = QJsonDocument::fromJson(file.readAll());
+
+    if (!document.isObject()) {
+        err() << "文件格式错误: " << path << Qt::endl;
+        return ExitFailed;
+    }
+    out() << EventLoopMonitor::formatReport(document.object()) << Qt::flush;
+    return ExitOk;
+}
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+
+    QCoreApplication::setApplicationName("smscli");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription(
+        "教学管理系统命令行工具\n\n"
+        "命令:\n"
+        "  import students|payments|schedule <文件>  批量导入 CSV\n"
+        "  export students|payments|schedule <文件>  导出 CSV/JSON\n"
+        "  report [month|type|student]               缴费汇总报表\n"
+        "  occupancy [students|slots|days]           课时统计\n"
+        "  maintenance vacuum|analyze|check          数据库维护\n"
+        "  bench                                     常用查询计时\n"
+        "  calibrate [毫秒]                          按目标登录耗时校准密码哈希\n"
+        "  backup [目录]                             在线备份数据库快照\n"
+        "  stalls [文件]                             界面卡顿统计");
+    parser.addHelpOption();
+    parser.addPositionalArgument("command", "要执行的命令");
+    parser.addOptions({
+        { "db",         "数据库文件路径，默认使用 config.ini 中的设置", "path"    },
+        { "encoding",   "导入文件编码：utf8（默认）或 system",        "encoding" },
+        { "batch",      "导入时每个事务的行数",                      "rows"     },
+        { "format",     "导出格式：csv（默认）或 json",              "format"   },
+        { "from",       "起始日期 yyyy-MM-dd",                   "date"     },
+        { "to",         "结束日期 yyyy-MM-dd",                   "date"     },
+        { "student",    "只处理指定学号",                           "id"       },
+        { "photos",     "导出学生照片到该目录",                        "dir"      },
+        { "output",     "报表输出文件，默认输出到标准输出",                  "file"     },
+        { "iterations", "bench 每项查询的重复次数",                   "n", "20"  },
+        { "keep",       "backup 保留的快照份数，默认使用 config.ini 中的设置", "n"        },
+    });
+    parser.process(app);
+
+    const QStringList args = parser.positionalArguments();
+
+    if (args.isEmpty()) return usageError(parser, "缺少命令");
+
+    // 不需要数据库的命令
+    if (args.first() == "stalls") return runStalls(args);
+
+    if (args.first() == "calibrate") return runCalibrate(args);
+
+    const QString dbPath = parser.isSet("db") ? parser.value("db")
+                                              : Settings::instance().getDatabasePath();
+    DataBaseManager::instance().setDatabasePath(dbPath);
+
+    if (!QSqlDatabase::database().isOpen()) {
+        err() << "无法打开数据库: " << dbPath << Qt::endl;
+        return ExitFailed;
+    }
+
+    const QString command = args.first();
+
+    if (command == "import") return runImport(parser, args);
+
+    if (command == "export") return runExport(parser, args);
+
+    if (command == "report") return runReport(parser, args);
+
+    if (command == "occupancy") return runOccupancy(parser, args);
+
+    if (command == "maintenance") return runMaintenance(args);
+
+    if (command == "bench") return runBench(parser);
+
+    if (command == "backup") return runBackup(parser, args);
+
+    return usageError(parser, "未知命令: " + command);
+}
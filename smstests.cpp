@@ -0,0 +1,102 @@
+// 单元测试：每个用例在内存数据库中建好结构，检查数据访问层的行为。
+// 与 smsbench 不同，这里只判断对错，不计时，注册到 ctest
+#include "databasemanager.h"
+#include "searchrepository.h"
+#include <QSqlDatabase>
+#include <QSqlQuery>
+#include <QTest>
+
+namespace {
+const char *const connectionName = "smstests";
+const QVector<SearchHit::Kind> allKinds = { SearchHit::Student, SearchHit::Payment, SearchHit::Honor };
+}
+
+class SmsTests : public QObject {
+    Q_OBJECT
+
+private slots:
+
+    void init()
+    {
+        QSqlDatabase db = QSqlDatabase::addDatabase("QSQLITE", connectionName);
+        db.setDatabaseName(":memory:");
+        QVERIFY(db.open());
+        QVERIFY(DataBaseManager::ensureSchema(db));
+
+        QSqlQuery query(db);
+        QVERIFY(query.exec("INSERT INTO studentInfo (id, name, study_goal) VALUES "
+                           "('S0', '甲', ''), ('S1', '张伟', '希望提高数学成绩'), ('S2', '李娜', '英语')"));
+        QVERIFY(query.exec("INSERT INTO financialRecords (student_id, payment_date, notes) "
+                           "VALUES ('S1', '2024-03-01', '三月学费 现金')"));
+    }
+
+    void cleanup()
+    {
+        QSqlDatabase::database(connectionName).close();
+        QSqlDatabase::removeDatabase(connectionName);
+    }
+
+    // 备注和学习目标中间的中文词也要能搜到；两个字的词不走索引，逐行匹配
+    void searchFindsWordsInsideChineseText()
+    {
+        SearchRepository repository(database());
+
+        QVector<SearchHit> hits = repository.search("学费", allKinds);
+        QCOMPARE(hits.size(), 1);
+        QCOMPARE(hits[0].kind, SearchHit::Payment);
+        QCOMPARE(hits[0].studentId, QString("S1"));
+        QVERIFY(hits[0].snippet.contains("【学费】"));
+
+        hits = repository.search("数学", allKinds);
+        QCOMPARE(hits.size(), 1);
+        QCOMPARE(hits[0].kind, SearchHit::Student);
+        QCOMPARE(hits[0].ref, QString("S1"));
+
+        hits = repository.search("提高数学 张", allKinds);
+        QCOMPARE(hits.size(), 1);
+        QVERIFY(hits[0].snippet.contains("【提高数学】"));
+    }
+
+    // VACUUM 可能给 studentInfo 重新编号，学生的索引行按学号维护，之后修改和删除仍然同步
+    void searchFollowsStudentEditsAfterVacuum()
+    {
+        QSqlQuery query(database());
+        QVERIFY(query.exec("DELETE FROM studentInfo WHERE id = 'S0'"));
+        QVERIFY(query.exec("VACUUM"));
+        QVERIFY(query.exec("UPDATE studentInfo SET name = '张三' WHERE id = 'S1'"));
+
+        SearchRepository repository(database());
+        QVector<SearchHit> hits = repository.search("张三", allKinds);
+        QCOMPARE(hits.size(), 1);
+        QCOMPARE(hits[0].ref, QString("S1"));
+        QVERIFY(repository.search("张伟", allKinds).isEmpty());
+
+        QVERIFY(query.exec("DELETE FROM studentInfo WHERE id = 'S1'"));
+        QVERIFY(repository.search("数学", allKinds).isEmpty());
+        QCOMPARE(repository.search("李娜", allKinds).size(), 1);
+    }
+
+    // 没有权限的来源在 LIMIT 之前过滤，不占用名额
+    void searchFiltersKindsBeforeLimit()
+    {
+        QSqlQuery query(database());
+        QVERIFY(query.exec("INSERT INTO studentInfo (id, name, study_goal) VALUES ('S3', '王五', '学费')"));
+
+        SearchRepository repository(database());
+        QVERIFY(repository.search("学费", { SearchHit::Honor }).isEmpty());
+
+        const QVector<SearchHit> hits = repository.search("学费", { SearchHit::Payment }, 1);
+        QCOMPARE(hits.size(), 1);
+        QCOMPARE(hits[0].kind, SearchHit::Payment);
+    }
+
+private:
+
+    QSqlDatabase database() const {
+        return QSqlDatabase::database(connectionName);
+    }
+};
+
+QTEST_GUILESS_MAIN(SmsTests)
+
+#include "smstests.moc"
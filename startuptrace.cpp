@@ -0,0 +1,145 @@
+#include "startuptrace.h"
+#include "settings.h"
+#include <QCoreApplication>
+#include <QDebug>
+#include <QDir>
+#include <QEvent>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QThread>
+
+namespace {
+// 第一次收到 Paint 事件时记录时间点，然后移除自己
+class FirstPaintFilter : public QObject {
+public:
+
+    FirstPaintFilter(QObject *target, const char *name, bool finishTrace)
+        : QObject(target)
+        , name(name)
+        , finishTrace(finishTrace)
+    {}
+
+protected:
+
+    bool eventFilter(QObject *watched, QEvent *event) override
+    {
+        if (event->type() == QEvent::Paint) {
+            StartupTrace::instance().instant(name);
+
+            if (finishTrace) StartupTrace::instance().write();
+            watched->removeEventFilter(this);
+            deleteLater();
+        }
+        return false;
+    }
+
+private:
+
+    const char *name;
+    bool finishTrace;
+};
+}
+
+StartupTrace& StartupTrace::instance()
+{
+    static StartupTrace instance;
+
+    return instance;
+}
+
+StartupTrace::StartupTrace()
+{
+    clock.start();
+
+    const QString value = qEnvironmentVariable("SMS_TRACE");
+
+    if (value.isEmpty() || (value == "0")) return;
+
+    enabled = true;
+    path = (value == "1") ? QDir(Settings::logDirectory()).filePath("startup_trace.json") : value;
+}
+
+StartupTrace::Span::Span(const char *name)
+    : name(name)
+    , startUs(StartupTrace::instance().isEnabled() ? StartupTrace::instance().nowUs() : 0)
+{}
+
+StartupTrace::Span::~Span()
+{
+    StartupTrace& trace = StartupTrace::instance();
+
+    if (!trace.isEnabled()) return;
+
+    trace.record({ name, 'X', startUs, trace.nowUs() - startUs,
+                   quint64(quintptr(QThread::currentThreadId())) });
+}
+
+qint64 StartupTrace::nowUs() const
+{
+    return clock.nsecsElapsed() / 1000;
+}
+
+void StartupTrace::record(const Event& event)
+{
+    QMutexLocker locker(&mutex);
+
+    events.append(event);
+}
+
+void StartupTrace::instant(const char *name)
+{
+    if (!enabled) return;
+
+    record({ name, 'i', nowUs(), 0, quint64(quintptr(QThread::currentThreadId())) });
+}
+
+void StartupTrace::watchFirstPaint(QObject *window, const char *name, bool finishTrace)
+{
+    if (!enabled || !window) return;
+
+    window->installEventFilter(new FirstPaintFilter(window, name, finishTrace));
+}
+
+bool StartupTrace::write()
+{
+    if (!enabled) return false;
+
+    QJsonArray traceEvents;
+    const qint64 pid = QCoreApplication::instance() ? QCoreApplication::applicationPid() : 0;
+
+    {
+        QMutexLocker locker(&mutex);
+
+        for (const Event& event : events) {
+            QJsonObject object;
+            object["name"] = QString::fromUtf8(event.name);
+            object["cat"] = "startup";
+            object["ph"] = QString(QChar(event.phase));
+            object["ts"] = event.startUs;
+            object["pid"] = pid;
+            object["tid"] = qint64(event.threadId);
+
+            if (event.phase == 'X') object["dur"] = event.durationUs;
+            else object["s"] = "g"; // 时间点画成贯穿全部线程的竖线
+            traceEvents.append(object);
+        }
+    }
+
+    QJsonObject root;
+    root["traceEvents"] = traceEvents;
+    root["displayTimeUnit"] = "ms";
+
+    QDir().mkpath(QFileInfo(path).absolutePath());
+
+    QFile file(path);
+
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        qWarning() << "无法写入启动跟踪文件:" << path;
+        return false;
+    }
+    file.write(QJsonDocument(root).toJson(QJsonDocument::Compact));
+    return true;
+}
@@ -0,0 +1,71 @@
+#ifndef STARTUPTRACE_H
+#define STARTUPTRACE_H
+
+#include <QElapsedTimer>
+#include <QMutex>
+#include <QString>
+#include <QVector>
+
+class QObject;
+
+// 启动耗时跟踪：设置环境变量 SMS_TRACE 后记录各阶段的耗时，
+// 以 Chrome trace-event JSON 格式写出，可用 chrome://tracing 或 Perfetto 打开。
+// SMS_TRACE 为文件路径时写到该文件，为 1 时写到日志目录下的 startup_trace.json。
+// 未设置时 Span 只检查一个布尔值，不产生其他开销
+class StartupTrace {
+public:
+
+    static StartupTrace& instance();
+
+    // 作用域内的一个阶段，对应一个 "X" 事件
+    class Span {
+    public:
+
+        explicit Span(const char *name);
+        ~Span();
+
+    private:
+
+        const char *name;
+        qint64 startUs;
+    };
+
+    bool isEnabled() const {
+        return enabled;
+    }
+
+    // 单个时间点，对应一个 "i" 事件
+    void    instant(const char *name);
+
+    // 在 window 第一次绘制时记录时间点，finishTrace 为 true 时随后写出跟踪文件
+    void    watchFirstPaint(QObject *window, const char *name, bool finishTrace);
+
+    // 写出目前记录的全部事件，可多次调用
+    bool    write();
+    QString outputPath() const {
+        return path;
+    }
+
+private:
+
+    StartupTrace();
+
+    struct Event {
+        const char *name;
+        char        phase;
+        qint64      startUs;
+        qint64      durationUs;
+        quint64     threadId;
+    };
+
+    qint64 nowUs() const;
+    void   record(const Event& event);
+
+    bool enabled = false;
+    QString path;
+    QElapsedTimer clock;
+    QMutex mutex;
+    QVector<Event> events;
+};
+
+#endif // STARTUPTRACE_H
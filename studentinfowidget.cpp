@@ -1,7 +1,5 @@
 #include "studentinfowidget.h"
 #include "ui_studentinfowidget.h"
-#include <qsqldatabase.h>
-#include <QSqlQuery>
 #include <QDialog>
 #include <QGroupBox>
 #include <QFormLayout>
@@ -13,13 +11,24 @@
 #include <QStandardPaths>
 #include <QBuffer>
 #include <QMessageBox>
-#include <QSqlError>
+#include <QApplication>
+#include <QHeaderView>
+#include <QPushButton>
+#include <QTimer>
 #include "tabledelegates.h"
+#include "studentrepository.h"
+#include "databasemanager.h"
+#include "importdialog.h"
+#include "exportdialog.h"
+#include "eventloopmonitor.h"
+#include "startuptrace.h"
 
 StudentInfoWidget::StudentInfoWidget(QWidget *parent)
     : QWidget(parent)
     , ui(new Ui::StudentInfoWidget)
 {
+    StartupTrace::Span span(Q_FUNC_INFO);
+
     ui->setupUi(this);
     ui->tableWidget->verticalHeader()->setDefaultSectionSize(100);
     ui->tableWidget->setAlternatingRowColors(true);
@@ -57,6 +66,15 @@ StudentInfoWidget::StudentInfoWidget(QWidget *parent)
             this,
             &StudentInfoWidget::handleItemChanged);
 
+    connect(&DataBaseManager::instance(), &DataBaseManager::databaseSwitched, this,
+            &StudentInfoWidget::refreshTable);
+
+    // 排序在 SQL 中完成，不使用 QTableWidget 自带的排序
+    ui->tableWidget->horizontalHeader()->setSectionsClickable(true);
+    connect(ui->tableWidget->horizontalHeader(), &QHeaderView::sectionClicked, this,
+            &StudentInfoWidget::sortByColumn);
+
+    createFilterBar();
     refreshTable();
 }
 
@@ -67,66 +85,249 @@ StudentInfoWidget::~StudentInfoWidget()
 
 void StudentInfoWidget::refreshTable()
 {
+    EventLoopMonitor::ActivityScope activity(Q_FUNC_INFO);
+
     // 防止表格刷新时触发信号（如单元格点击信号）
     ui->tableWidget->blockSignals(true);
 
     // 清空表格所有行，但保留列标题
     ui->tableWidget->setRowCount(0);
 
-    // 执行SQL查询获取所有学生记录
-    QSqlQuery query("SELECT * FROM studentInfo");
+    // 按筛选栏和表头的条件从数据仓库读取学生记录
+    StudentRepository repository;
+    loadedFilter = currentFilter();
+    students = repository.load(loadedFilter);
+
+    // 一次性设置行数，避免逐行插入
+    ui->tableWidget->setRowCount(students.size());
+
+    // 遍历每个学生，填充对应的行
+    for (int row = 0; row < students.size(); ++row) {
+        const StudentRecord& student = students.at(row);
+
+        // 文本列内容，顺序与表格列一致
+        const QStringList texts = { student.id,
+                                    student.name,
+                                    student.gender,
+                                    student.birthday.toString("yyyy-MM-dd"),
+                                    student.joinDate.toString("yyyy-MM-dd"),
+                                    student.studyGoal,
+                                    student.progress };
+
+        for (int col = 0; col < texts.size(); ++col) {
+            // 创建新的表格项并设置居中显示
+            QTableWidgetItem *item = new QTableWidgetItem(texts.at(col));
+            item->setTextAlignment(Qt::AlignCenter);
+            ui->tableWidget->setItem(row, col, item);
+        }
 
-    // 遍历查询结果的每一行
-    while (query.next()) {
-        // 获取当前表格的行数，作为新行的索引
-        int row = ui->tableWidget->rowCount();
+        // 处理最后一列（照片列）
+        QTableWidgetItem *photoItem = new QTableWidgetItem();
+        photoItem->setTextAlignment(Qt::AlignCenter);
 
-        // 在表格末尾插入新行
-        ui->tableWidget->insertRow(row);
+        if (!student.photo.isEmpty()) {
+            // 从二进制数据加载图片
+            QPixmap photo;
+            photo.loadFromData(student.photo);
 
-        // 遍历表格的每一列
-        for (int col = 0; col < ui->tableWidget->columnCount(); ++col) {
-            // 创建新的表格项
-            QTableWidgetItem *item = new QTableWidgetItem();
+            // 设置为单元格的装饰数据（显示图片），并缩放至100x100像素
+            photoItem->setData(Qt::DecorationRole,
+                               photo.scaled(100, 100, Qt::KeepAspectRatio));
 
-            // 设置单元格内容居中显示
-            item->setTextAlignment(Qt::AlignCenter);
+            // 保存原始二进制数据到用户角色，便于后续使用
+            photoItem->setData(Qt::UserRole, student.photo);
+        }
+        ui->tableWidget->setItem(row, StudentRepository::Photo, photoItem);
+    }
 
-            // 处理最后一列（照片列）
-            if (col == ui->tableWidget->columnCount() - 1) {
-                // 从查询结果获取二进制照片数据
-                QByteArray photoData = query.value(col).toByteArray();
+    // 恢复表格信号触发
+    ui->tableWidget->blockSignals(false);
 
-                if (!photoData.isEmpty()) {
-                    // 创建QPixmap对象
-                    QPixmap photo;
+    applyRowFilter();
+}
 
-                    // 从二进制数据加载图片
-                    photo.loadFromData(photoData);
+void StudentInfoWidget::createFilterBar()
+{
+    genderFilter = new QComboBox(this);
+    genderFilter->addItems({ tr("全部"), tr("男"), tr("女") });
+
+    progressFilter = new QComboBox(this);
+    progressFilter->addItems({ tr("全部"), tr("0%"), tr("20%"), tr("40%"), tr("60%"), tr("80%"),
+                               tr("100%") });
+
+    // 最小日期显示为“不限”
+    for (QDateEdit **edit : { &joinFromEdit, &joinToEdit }) {
+        *edit = new QDateEdit(this);
+        (*edit)->setDisplayFormat("yyyy-MM-dd");
+        (*edit)->setCalendarPopup(true);
+        (*edit)->setMinimumDate(QDate(1900, 1, 1));
+        (*edit)->setSpecialValueText(tr("不限"));
+        (*edit)->setDate((*edit)->minimumDate());
+    }
 
-                    // 设置为单元格的装饰数据（显示图片），并缩放至100x100像素
-                    item->setData(Qt::DecorationRole,
-                                  photo.scaled(100, 100,
-                                               Qt::KeepAspectRatio));
+    goalFilterEdit = new QLineEdit(this);
+    goalFilterEdit->setPlaceholderText(tr("学习目标包含"));
+    goalFilterEdit->setClearButtonEnabled(true);
+
+    QPushButton *resetBtn = new QPushButton(tr("清除筛选"), this);
+    filterStatusLabel = new QLabel(this);
+
+    ui->filterLayout->addWidget(new QLabel(tr("性别"), this));
+    ui->filterLayout->addWidget(genderFilter);
+    ui->filterLayout->addWidget(new QLabel(tr("进度"), this));
+    ui->filterLayout->addWidget(progressFilter);
+    ui->filterLayout->addWidget(new QLabel(tr("入学日期"), this));
+    ui->filterLayout->addWidget(joinFromEdit);
+    ui->filterLayout->addWidget(new QLabel(tr("至"), this));
+    ui->filterLayout->addWidget(joinToEdit);
+    ui->filterLayout->addWidget(goalFilterEdit, 1);
+    ui->filterLayout->addWidget(resetBtn);
+    ui->filterLayout->addWidget(filterStatusLabel);
+
+    // 输入停顿后再筛选，连续修改只执行一次
+    filterTimer = new QTimer(this);
+    filterTimer->setSingleShot(true);
+    filterTimer->setInterval(150);
+
+    connect(filterTimer,    &QTimer::timeout, this, &StudentInfoWidget::applyFilter);
+    connect(genderFilter,   QOverload<int>::of(&QComboBox::currentIndexChanged), filterTimer,
+            qOverload<>(&QTimer::start));
+    connect(progressFilter, QOverload<int>::of(&QComboBox::currentIndexChanged), filterTimer,
+            qOverload<>(&QTimer::start));
+    connect(joinFromEdit,   &QDateEdit::dateChanged, filterTimer, qOverload<>(&QTimer::start));
+    connect(joinToEdit,     &QDateEdit::dateChanged, filterTimer, qOverload<>(&QTimer::start));
+    connect(goalFilterEdit, &QLineEdit::textChanged, filterTimer, qOverload<>(&QTimer::start));
+    connect(resetBtn,       &QPushButton::clicked, this, &StudentInfoWidget::resetFilter);
+}
 
-                    // 保存原始二进制数据到用户角色，便于后续使用
-                    item->setData(Qt::UserRole, photoData);
-                }
-            }
+StudentFilter StudentInfoWidget::currentFilter() const
+{
+    StudentFilter filter;
 
-            // 处理普通文本列
-            else {
-                // 将数据库字段值转换为文本并设置为单元格内容
-                item->setText(query.value(col).toString());
-            }
+    // 第 0 项是“全部”
+    if (genderFilter->currentIndex() > 0) filter.gender = genderFilter->currentText();
 
-            // 将创建的单元格项添加到表格的指定行列位置
-            ui->tableWidget->setItem(row, col, item);
-        }
+    if (progressFilter->currentIndex() > 0) filter.progress = progressFilter->currentText();
+
+    if (joinFromEdit->date() != joinFromEdit->minimumDate()) filter.joinFrom = joinFromEdit->date();
+
+    if (joinToEdit->date() != joinToEdit->minimumDate()) filter.joinTo = joinToEdit->date();
+
+    filter.goalText = goalFilterEdit->text().trimmed();
+    filter.sortKeys = sortKeys;
+    return filter;
+}
+
+void StudentInfoWidget::applyFilter()
+{
+    EventLoopMonitor::ActivityScope activity(Q_FUNC_INFO);
+
+    filterTimer->stop();
+
+    const StudentFilter filter = currentFilter();
+
+    // 已加载的行足够时不查询数据库，也不重新解码照片
+    if (filter.narrows(loadedFilter) && (filter.sortKeys == loadedFilter.sortKeys)) {
+        applyRowFilter();
+    }
+    else {
+        refreshTable();
     }
+}
 
-    // 恢复表格信号触发
-    ui->tableWidget->blockSignals(false);
+void StudentInfoWidget::applyRowFilter()
+{
+    const StudentFilter filter = currentFilter();
+    int visible = 0;
+
+    for (int row = 0; row < students.size(); ++row) {
+        const bool match = filter.matches(students.at(row));
+        ui->tableWidget->setRowHidden(row, !match);
+
+        if (match) ++visible;
+    }
+
+    // 排序键显示在状态中，表头只能显示第一个键
+    QStringList keys;
+
+    for (const StudentSortKey& key : sortKeys) {
+        keys << ui->tableWidget->horizontalHeaderItem(key.field)->text() +
+            (key.order == Qt::AscendingOrder ? "↑" : "↓");
+    }
+    filterStatusLabel->setText(keys.isEmpty()
+                               ? tr("共 %1 人").arg(visible)
+                               : tr("共 %1 人，排序：%2").arg(visible).arg(keys.join(" ")));
+}
+
+void StudentInfoWidget::resetFilter()
+{
+    for (QWidget *widget : std::initializer_list<QWidget *>{ genderFilter, progressFilter,
+                                                             joinFromEdit, joinToEdit,
+                                                             goalFilterEdit }) {
+        widget->blockSignals(true);
+    }
+    genderFilter->setCurrentIndex(0);
+    progressFilter->setCurrentIndex(0);
+    joinFromEdit->setDate(joinFromEdit->minimumDate());
+    joinToEdit->setDate(joinToEdit->minimumDate());
+    goalFilterEdit->clear();
+
+    for (QWidget *widget : std::initializer_list<QWidget *>{ genderFilter, progressFilter,
+                                                             joinFromEdit, joinToEdit,
+                                                             goalFilterEdit }) {
+        widget->blockSignals(false);
+    }
+    applyFilter();
+}
+
+void StudentInfoWidget::sortByColumn(int column)
+{
+    if (column == StudentRepository::Photo) return;
+
+    const StudentSortKey key = { StudentRepository::Field(column), Qt::AscendingOrder };
+    const bool append = QApplication::keyboardModifiers().testFlag(Qt::ShiftModifier);
+    int index = -1;
+
+    for (int i = 0; i < sortKeys.size(); ++i) {
+        if (sortKeys[i].field == key.field) index = i;
+    }
+
+    auto toggled = [](Qt::SortOrder order) {
+        return order == Qt::AscendingOrder ? Qt::DescendingOrder : Qt::AscendingOrder;
+    };
+
+    if (append) {
+        if (index >= 0) sortKeys[index].order = toggled(sortKeys[index].order);
+        else sortKeys.append(key);
+    }
+    else {
+        const Qt::SortOrder order = (index == 0) ? toggled(sortKeys[0].order) : Qt::AscendingOrder;
+        sortKeys = { { key.field, order } };
+    }
+
+    QHeaderView *header = ui->tableWidget->horizontalHeader();
+    header->setSortIndicatorShown(true);
+    header->setSortIndicator(sortKeys.first().field, sortKeys.first().order);
+    applyFilter();
+}
+
+void StudentInfoWidget::showStudent(const QString& id)
+{
+    // 找不到或被筛选隐藏时先清除筛选；仍找不到可能是其他地方刚添加的学生，刷新后再找一次
+    for (int attempt = 0; attempt < 3; ++attempt) {
+        for (int row = 0; row < ui->tableWidget->rowCount(); ++row) {
+            QTableWidgetItem *item = ui->tableWidget->item(row, StudentRepository::Id);
+
+            if (item && (item->text() == id) && !ui->tableWidget->isRowHidden(row)) {
+                ui->tableWidget->selectRow(row);
+                ui->tableWidget->scrollToItem(item, QAbstractItemView::PositionAtCenter);
+                return;
+            }
+        }
+
+        if (attempt == 0) resetFilter();
+        else if (attempt == 1) refreshTable();
+    }
 }
 
 QGroupBox * StudentInfoWidget::createFormGroup()
@@ -251,6 +452,8 @@ QGroupBox * StudentInfoWidget::createPhotoGroup()
 void StudentInfoWidget::handleDialogAccepted(QGroupBox *formGroup,
                                              QGroupBox *photoGroup)
 {
+    EventLoopMonitor::ActivityScope activity(Q_FUNC_INFO);
+
     // 通过对象名称查找表单控件
     QLineEdit *idEdit = formGroup->findChild<QLineEdit *>("idEdit");
     QLineEdit *nameEdit = formGroup->findChild<QLineEdit *>("nameEdit");
@@ -266,51 +469,40 @@ void StudentInfoWidget::handleDialogAccepted(QGroupBox *formGroup,
         return; // 验证失败则终止操作
     }
 
-    // 检查学号唯一性（数据库中是否已存在该学号）
-    QSqlQuery checkQuery;
-    checkQuery.prepare("SELECT id FROM studentInfo WHERE id = ?");
-    checkQuery.addBindValue(idEdit->text()); // 绑定学号参数
+    StudentRepository repository;
 
-    // 执行查询并检查结果
-    if (checkQuery.exec() && checkQuery.next()) {
+    // 检查学号唯一性（数据库中是否已存在该学号）
+    if (repository.exists(idEdit->text())) {
         QMessageBox::warning(this, tr("错误"),
                              tr("学号 %1 已存在！").arg(idEdit->text()));
         return; // 学号重复则终止操作
     }
 
+    // 收集表单数据
+    StudentRecord student;
+    student.id = idEdit->text();                      // 学号
+    student.name = nameEdit->text();                  // 姓名
+    student.gender = genderCombo->currentText();      // 性别
+    student.birthday = birthdayEdit->date();          // 出生日期
+    student.joinDate = joinDateEdit->date();          // 入学日期
+    student.studyGoal = goalEdit->text();             // 学习目标
+    student.progress = progressCombo->currentText();  // 学习进度
+    student.photo = photoData;                        // 照片数据，为空时存储NULL
+
     // 开启数据库事务（确保数据一致性）
-    QSqlDatabase::database().transaction();
-
-    // 准备插入SQL语句
-    QSqlQuery insertQuery;
-    insertQuery.prepare(
-        "INSERT INTO studentInfo "
-        "(id, name, gender, birthday, join_date, study_goal, progress, photo) "
-        "VALUES (?, ?, ?, ?, ?, ?, ?, ?)"
-        );
-
-    // 绑定表单数据到SQL参数（按顺序对应字段）
-    insertQuery.addBindValue(idEdit->text());                              // 学号
-    insertQuery.addBindValue(nameEdit->text());                            // 姓名
-    insertQuery.addBindValue(genderCombo->currentText());                  // 性别
-    insertQuery.addBindValue(birthdayEdit->date().toString("yyyy-MM-dd")); // 出生日期
-    insertQuery.addBindValue(joinDateEdit->date().toString("yyyy-MM-dd")); // 入学日期
-    insertQuery.addBindValue(goalEdit->text());                            // 学习目标
-    insertQuery.addBindValue(progressCombo->currentText());                // 学习进度
-    // 照片数据：如果为空则存储NULL，否则存储二进制数据
-    insertQuery.addBindValue(photoData.isEmpty() ? QVariant() : photoData);
+    repository.transaction();
 
     // 执行插入操作
-    if (!insertQuery.exec()) {
+    if (!repository.insert(student)) {
         // 插入失败时回滚事务
-        QSqlDatabase::database().rollback();
+        repository.rollback();
         QMessageBox::critical(this,
                               tr("错误"),
-                              tr("添加失败：") + insertQuery.lastError().text());
+                              tr("添加失败：") + repository.lastError());
     }
     else {
         // 插入成功时提交事务
-        QSqlDatabase::database().commit();
+        repository.commit();
         refreshTable(); // 刷新表格显示最新数据
         QMessageBox::information(this, tr("成功"),
                                  tr("已成功添加学生：%1").arg(nameEdit->text()));
@@ -362,6 +554,8 @@ void StudentInfoWidget::on_btnAdd_clicked()
 
 void StudentInfoWidget::on_btnDeleteItem_clicked()
 {
+    EventLoopMonitor::ActivityScope activity(Q_FUNC_INFO);
+
     // 获取表格中被选中的单元格
     auto selected = ui->tableWidget->selectedItems();
 
@@ -372,7 +566,8 @@ void StudentInfoWidget::on_btnDeleteItem_clicked()
     }
 
     // 开始数据库事务，确保所有更新操作要么全部成功，要么全部失败
-    QSqlDatabase::database().transaction();
+    StudentRepository repository;
+    repository.transaction();
 
     // 遍历所有选中的单元格
     foreach(QTableWidgetItem * item, selected) {
@@ -383,37 +578,19 @@ void StudentInfoWidget::on_btnDeleteItem_clicked()
         // 获取当前行的ID（假设ID在第0列）
         QString id = ui->tableWidget->item(row, 0)->text();
 
-        // 定义表格列名与数据库字段的映射关系
-        const QStringList columns =
-        { "id",        "name",        "gender",
-          "birthday",
-          "join_date", "study_goal",  "progress",
-          "photo" };
-
-        // 创建SQL查询对象
-        QSqlQuery query;
-
-        // 准备SQL语句：将指定ID记录的对应字段置为空
-        query.prepare(QString("UPDATE studentInfo SET %1 = ? WHERE id = ?").arg(
-                          columns[col]));
-
-        // 绑定要更新的值（空字符串）和ID条件
-        query.addBindValue("");
-        query.addBindValue(id);
-
-        // 执行SQL语句
-        if (!query.exec()) {
+        // 将指定ID记录的对应字段置为空
+        if (!repository.updateField(id, StudentRepository::Field(col), "")) {
             // 若执行失败，回滚整个事务
-            QSqlDatabase::database().rollback();
+            repository.rollback();
 
             // 显示错误消息
-            QMessageBox::critical(this, "错误", "更新失败：" + query.lastError().text());
+            QMessageBox::critical(this, "错误", "更新失败：" + repository.lastError());
             return;
         }
     }
 
     // 所有更新操作成功后提交事务
-    QSqlDatabase::database().commit();
+    repository.commit();
 
     // 刷新表格显示，反映数据库的最新状态
     refreshTable();
@@ -421,32 +598,45 @@ void StudentInfoWidget::on_btnDeleteItem_clicked()
 
 void StudentInfoWidget::on_btnDeleteLine_clicked()
 {
+    EventLoopMonitor::ActivityScope activity(Q_FUNC_INFO);
+
     auto selected = ui->tableWidget->selectionModel()->selectedRows();
 
     if (selected.isEmpty()) {
         QMessageBox::warning(this, "警告", "请先选择要删除的行！");
         return;
     }
-    QSqlDatabase::database().transaction(); // 启动一个数据库事务直到commit()或者rollback()
+    StudentRepository repository;
+    repository.transaction(); // 启动一个数据库事务直到commit()或者rollback()
     foreach(const QModelIndex& index, selected) {
-        QString   id = ui->tableWidget->item(index.row(), 0)->text();
-        QSqlQuery query;
+        QString id = ui->tableWidget->item(index.row(), 0)->text();
 
-        query.prepare("DELETE FROM studentInfo WHERE id = ?");
-        query.addBindValue(id);
-
-        if (!query.exec()) {
-            QSqlDatabase::database().rollback();
-            QMessageBox::critical(this, "错误", "删除失败：" + query.lastError().text());
+        if (!repository.remove(id)) {
+            repository.rollback();
+            QMessageBox::critical(this, "错误", "删除失败：" + repository.lastError());
             return;
         }
     }
-    QSqlDatabase::database().commit();
+    repository.commit();
     refreshTable();
 }
 
+// 从 CSV 文件批量导入学生
+void StudentInfoWidget::on_btnImport_clicked()
+{
+    if (execImportDialog(this, DataImporter::Students)) refreshTable();
+}
+
+// 导出学生信息，可选同时导出照片
+void StudentInfoWidget::on_btnExport_clicked()
+{
+    execExportDialog(this, DataExporter::Students);
+}
+
 void StudentInfoWidget::handleItemChanged(QTableWidgetItem *item)
 {
+    EventLoopMonitor::ActivityScope activity(Q_FUNC_INFO);
+
     // 获取当前修改项信息
     const int row = item->row();
     const int col = item->column();
@@ -461,45 +651,49 @@ void StudentInfoWidget::handleItemChanged(QTableWidgetItem *item)
     // 获取当前行的原始学号（作为更新条件）
     const QString originalId = ui->tableWidget->item(row, 0)->text();
 
-    // 映射列索引到数据库字段名
-    const QString columnName = QStringList{ "id", "name", "gender", "birthday",
-                                            "join_date", "study_goal", "progress",
-                                            "photo" }[col];
+    // 列索引与数据库字段一一对应
+    const StudentRepository::Field field = StudentRepository::Field(col);
 
     // 开始数据库事务（确保操作原子性）
-    QSqlDatabase::database().transaction();
+    StudentRepository repository;
+    repository.transaction();
 
     try {
-        // 准备SQL更新语句（动态构建要更新的字段）
-        QSqlQuery updateQuery;
-        updateQuery.prepare(QString(
-                                "UPDATE studentInfo SET %1 = ? WHERE id = ?").arg(
-                                columnName));
-
-        // 根据列类型绑定不同的数据
-        if (columnName == "photo") { // 处理图片列（存储二进制数据）
-            updateQuery.addBindValue(item->data(Qt::UserRole).toByteArray());
-        }
-        else {                       // 处理普通文本列（去除首尾空格）
-            updateQuery.addBindValue(item->text().trimmed());
-        }
-
-        // 绑定WHERE子句中的主键条件
-        updateQuery.addBindValue(originalId);
+        // 根据列类型准备不同的数据
+        const QVariant value = (field == StudentRepository::Photo)
+                               ? QVariant(item->data(Qt::UserRole).toByteArray()) // 图片列（二进制数据）
+                               : QVariant(item->text().trimmed());                // 普通文本列（去除首尾空格）
 
-        // 执行SQL语句
-        if (!updateQuery.exec()) {
+        // 执行更新
+        if (!repository.updateField(originalId, field, value)) {
             // 抛出异常并附带错误信息
             throw std::runtime_error(
-                      "更新失败: " + updateQuery.lastError().text().toStdString());
+                      "更新失败: " + repository.lastError().toStdString());
         }
 
         // 更新成功，提交事务
-        QSqlDatabase::database().commit();
+        repository.commit();
+
+        // 同步已加载的记录，之后在内存中筛选时按修改后的值判断
+        if (row < students.size()) {
+            StudentRecord& student = students[row];
+            const QString  text = value.toString();
+
+            switch (field) {
+            case StudentRepository::Name:      student.name = text; break;
+            case StudentRepository::Gender:    student.gender = text; break;
+            case StudentRepository::Birthday:  student.birthday = QDate::fromString(text, "yyyy-MM-dd"); break;
+            case StudentRepository::JoinDate:  student.joinDate = QDate::fromString(text, "yyyy-MM-dd"); break;
+            case StudentRepository::StudyGoal: student.studyGoal = text; break;
+            case StudentRepository::Progress:  student.progress = text; break;
+            case StudentRepository::Photo:     student.photo = value.toByteArray(); break;
+            default: break;
+            }
+        }
     }
     catch (const std::exception& e) {
         // 发生异常时回滚事务
-        QSqlDatabase::database().rollback();
+        repository.rollback();
 
         // 刷新表格恢复原始数据
         refreshTable();
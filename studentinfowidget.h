@@ -3,6 +3,7 @@
 
 #include <QWidget>
 #include <QByteArray>
+#include "studentrepository.h"
 
 namespace Ui {
 class StudentInfoWidget;
@@ -10,6 +11,11 @@ class StudentInfoWidget;
 
 class QGroupBox;
 class QTableWidgetItem;
+class QComboBox;
+class QDateEdit;
+class QLineEdit;
+class QLabel;
+class QTimer;
 
 class StudentInfoWidget : public QWidget {
     Q_OBJECT
@@ -19,6 +25,9 @@ public:
     explicit StudentInfoWidget(QWidget *parent = nullptr);
     ~StudentInfoWidget();
 
+    // 全局搜索结果：选中学号为 id 的行并滚动到可见
+    void showStudent(const QString& id);
+
 private slots:
 
     void on_btnAdd_clicked();
@@ -27,17 +36,46 @@ private slots:
 
     void on_btnDeleteLine_clicked();
 
+    void on_btnImport_clicked();
+
+    void on_btnExport_clicked();
+
     void handleItemChanged(QTableWidgetItem *item);
 
 private:
 
     void       refreshTable();
+
+    // 表格上方的筛选栏：性别、进度、入学日期范围、学习目标
+    void       createFilterBar();
+    StudentFilter currentFilter() const;
+
+    // 新条件只是在已加载的结果中进一步筛选时隐藏不满足的行，否则重新查询
+    void       applyFilter();
+    void       applyRowFilter();
+    void       resetFilter();
+
+    // 单击表头按该列排序，再次单击切换升降序；按住 Shift 单击追加为次要排序键
+    void       sortByColumn(int column);
+
     QGroupBox* createFormGroup();
     QGroupBox* createPhotoGroup();
     void       handleDialogAccepted(QGroupBox *formGroup,
                                     QGroupBox *photoGroup);
 
     QByteArray photoData;
+
+    QVector<StudentRecord> students;   // 表格中已加载的行，下标与行号一致
+    StudentFilter loadedFilter;        // students 是按这个条件从数据库读出的
+    QVector<StudentSortKey> sortKeys;
+    QComboBox *genderFilter;
+    QComboBox *progressFilter;
+    QDateEdit *joinFromEdit;
+    QDateEdit *joinToEdit;
+    QLineEdit *goalFilterEdit;
+    QLabel    *filterStatusLabel;
+    QTimer    *filterTimer;
+
     Ui::StudentInfoWidget *ui;
 };
 
@@ -0,0 +1,252 @@
+#include "studentrepository.h"
+
+namespace {
+const char *const selectColumns =
+    "id, name, gender, birthday, join_date, study_goal, progress";
+
+QVariant dateValue(const QDate& date)
+{
+    return date.isValid() ? date.toString("yyyy-MM-dd") : QString();
+}
+
+StudentRecord readRecord(const QSqlQuery& query, bool withPhoto)
+{
+    StudentRecord record;
+
+    record.id = query.value(0).toString();
+    record.name = query.value(1).toString();
+    record.gender = query.value(2).toString();
+    record.birthday = QDate::fromString(query.value(3).toString(), "yyyy-MM-dd");
+    record.joinDate = QDate::fromString(query.value(4).toString(), "yyyy-MM-dd");
+    record.studyGoal = query.value(5).toString();
+    record.progress = query.value(6).toString();
+
+    if (withPhoto) record.photo = query.value(7).toByteArray();
+    return record;
+}
+}
+
+QString StudentRepository::columnName(Field field)
+{
+    static const QStringList columns = { "id", "name", "gender", "birthday",
+                                         "join_date", "study_goal", "progress",
+                                         "photo" };
+
+    return columns.value(field);
+}
+
+bool StudentFilter::matches(const StudentRecord& record) const
+{
+    if (!gender.isEmpty() && (record.gender != gender)) return false;
+
+    if (!progress.isEmpty() && (record.progress != progress)) return false;
+
+    if (joinFrom.isValid() && !(record.joinDate.isValid() && (record.joinDate >= joinFrom))) return false;
+
+    if (joinTo.isValid() && !(record.joinDate.isValid() && (record.joinDate <= joinTo))) return false;
+
+    return goalText.isEmpty() || record.studyGoal.contains(goalText, Qt::CaseInsensitive);
+}
+
+bool StudentFilter::narrows(const StudentFilter& other) const
+{
+    return (other.gender.isEmpty() || (gender == other.gender)) &&
+           (other.progress.isEmpty() || (progress == other.progress)) &&
+           (!other.joinFrom.isValid() || (joinFrom.isValid() && (joinFrom >= other.joinFrom))) &&
+           (!other.joinTo.isValid() || (joinTo.isValid() && (joinTo <= other.joinTo))) &&
+           goalText.contains(other.goalText, Qt::CaseInsensitive);
+}
+
+QString StudentRepository::whereClause(const StudentFilter& filter,
+                                       QVariantList       & bindValues) const
+{
+    QStringList conditions;
+
+    if (!filter.gender.isEmpty()) {
+        conditions << "gender = ?";
+        bindValues << filter.gender;
+    }
+
+    if (!filter.progress.isEmpty()) {
+        conditions << "progress = ?";
+        bindValues << filter.progress;
+    }
+
+    if (filter.joinFrom.isValid()) {
+        conditions << "join_date >= ?";
+        bindValues << dateValue(filter.joinFrom);
+    }
+
+    if (filter.joinTo.isValid()) {
+        conditions << "join_date <= ?";
+        bindValues << dateValue(filter.joinTo);
+    }
+
+    // 包含匹配用不上索引，但不满足的行不必读出照片
+    if (!filter.goalText.isEmpty()) {
+        QString pattern = filter.goalText;
+        pattern.replace("\\", "\\\\").replace("%", "\\%").replace("_", "\\_");
+        conditions << "study_goal LIKE ? ESCAPE '\\'";
+        bindValues << "%" + pattern + "%";
+    }
+    return conditions.isEmpty() ? QString() : " WHERE " + conditions.join(" AND ");
+}
+
+// 进度保存为 "20%" 这样的文字，按数值排序；照片列不参与排序。
+// 没有排序键时保持表中的顺序，与以前的显示一致
+QString StudentRepository::orderClause(const StudentFilter& filter) const
+{
+    QStringList keys;
+    bool        hasId = false;
+
+    for (const StudentSortKey& key : filter.sortKeys) {
+        if (key.field == Photo) continue;
+
+        const QString column = (key.field == Progress) ? "CAST(progress AS INTEGER)"
+                                                       : columnName(key.field);
+        keys << column + (key.order == Qt::DescendingOrder ? " DESC" : "");
+        hasId = hasId || (key.field == Id);
+    }
+
+    if (keys.isEmpty()) return QString();
+
+    if (!hasId) keys << "id";
+    return " ORDER BY " + keys.join(", ");
+}
+
+QVector<StudentRecord> StudentRepository::loadAll(bool withPhoto)
+{
+    return load(StudentFilter(), withPhoto);
+}
+
+QVector<StudentRecord> StudentRepository::load(const StudentFilter& filter, bool withPhoto)
+{
+    QVector<StudentRecord> records;
+
+    forEach(filter, withPhoto, [&records](const StudentRecord& record) {
+        records.append(record);
+        return true;
+    });
+    return records;
+}
+
+bool StudentRepository::forEach(bool                                             withPhoto,
+                                const std::function<bool(const StudentRecord&)>& callback)
+{
+    return forEach(StudentFilter(), withPhoto, callback);
+}
+
+bool StudentRepository::forEach(const StudentFilter                            & filter,
+                                bool                                             withPhoto,
+                                const std::function<bool(const StudentRecord&)>& callback)
+{
+    QVariantList bindValues;
+    QSqlQuery    query = prepare(QString("SELECT %1%2 FROM studentInfo")
+                                 .arg(selectColumns, withPhoto ? ", photo" : "") +
+                                 whereClause(filter, bindValues) + orderClause(filter));
+
+    for (const QVariant& value : bindValues) query.addBindValue(value);
+
+    if (!exec(query)) return false;
+
+    while (next(query)) {
+        if (!callback(readRecord(query, withPhoto))) break;
+    }
+    return true;
+}
+
+QVector<StudentName> StudentRepository::loadNames()
+{
+    QVector<StudentName> names;
+    QSqlQuery query = prepare("SELECT id, name FROM studentInfo");
+
+    if (!exec(query)) return names;
+
+    while (next(query)) names.append({ query.value(0).toString(), query.value(1).toString() });
+    return names;
+}
+
+QSet<QString> StudentRepository::loadIds()
+{
+    QSet<QString> ids;
+    QSqlQuery     query = prepare("SELECT id FROM studentInfo");
+
+    if (!exec(query)) return ids;
+
+    while (next(query)) ids.insert(query.value(0).toString());
+    return ids;
+}
+
+bool StudentRepository::exists(const QString& id)
+{
+    QSqlQuery query = prepare("SELECT 1 FROM studentInfo WHERE id = ?");
+
+    query.addBindValue(id);
+    return exec(query) && next(query);
+}
+
+bool StudentRepository::insert(const StudentRecord& record)
+{
+    QSqlQuery query = prepare(
+        "INSERT INTO studentInfo "
+        "(id, name, gender, birthday, join_date, study_goal, progress, photo) "
+        "VALUES (?, ?, ?, ?, ?, ?, ?, ?)");
+
+    query.addBindValue(record.id);
+    query.addBindValue(record.name);
+    query.addBindValue(record.gender);
+    query.addBindValue(dateValue(record.birthday));
+    query.addBindValue(dateValue(record.joinDate));
+    query.addBindValue(record.studyGoal);
+    query.addBindValue(record.progress);
+
+    // 照片为空时存储 NULL
+    query.addBindValue(record.photo.isEmpty() ? QVariant() : QVariant(record.photo));
+    return exec(query);
+}
+
+bool StudentRepository::insertBatch(const QVector<StudentRecord>& records)
+{
+    QVariantList ids, names, genders, birthdays, joinDates, goals, progresses, photos;
+
+    for (const StudentRecord& record : records) {
+        ids << record.id;
+        names << record.name;
+        genders << record.gender;
+        birthdays << dateValue(record.birthday);
+        joinDates << dateValue(record.joinDate);
+        goals << record.studyGoal;
+        progresses << record.progress;
+        photos << (record.photo.isEmpty() ? QVariant() : QVariant(record.photo));
+    }
+
+    QSqlQuery query = prepare(
+        "INSERT INTO studentInfo "
+        "(id, name, gender, birthday, join_date, study_goal, progress, photo) "
+        "VALUES (?, ?, ?, ?, ?, ?, ?, ?)");
+
+    for (const QVariantList *column : { &ids, &names, &genders, &birthdays, &joinDates,
+                                        &goals, &progresses, &photos }) {
+        query.addBindValue(*column);
+    }
+    return execBatch(query);
+}
+
+bool StudentRepository::updateField(const QString& id, Field field,
+                                    const QVariant& value)
+{
+    QSqlQuery query = prepare(QString("UPDATE studentInfo SET %1 = ? WHERE id = ?")
+                              .arg(columnName(field)));
+
+    query.addBindValue(value);
+    query.addBindValue(id);
+    return exec(query);
+}
+
+bool StudentRepository::remove(const QString& id)
+{
+    QSqlQuery query = prepare("DELETE FROM studentInfo WHERE id = ?");
+
+    query.addBindValue(id);
+    return exec(query);
+}
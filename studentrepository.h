@@ -0,0 +1,108 @@
+#ifndef STUDENTREPOSITORY_H
+#define STUDENTREPOSITORY_H
+
+#include "repository.h"
+#include <QByteArray>
+#include <QDate>
+#include <QSet>
+#include <QVector>
+#include <functional>
+
+// studentInfo 表的一行
+struct StudentRecord {
+    QString    id;
+    QString    name;
+    QString    gender;
+    QDate      birthday;
+    QDate      joinDate;
+    QString    studyGoal;
+    QString    progress;
+    QByteArray photo; // 为空表示没有照片
+};
+
+// 下拉框等只需要学号和姓名的场合
+struct StudentName {
+    QString id;
+    QString name;
+};
+
+struct StudentFilter;
+
+class StudentRepository : public Repository {
+public:
+
+    // 字段顺序与 studentInfo 表及学生表格的列顺序一致
+    enum Field {
+        Id,
+        Name,
+        Gender,
+        Birthday,
+        JoinDate,
+        StudyGoal,
+        Progress,
+        Photo
+    };
+
+    using Repository::Repository;
+
+    static QString columnName(Field field);
+
+    QVector<StudentRecord> loadAll(bool withPhoto = true);
+
+    // 按条件筛选和排序，条件在 SQL 中执行
+    QVector<StudentRecord> load(const StudentFilter& filter, bool withPhoto = true);
+
+    // 逐行回调，不在内存中保留结果集；回调返回 false 时停止遍历
+    bool                   forEach(bool                                        withPhoto,
+                                   const std::function<bool(const StudentRecord&)>& callback);
+    bool                   forEach(const StudentFilter                          & filter,
+                                   bool                                        withPhoto,
+                                   const std::function<bool(const StudentRecord&)>& callback);
+    QVector<StudentName>   loadNames();
+    QSet<QString>          loadIds();
+    bool                   exists(const QString& id);
+
+    bool                   insert(const StudentRecord& record);
+
+    // 使用 execBatch() 批量插入，不开启事务，由调用方控制
+    bool                   insertBatch(const QVector<StudentRecord>& records);
+
+    // 修改单个字段，Photo 字段传 QByteArray，其余传字符串
+    bool                   updateField(const QString& id, Field field,
+                                       const QVariant& value);
+    bool                   remove(const QString& id);
+
+private:
+
+    QString                whereClause(const StudentFilter& filter,
+                                       QVariantList       & bindValues) const;
+    QString                orderClause(const StudentFilter& filter) const;
+};
+
+// 排序键：学生表格的一列和升降序
+struct StudentSortKey {
+    StudentRepository::Field field = StudentRepository::Id;
+    Qt::SortOrder            order = Qt::AscendingOrder;
+
+    bool operator==(const StudentSortKey& other) const {
+        return field == other.field && order == other.order;
+    }
+};
+
+// 学生表格顶部的筛选条件和表头的多列排序。
+// 入学日期和进度有索引，见 DataBaseManager::migrate()；matches() 在内存中判断同样的条件
+struct StudentFilter {
+    QString gender;                  // 为空表示不限
+    QString progress;                // 为空表示不限
+    QDate   joinFrom;                // 无效日期表示不限
+    QDate   joinTo;
+    QString goalText;                // 学习目标包含的文字，为空表示不限
+    QVector<StudentSortKey> sortKeys; // 前面的键优先，相同时按学号排序
+
+    bool matches(const StudentRecord& record) const;
+
+    // 满足本条件的记录一定满足 other 的条件，只需在 other 的结果中进一步筛选。不比较排序
+    bool narrows(const StudentFilter& other) const;
+};
+
+#endif // STUDENTREPOSITORY_H
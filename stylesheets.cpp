@@ -0,0 +1,64 @@
+#include "stylesheets.h"
+#include <QApplication>
+#include <QDebug>
+#include <QEvent>
+#include <QFile>
+#include <QHash>
+#include <QWidget>
+
+namespace {
+class FirstShowFilter : public QObject {
+public:
+
+    FirstShowFilter(QWidget *page, const QStringList& names)
+        : QObject(page)
+        , names(names)
+    {}
+
+protected:
+
+    bool eventFilter(QObject *watched, QEvent *event) override
+    {
+        if (event->type() == QEvent::Show) {
+            QString styleSheet;
+
+            for (const QString& name : names) styleSheet += StyleSheets::load(name);
+            static_cast<QWidget *>(watched)->setStyleSheet(styleSheet);
+            watched->removeEventFilter(this);
+            deleteLater();
+        }
+        return false;
+    }
+
+private:
+
+    QStringList names;
+};
+}
+
+QString StyleSheets::load(const QString& name)
+{
+    static QHash<QString, QString> cache;
+
+    auto it = cache.constFind(name);
+
+    if (it != cache.constEnd()) return it.value();
+
+    QFile file(":/style/" + name + ".qss");
+
+    if (!file.open(QFile::ReadOnly)) {
+        qWarning() << "打开失败" << file.fileName() << file.errorString();
+        return QString();
+    }
+    return cache.insert(name, QString::fromUtf8(file.readAll())).value();
+}
+
+void StyleSheets::applyBase(QApplication& app)
+{
+    app.setStyleSheet(load("base"));
+}
+
+void StyleSheets::applyOnFirstShow(QWidget *page, const QStringList& names)
+{
+    page->installEventFilter(new FirstShowFilter(page, names));
+}
@@ -0,0 +1,23 @@
+#ifndef STYLESHEETS_H
+#define STYLESHEETS_H
+
+#include <QString>
+#include <QStringList>
+
+class QApplication;
+class QWidget;
+
+// 样式表按用途拆分在 :/style/ 下：base.qss 设置到 QApplication，
+// 只有部分页面用到的样式（表格、分组框等）在页面第一次显示时才设置到该页面上，
+// 避免启动时为所有页面解析和套用整份样式表
+namespace StyleSheets {
+// 读取 :/style/<name>.qss，结果缓存
+QString load(const QString& name);
+
+void    applyBase(QApplication& app);
+
+// page 第一次收到 Show 事件时把 names 对应的样式表合并后设置到 page 上
+void    applyOnFirstShow(QWidget *page, const QStringList& names);
+}
+
+#endif // STYLESHEETS_H
@@ -4,21 +4,36 @@
 #include <QGridLayout>
 #include <QPushButton>
 #include <QCheckBox>
-#include <QSqlError>
 #include <QTextEdit>
 #include <QLabel>
 #include <QFileDialog>
+#include <QDir>
+#include <QFileInfo>
+#include <QApplication>
 #include "settings.h"
 #include <QMessageBox>
-#include <QSqlQuery>
-#include <QCryptographicHash>
+#include "userrepository.h"
+#include "passwordhasher.h"
+#include "session.h"
+#include "logindialog.h"
+#include "usermanagementdialog.h"
+#include <QSpinBox>
+#include <QProgressBar>
+#include <QGroupBox>
+#include <QVBoxLayout>
+#include "diagnosticswidget.h"
 
+#include "databasebackup.h"
 #include "databasemanager.h"
+#include "eventloopmonitor.h"
+#include "startuptrace.h"
 SystemSettingsWidget::SystemSettingsWidget(QWidget *parent)
     : QWidget(parent)
     , ui(new Ui::SystemSettingsWidget)
 {
-    setFixedSize(400, 600);
+    StartupTrace::Span span(Q_FUNC_INFO);
+
+    setFixedSize(760, 600);
     ui->setupUi(this);
     createUI();
     loadSettings();
@@ -33,11 +48,18 @@ void SystemSettingsWidget::createUI()
 {
     dbPathEdit = new QLineEdit(this);
     browseBtn = new QPushButton("浏览...", this);
+
     oldPwdEdit = new QLineEdit(this);
     newPwdEdit = new QLineEdit(this);
     confirmPwdEdit = new QLineEdit(this);
     cacheCheckBox = new QCheckBox("记住登录信息", this);
+    slowQuerySpin = new QSpinBox(this);
+    cacheWeeksSpin = new QSpinBox(this);
+    threadSpin = new QSpinBox(this);
+    sqliteCacheSpin = new QSpinBox(this);
     saveBtn = new QPushButton("保存", this);
+    userBtn = new QPushButton("用户管理...", this);
+    applyPermissions();
     versionInfoEdit = new QTextEdit(this);
 
     oldPwdEdit->setEchoMode(QLineEdit::Password);
@@ -47,6 +69,51 @@ void SystemSettingsWidget::createUI()
     versionInfoEdit->setPlainText(
         "教学管理系统 1.0\n 开发环境：QT C++ 6.8，Qt Creator 15.0.0，Win10");
     versionInfoEdit->setReadOnly(true);
+    versionInfoEdit->setMaximumHeight(60);
+
+    slowQuerySpin->setRange(0, 60000);
+    slowQuerySpin->setSuffix(" ms");
+    slowQuerySpin->setSpecialValueText("不记录");
+
+    // 性能参数，保存后立即生效
+    cacheWeeksSpin->setRange(0, 26);
+    cacheWeeksSpin->setPrefix("课程表缓存前后 ");
+    cacheWeeksSpin->setSuffix(" 周");
+    threadSpin->setRange(0, 64);
+    threadSpin->setPrefix("后台线程 ");
+    threadSpin->setSpecialValueText("后台线程 自动");
+    sqliteCacheSpin->setRange(64, 1024 * 1024);
+    sqliteCacheSpin->setSingleStep(1024);
+    sqliteCacheSpin->setPrefix("数据库缓存 ");
+    sqliteCacheSpin->setSuffix(" KB");
+    QHBoxLayout *performanceLayout = new QHBoxLayout;
+    performanceLayout->addWidget(cacheWeeksSpin);
+    performanceLayout->addWidget(threadSpin);
+    performanceLayout->addWidget(sqliteCacheSpin);
+
+    // 在线备份，在后台线程执行，备份期间可以继续使用
+    backup = new DatabaseBackup(this);
+    backupDirEdit = new QLineEdit(this);
+    backupKeepSpin = new QSpinBox(this);
+    backupKeepSpin->setRange(1, 365);
+    backupKeepSpin->setPrefix("保留 ");
+    backupKeepSpin->setSuffix(" 份");
+    backupBtn = new QPushButton("立即备份", this);
+    backupProgress = new QProgressBar(this);
+    backupProgress->setRange(0, 100);
+    backupProgress->setValue(0);
+    backupStatusLabel = new QLabel(this);
+    QHBoxLayout *backupLayout = new QHBoxLayout;
+    backupLayout->addWidget(backupDirEdit, 1);
+    backupLayout->addWidget(backupKeepSpin);
+    backupLayout->addWidget(backupBtn);
+    backupLayout->addWidget(backupProgress);
+
+    // 诊断面板
+    QGroupBox *diagnosticsGroup = new QGroupBox("诊断：最慢的 SQL 语句", this);
+    QVBoxLayout *diagnosticsLayout = new QVBoxLayout(diagnosticsGroup);
+    diagnosticsWidget = new DiagnosticsWidget(diagnosticsGroup);
+    diagnosticsLayout->addWidget(diagnosticsWidget);
 
     mainLayout = new QGridLayout(this);
     mainLayout->addWidget(            new QLabel("数据库路径:", this), 0, 0);
@@ -59,8 +126,18 @@ void SystemSettingsWidget::createUI()
     mainLayout->addWidget(            new QLabel("确认密码:", this),  3, 0);
     mainLayout->addWidget( confirmPwdEdit,                        3, 1, 1, 2);
     mainLayout->addWidget(  cacheCheckBox,                        4, 0, 1, 3);
-    mainLayout->addWidget(        saveBtn,                        5, 1, 1, 2);
-    mainLayout->addWidget(versionInfoEdit,                        6, 0, 1, 3);
+    mainLayout->addWidget(            new QLabel("慢查询阈值:", this), 5, 0);
+    mainLayout->addWidget(  slowQuerySpin,                        5, 1, 1, 2);
+    mainLayout->addWidget(            new QLabel("性能参数:", this), 6, 0);
+    mainLayout->addLayout(performanceLayout,                      6, 1, 1, 2);
+    mainLayout->addWidget(            new QLabel("备份目录:", this),  7, 0);
+    mainLayout->addLayout(   backupLayout,                        7, 1, 1, 2);
+    mainLayout->addWidget(backupStatusLabel,                      8, 1, 1, 2);
+    mainLayout->addWidget(        saveBtn,                        9, 1);
+    mainLayout->addWidget(        userBtn,                        9, 2);
+    mainLayout->addWidget(versionInfoEdit,                       10, 0, 1, 3);
+    mainLayout->addWidget(diagnosticsGroup,                      11, 0, 1, 3);
+    mainLayout->setRowStretch(11, 1);
     setLayout(mainLayout);
 
     connect(browseBtn, &QPushButton::clicked, this,
@@ -68,6 +145,19 @@ void SystemSettingsWidget::createUI()
 
     connect(  saveBtn, &QPushButton::clicked, this,
               &SystemSettingsWidget::saveSettings);
+
+    connect(backupBtn, &QPushButton::clicked, this,
+            &SystemSettingsWidget::startBackup);
+    connect(   backup, &DatabaseBackup::progress, this, [this](qint64 written, qint64 total) {
+        backupProgress->setValue(total > 0 ? int(qMin<qint64>(99, written * 100 / total)) : 0);
+    });
+    connect(   backup, &DatabaseBackup::finished, this,
+               &SystemSettingsWidget::backupFinished);
+
+    connect(  userBtn, &QPushButton::clicked, this, [this]() {
+        UserManagementDialog dialog(this);
+        dialog.exec();
+    });
 }
 
 // 加载当前设置
@@ -75,6 +165,12 @@ void SystemSettingsWidget::loadSettings()
 {
     dbPathEdit->setText(Settings::instance().getDatabasePath());
     cacheCheckBox->setChecked(Settings::instance().getCacheEnabled());
+    slowQuerySpin->setValue(Settings::instance().getSlowQueryThreshold());
+    cacheWeeksSpin->setValue(Settings::instance().getScheduleCacheWeeks());
+    threadSpin->setValue(Settings::instance().getBackgroundThreads());
+    sqliteCacheSpin->setValue(Settings::instance().getSqliteCacheKb());
+    backupDirEdit->setText(Settings::instance().getBackupDirectory());
+    backupKeepSpin->setValue(Settings::instance().getBackupKeep());
 }
 
 //选择数据库存储位置
@@ -93,20 +189,16 @@ void SystemSettingsWidget::browseDatabasePath()
 // 修改密码
 void SystemSettingsWidget::updatePassword()
 {
+    EventLoopMonitor::ActivityScope activity(Q_FUNC_INFO);
+
     if (!validatePasswordChange()) return;
 
-    QString newHash = QString(QCryptographicHash::hash(
-                                  newPwdEdit->text().toUtf8(),
-                                  QCryptographicHash::Sha256
-                                  ).toHex());
+    QString newHash = PasswordHasher::hash(newPwdEdit->text());
 
-    QSqlQuery query;
-    query.prepare("UPDATE users SET password = ? WHERE username = ?");
-    query.addBindValue( newHash);
-    query.addBindValue(Settings::instance().getLastUser());
+    UserRepository repository;
 
-    if (!query.exec()) {
-        QMessageBox::critical(this, "错误", "密码更新失败: " + query.lastError().text());
+    if (!repository.updatePassword(Session::instance().username(), newHash)) {
+        QMessageBox::critical(this, "错误", "密码更新失败: " + repository.lastError());
         return;
     }
     QMessageBox::information(this, "提示", "密码更新成功");
@@ -115,31 +207,26 @@ void SystemSettingsWidget::updatePassword()
 // 密码有效性验证
 bool SystemSettingsWidget::validatePasswordChange()
 {
+    EventLoopMonitor::ActivityScope activity(Q_FUNC_INFO);
+
     if (newPwdEdit->text() != confirmPwdEdit->text()) {
         QMessageBox::warning(this, "错误", "新密码与确认密码不一致");
         return false;
     }
-    QString currentUser = Settings::instance().getLastUser();
+    QString currentUser = Session::instance().username();
 
     if (currentUser.isEmpty()) {
         QMessageBox::warning(this, "错误", "未找到当前用户");
         return false;
     }
-    QSqlQuery query;
-    query.prepare("SELECT password FROM users WHERE username = ?");
-    query.addBindValue(currentUser);
+    UserRepository repository;
+    UserRecord     user;
 
-    if (!query.exec() || !query.next()) {
-        QMessageBox::critical(this, "错误", "数据库查询失败: " + query.lastError().text());
+    if (!repository.findByUsername(currentUser, user)) {
+        QMessageBox::critical(this, "错误", "数据库查询失败: " + repository.lastError());
         return false;
     }
-    QString storedHash = query.value(0).toString();
-    QString inputHash = QString(QCryptographicHash::hash(
-                                    oldPwdEdit->text().toUtf8(),
-                                    QCryptographicHash::Sha256
-                                    ).toHex());
-
-    if (storedHash != inputHash) {
+    if (!PasswordHasher::verify(oldPwdEdit->text(), user.passwordHash)) {
         QMessageBox::warning(this, "错误", "旧密码不正确");
         return false;
     }
@@ -151,24 +238,99 @@ void SystemSettingsWidget::saveSettings()
 {
     QString newDbPath = dbPathEdit->text();
 
-    Settings::instance().setDatabasePath(newDbPath);
     Settings::instance().setCacheEnabled(cacheCheckBox->isChecked());
+    Settings::instance().setSlowQueryThreshold(slowQuerySpin->value());
+    Settings::instance().setScheduleCacheWeeks(cacheWeeksSpin->value());
+    Settings::instance().setBackgroundThreads(threadSpin->value());
+    Settings::instance().setSqliteCacheKb(sqliteCacheSpin->value());
+    Settings::instance().setBackupDirectory(backupDirEdit->text());
+    Settings::instance().setBackupKeep(backupKeepSpin->value());
+    diagnosticsWidget->refresh();
 
     if (!newPwdEdit->text().isEmpty()) {
         updatePassword();
     }
 
-    // 检查数据库文件是否存在，若不存在则尝试创建
-    QFile file(newDbPath);
+    if (newDbPath != DataBaseManager::instance().getDatabasePath()) switchDatabase(newDbPath);
+}
+
+// 只允许管理员切换数据库和管理用户。切换数据库重新登录后再次调用
+void SystemSettingsWidget::applyPermissions()
+{
+    dbPathEdit->setEnabled(Session::instance().has(Session::ManageUsers));
+    browseBtn->setEnabled(Session::instance().has(Session::ManageUsers));
+    userBtn->setVisible(Session::instance().has(Session::ManageUsers));
+}
+
+// 立即切换数据库，文件不存在时确认后创建。新数据库的用户和密码与原来的无关，
+// 在新数据库上重新登录成功后才保存路径、通知各页面重新读取；取消登录则仍使用原数据库
+void SystemSettingsWidget::switchDatabase(const QString& path)
+{
+    EventLoopMonitor::ActivityScope activity(Q_FUNC_INFO);
+
+    const bool create = !QFileInfo::exists(path);
+
+    if (create && (QMessageBox::question(this, "新建数据库",
+                                         "文件不存在：\n" + path + "\n是否在该位置新建数据库？")
+                   != QMessageBox::Yes)) {
+        dbPathEdit->setText(DataBaseManager::instance().getDatabasePath());
+        return;
+    }
+
+    bool loginCancelled = false;
 
-    if (!file.exists()) {
-        if (!DataBaseManager::instance().openDatabase(newDbPath)) {
-            QMessageBox::critical(this, "错误", "无法创建新的数据库文件");
-            return;
-        }
+    QApplication::setOverrideCursor(Qt::WaitCursor);
+    const bool ok = DataBaseManager::instance().switchDatabase(path, create, [this, &loginCancelled] {
+        // 新建的数据库没有用户，登录对话框会创建初始管理员
+        QApplication::restoreOverrideCursor();
+        LoginDialog dialog(this);
+        loginCancelled = dialog.exec() != QDialog::Accepted;
+        QApplication::setOverrideCursor(Qt::WaitCursor);
+        return !loginCancelled;
+    });
+    QApplication::restoreOverrideCursor();
+
+    if (!ok) {
+        if (loginCancelled) QMessageBox::information(this, "提示", "没有在新数据库上登录，仍使用原数据库。");
+        else QMessageBox::critical(this, "错误", "切换数据库失败：" + DataBaseManager::instance().lastError());
+        dbPathEdit->setText(DataBaseManager::instance().getDatabasePath());
+        return;
     }
+    Settings::instance().setDatabasePath(path);
+    applyPermissions();
+    diagnosticsWidget->refresh();
+    QMessageBox::information(this, "提示", "已切换到数据库：" + path);
+
+    // 主窗口可能因此删除本页面，放在最后，之后不再访问成员
+    emit sessionChanged();
+}
 
-    if (newDbPath != Settings::instance().getDatabasePath()) {
-        QMessageBox::information(this, "提示", "数据库路径修改将在重启后生效");
+// 备份当前数据库，快照目录和保留份数同时保存到设置中
+void SystemSettingsWidget::startBackup()
+{
+    Settings::instance().setBackupDirectory(backupDirEdit->text());
+    Settings::instance().setBackupKeep(backupKeepSpin->value());
+
+    if (!backup->start(DataBaseManager::instance().getDatabasePath(),
+                       backupDirEdit->text(), backupKeepSpin->value())) return;
+
+    backupBtn->setEnabled(false);
+    backupProgress->setValue(0);
+    backupStatusLabel->setText("正在备份...");
+}
+
+void SystemSettingsWidget::backupFinished(bool ok, const QString& file, const QString& error)
+{
+    backupBtn->setEnabled(true);
+
+    if (!ok) {
+        backupProgress->setValue(0);
+        backupStatusLabel->setText("备份失败");
+        QMessageBox::critical(this, "错误", error);
+        return;
     }
+    backupProgress->setValue(100);
+    backupStatusLabel->setText(QString("已备份到 %1（%2 MB）")
+                               .arg(QDir::toNativeSeparators(file))
+                               .arg(QFileInfo(file).size() / 1048576.0, 0, 'f', 1));
 }
@@ -12,6 +12,11 @@ class QPushButton;
 class QCheckBox;
 class QTextEdit;
 class QGridLayout;
+class QSpinBox;
+class DiagnosticsWidget;
+class DatabaseBackup;
+class QProgressBar;
+class QLabel;
 
 class SystemSettingsWidget : public QWidget {
     Q_OBJECT
@@ -21,6 +26,16 @@ public:
     explicit SystemSettingsWidget(QWidget *parent = nullptr);
     ~SystemSettingsWidget();
 
+    // 主窗口关闭前据此判断是否有备份在进行
+    DatabaseBackup *databaseBackup() const {
+        return backup;
+    }
+
+signals:
+
+    // 切换数据库时在新数据库上重新登录，当前用户和权限可能变了，主窗口据此更新页面
+    void sessionChanged();
+
 private:
 
     void createUI();
@@ -29,13 +44,29 @@ private:
     void updatePassword();
     bool validatePasswordChange();
     void saveSettings();
+    void switchDatabase(const QString& path);
+    void applyPermissions();
+    void startBackup();
+    void backupFinished(bool ok, const QString& file, const QString& error);
     QLineEdit *dbPathEdit;
     QPushButton *browseBtn;
     QLineEdit *oldPwdEdit;
     QLineEdit *newPwdEdit;
     QLineEdit *confirmPwdEdit;
     QCheckBox *cacheCheckBox;
+    QSpinBox *slowQuerySpin;
+    QSpinBox *cacheWeeksSpin;
+    QSpinBox *threadSpin;
+    QSpinBox *sqliteCacheSpin;
+    QLineEdit *backupDirEdit;
+    QSpinBox *backupKeepSpin;
+    QPushButton *backupBtn;
+    QProgressBar *backupProgress;
+    QLabel *backupStatusLabel;
+    DatabaseBackup *backup;
+    DiagnosticsWidget *diagnosticsWidget;
     QPushButton *saveBtn;
+    QPushButton *userBtn;
     QTextEdit *versionInfoEdit;
     QGridLayout *mainLayout;
     Ui::SystemSettingsWidget *ui;
@@ -9,6 +9,7 @@
 #include <Qpainter>
 #include <QMouseEvent>
 #include <QFileDialog>
+#include <QApplication>
 
 // 自定义组合框委托类，继承自 QStyledItemDelegate
 class ComboBoxDelegate : public QStyledItemDelegate {
@@ -199,5 +200,61 @@ public:
     }
 };
 
+// 月视图、学期视图的课程单元格："姓名,HH:mm" 分两行绘制，姓名加粗，时间灰色
+class ScheduleCellDelegate : public QStyledItemDelegate {
+public:
+
+    explicit ScheduleCellDelegate(QObject *parent = nullptr) : QStyledItemDelegate(parent)
+    {}
+
+    void paint(QPainter                   *painter,
+               const QStyleOptionViewItem& option,
+               const QModelIndex         & index) const override {
+        const QString course = index.data(Qt::DisplayRole).toString();
+
+        if (course.isEmpty()) {
+            QStyledItemDelegate::paint(painter, option, index);
+            return;
+        }
+
+        // 先让基类画背景和选中状态，文字自己画
+        QStyleOptionViewItem backgroundOption(option);
+        initStyleOption(&backgroundOption, index);
+        backgroundOption.text.clear();
+        QStyle *style = backgroundOption.widget ? backgroundOption.widget->style() : QApplication::style();
+        style->drawControl(QStyle::CE_ItemViewItem, &backgroundOption, painter, backgroundOption.widget);
+
+        const QString name = course.section(',', 0, 0);
+        const QString time = course.section(',', 1);
+        QRect nameRect = option.rect;
+        QRect timeRect = option.rect;
+        nameRect.setBottom(option.rect.center().y());
+        timeRect.setTop(option.rect.center().y());
+
+        painter->save();
+        QFont boldFont = option.font;
+        boldFont.setBold(true);
+        painter->setFont(boldFont);
+        painter->setPen(option.state & QStyle::State_Selected
+                        ? option.palette.highlightedText().color()
+                        : option.palette.text().color());
+        painter->drawText(nameRect, Qt::AlignHCenter | Qt::AlignBottom, name);
+        painter->setFont(option.font);
+        painter->setPen(option.state & QStyle::State_Selected
+                        ? option.palette.highlightedText().color()
+                        : QColor(Qt::gray));
+        painter->drawText(timeRect, Qt::AlignHCenter | Qt::AlignTop, time);
+        painter->restore();
+    }
+
+    QSize sizeHint(const QStyleOptionViewItem& option,
+                   const QModelIndex         & index) const override {
+        QSize size = QStyledItemDelegate::sizeHint(option, index);
+
+        // 两行文字
+        size.setHeight(qMax(size.height(), option.fontMetrics.height() * 2 + 6));
+        return size;
+    }
+};
 
 #endif // TABLEDELEGATES_H
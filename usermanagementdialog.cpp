@@ -0,0 +1,238 @@
+#include "usermanagementdialog.h"
+#include "passwordhasher.h"
+#include "session.h"
+#include "userrepository.h"
+#include "eventloopmonitor.h"
+#include <QComboBox>
+#include <QFormLayout>
+#include <QGroupBox>
+#include <QHBoxLayout>
+#include <QHeaderView>
+#include <QInputDialog>
+#include <QLabel>
+#include <QLineEdit>
+#include <QMessageBox>
+#include <QPushButton>
+#include <QTableWidget>
+#include <QVBoxLayout>
+
+UserManagementDialog::UserManagementDialog(QWidget *parent)
+    : QDialog(parent)
+{
+    setWindowTitle("用户管理");
+    resize(520, 480);
+    createUI();
+    loadUsers();
+}
+
+void UserManagementDialog::createUI()
+{
+    QVBoxLayout *mainLayout = new QVBoxLayout(this);
+
+    // 已有用户
+    userTable = new QTableWidget(0, 2, this);
+    userTable->setHorizontalHeaderLabels({ "用户名", "角色" });
+    userTable->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    userTable->setSelectionBehavior(QAbstractItemView::SelectRows);
+    userTable->setSelectionMode(QAbstractItemView::SingleSelection);
+    userTable->horizontalHeader()->setSectionResizeMode(QHeaderView::Stretch);
+    userTable->verticalHeader()->hide();
+
+    QPushButton *roleButton = new QPushButton("修改角色", this);
+    QPushButton *resetButton = new QPushButton("重置密码", this);
+    QPushButton *removeButton = new QPushButton("删除用户", this);
+    QHBoxLayout *userButtons = new QHBoxLayout;
+    userButtons->addStretch();
+    userButtons->addWidget(roleButton);
+    userButtons->addWidget(resetButton);
+    userButtons->addWidget(removeButton);
+
+    // 新用户
+    QGroupBox   *newGroup = new QGroupBox("添加用户", this);
+    QFormLayout *form = new QFormLayout(newGroup);
+
+    usernameEdit = new QLineEdit(newGroup);
+    passwordEdit = new QLineEdit(newGroup);
+    passwordEdit->setEchoMode(QLineEdit::Password);
+    roleCombo = new QComboBox(newGroup);
+
+    UserRepository repository;
+    roleCombo->addItems(repository.roles());
+
+    permissionLabel = new QLabel(newGroup);
+    permissionLabel->setWordWrap(true);
+
+    QPushButton *addButton = new QPushButton("添加", newGroup);
+
+    form->addRow("用户名:", usernameEdit);
+    form->addRow("密码:",  passwordEdit);
+    form->addRow("角色:",  roleCombo);
+    form->addRow("权限:",  permissionLabel);
+    form->addRow(addButton);
+
+    mainLayout->addWidget(userTable);
+    mainLayout->addLayout(userButtons);
+    mainLayout->addWidget(newGroup);
+
+    connect(roleCombo,    &QComboBox::currentTextChanged, this,
+            &UserManagementDialog::showRolePermissions);
+    connect(addButton,    &QPushButton::clicked,          this, &UserManagementDialog::addUser);
+    connect(roleButton,   &QPushButton::clicked,          this, &UserManagementDialog::changeRole);
+    connect(resetButton,  &QPushButton::clicked,          this, &UserManagementDialog::resetPassword);
+    connect(removeButton, &QPushButton::clicked,          this, &UserManagementDialog::removeUser);
+    showRolePermissions();
+}
+
+void UserManagementDialog::loadUsers()
+{
+    UserRepository repository;
+    const QVector<UserRecord> users = repository.loadAll();
+
+    userTable->setRowCount(users.size());
+
+    for (int row = 0; row < users.size(); ++row) {
+        userTable->setItem(row, 0, new QTableWidgetItem(users[row].username));
+        userTable->setItem(row, 1, new QTableWidgetItem(users[row].role));
+    }
+
+    if (!repository.lastError().isEmpty()) {
+        QMessageBox::critical(this, "错误", "读取用户失败：" + repository.lastError());
+    }
+}
+
+// 显示所选角色能访问的页面
+void UserManagementDialog::showRolePermissions()
+{
+    UserRepository repository;
+    QStringList    labels;
+
+    for (const QString& name : repository.permissionsOf(roleCombo->currentText())) {
+        const int index = Session::permissionNames().indexOf(name);
+
+        if (index >= 0) labels.append(Session::permissionLabels()[index]);
+    }
+    permissionLabel->setText(labels.isEmpty() ? "无" : labels.join("、"));
+}
+
+QString UserManagementDialog::selectedUser() const
+{
+    const int row = userTable->currentRow();
+
+    return row < 0 ? QString() : userTable->item(row, 0)->text();
+}
+
+void UserManagementDialog::addUser()
+{
+    EventLoopMonitor::ActivityScope activity(Q_FUNC_INFO);
+
+    const QString username = usernameEdit->text().trimmed();
+
+    if (username.isEmpty() || passwordEdit->text().isEmpty()) {
+        QMessageBox::warning(this, "错误", "请输入用户名和密码");
+        return;
+    }
+
+    UserRepository repository;
+    UserRecord     user;
+
+    if (repository.findByUsername(username, user)) {
+        QMessageBox::warning(this, "错误", "用户名已存在");
+        return;
+    }
+
+    user.username = username;
+    user.passwordHash = PasswordHasher::hash(passwordEdit->text());
+    user.role = roleCombo->currentText();
+
+    if (!repository.insert(user)) {
+        QMessageBox::critical(this, "错误", "添加用户失败：" + repository.lastError());
+        return;
+    }
+    usernameEdit->clear();
+    passwordEdit->clear();
+    loadUsers();
+}
+
+// 修改后的角色在该用户下次登录时生效
+void UserManagementDialog::changeRole()
+{
+    const QString username = selectedUser();
+
+    if (username.isEmpty()) {
+        QMessageBox::warning(this, "错误", "请先选择一个用户");
+        return;
+    }
+
+    if (username == Session::instance().username()) {
+        QMessageBox::warning(this, "错误", "不能修改当前登录用户的角色");
+        return;
+    }
+
+    UserRepository repository;
+    const QStringList roles = repository.roles();
+    bool ok = false;
+    const QString role = QInputDialog::getItem(this, "修改角色", username + " 的角色：", roles,
+                                               roles.indexOf(userTable->item(userTable->currentRow(),
+                                                                             1)->text()),
+                                               false, &ok);
+
+    if (!ok) return;
+
+    if (!repository.updateRole(username, role)) {
+        QMessageBox::critical(this, "错误", "修改角色失败：" + repository.lastError());
+        return;
+    }
+    loadUsers();
+}
+
+void UserManagementDialog::resetPassword()
+{
+    const QString username = selectedUser();
+
+    if (username.isEmpty()) {
+        QMessageBox::warning(this, "错误", "请先选择一个用户");
+        return;
+    }
+
+    bool ok = false;
+    const QString password = QInputDialog::getText(this, "重置密码", username + " 的新密码：",
+                                                   QLineEdit::Password, QString(), &ok);
+
+    if (!ok || password.isEmpty()) return;
+
+    UserRepository repository;
+
+    if (!repository.updatePassword(username, PasswordHasher::hash(password))) {
+        QMessageBox::critical(this, "错误", "重置密码失败：" + repository.lastError());
+        return;
+    }
+    QMessageBox::information(this, "提示", "密码已重置");
+}
+
+void UserManagementDialog::removeUser()
+{
+    EventLoopMonitor::ActivityScope activity(Q_FUNC_INFO);
+
+    const QString username = selectedUser();
+
+    if (username.isEmpty()) {
+        QMessageBox::warning(this, "错误", "请先选择一个用户");
+        return;
+    }
+
+    if (username == Session::instance().username()) {
+        QMessageBox::warning(this, "错误", "不能删除当前登录的用户");
+        return;
+    }
+
+    if (QMessageBox::question(this, "确认删除",
+                              "确定要删除用户 " + username + " 吗？") != QMessageBox::Yes) return;
+
+    UserRepository repository;
+
+    if (!repository.remove(username)) {
+        QMessageBox::critical(this, "错误", "删除用户失败：" + repository.lastError());
+        return;
+    }
+    loadUsers();
+}
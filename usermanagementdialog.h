@@ -0,0 +1,38 @@
+#ifndef USERMANAGEMENTDIALOG_H
+#define USERMANAGEMENTDIALOG_H
+
+#include <QDialog>
+
+class QComboBox;
+class QLineEdit;
+class QTableWidget;
+class QLabel;
+
+// 用户管理：添加、删除用户，修改角色，重置密码。
+// 只有拥有"用户管理"权限的用户能打开；当前登录的用户不能删除自己或修改自己的角色
+class UserManagementDialog : public QDialog {
+    Q_OBJECT
+
+public:
+
+    explicit UserManagementDialog(QWidget *parent = nullptr);
+
+private:
+
+    void    createUI();
+    void    loadUsers();
+    void    showRolePermissions();
+    void    addUser();
+    void    changeRole();
+    void    resetPassword();
+    void    removeUser();
+    QString selectedUser() const;
+
+    QTableWidget *userTable;
+    QLineEdit *usernameEdit;
+    QLineEdit *passwordEdit;
+    QComboBox *roleCombo;
+    QLabel *permissionLabel;
+};
+
+#endif // USERMANAGEMENTDIALOG_H
@@ -0,0 +1,101 @@
+#include "userrepository.h"
+
+const QString UserRepository::adminRole = "管理员";
+
+bool UserRepository::hasUsers()
+{
+    QSqlQuery query = prepare("SELECT 1 FROM users LIMIT 1");
+
+    return exec(query) && next(query);
+}
+
+bool UserRepository::findByUsername(const QString& username, UserRecord& user)
+{
+    QSqlQuery query = prepare("SELECT username, password, role FROM users WHERE username = ?");
+
+    query.addBindValue(username);
+
+    if (!exec(query) || !next(query)) return false;
+
+    user.username = query.value(0).toString();
+    user.passwordHash = query.value(1).toString();
+    user.role = query.value(2).toString();
+    return true;
+}
+
+QVector<UserRecord> UserRepository::loadAll()
+{
+    QVector<UserRecord> users;
+    QSqlQuery query = prepare("SELECT username, role FROM users ORDER BY username");
+
+    if (!exec(query)) return users;
+
+    while (next(query)) {
+        UserRecord user;
+        user.username = query.value(0).toString();
+        user.role = query.value(1).toString();
+        users.append(user);
+    }
+    return users;
+}
+
+bool UserRepository::insert(const UserRecord& user)
+{
+    QSqlQuery query = prepare(
+        "INSERT INTO users (username, password, role) VALUES (:username, :password, :role)");
+
+    query.bindValue(":username", user.username);
+    query.bindValue(":password", user.passwordHash);
+    query.bindValue(":role",     user.role.isEmpty() ? adminRole : user.role);
+    return exec(query);
+}
+
+bool UserRepository::updatePassword(const QString& username, const QString& passwordHash)
+{
+    QSqlQuery query = prepare("UPDATE users SET password = ? WHERE username = ?");
+
+    query.addBindValue(passwordHash);
+    query.addBindValue(username);
+    return exec(query);
+}
+
+bool UserRepository::updateRole(const QString& username, const QString& role)
+{
+    QSqlQuery query = prepare("UPDATE users SET role = ? WHERE username = ?");
+
+    query.addBindValue(role);
+    query.addBindValue(username);
+    return exec(query);
+}
+
+bool UserRepository::remove(const QString& username)
+{
+    QSqlQuery query = prepare("DELETE FROM users WHERE username = ?");
+
+    query.addBindValue(username);
+    return exec(query);
+}
+
+QStringList UserRepository::roles()
+{
+    QStringList roles;
+    QSqlQuery   query = prepare("SELECT DISTINCT role FROM rolePermissions ORDER BY role");
+
+    if (!exec(query)) return roles;
+
+    while (next(query)) roles.append(query.value(0).toString());
+    return roles;
+}
+
+QStringList UserRepository::permissionsOf(const QString& role)
+{
+    QStringList permissions;
+    QSqlQuery   query = prepare("SELECT permission FROM rolePermissions WHERE role = ?");
+
+    query.addBindValue(role);
+
+    if (!exec(query)) return permissions;
+
+    while (next(query)) permissions.append(query.value(0).toString());
+    return permissions;
+}
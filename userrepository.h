@@ -0,0 +1,41 @@
+#ifndef USERREPOSITORY_H
+#define USERREPOSITORY_H
+
+#include "repository.h"
+#include <QStringList>
+#include <QVector>
+
+// users 表的一行
+struct UserRecord {
+    QString username;
+    QString passwordHash;
+    QString role;
+};
+
+class UserRepository : public Repository {
+public:
+
+    using Repository::Repository;
+
+    // 数据库升级时创建的管理员角色，拥有全部权限；初始用户和旧版本的用户属于该角色
+    static const QString adminRole;
+
+    // 表中是否至少有一个用户
+    bool                hasUsers();
+
+    // 找到用户时返回 true 并填充 user
+    bool                findByUsername(const QString& username, UserRecord& user);
+
+    // 全部用户，不读取密码哈希
+    QVector<UserRecord> loadAll();
+    bool                insert(const UserRecord& user);
+    bool                updatePassword(const QString& username, const QString& passwordHash);
+    bool                updateRole(const QString& username, const QString& role);
+    bool                remove(const QString& username);
+
+    // rolePermissions 表中定义的角色及角色拥有的权限名称
+    QStringList         roles();
+    QStringList         permissionsOf(const QString& role);
+};
+
+#endif // USERREPOSITORY_H